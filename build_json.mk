@@ -26,6 +26,10 @@ ifneq ("$(wildcard $(KEYMAP_PATH))", "")
     -include $(KEYMAP_PATH)/rules.mk
 endif
 
+ifeq ($(strip $(KEYMAP_COMPRESSION_ENABLE)), yes)
+    JSON2C_FLAGS += --compress
+endif
+
 # Generate the keymap.c
 $(KEYBOARD_OUTPUT)/src/keymap.c: $(KEYMAP_JSON)
-	bin/qmk json2c --quiet --output $(KEYMAP_C) $(KEYMAP_JSON)
+	bin/qmk json2c --quiet $(JSON2C_FLAGS) --output $(KEYMAP_C) $(KEYMAP_JSON)
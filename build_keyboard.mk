@@ -38,6 +38,11 @@ ifdef SKIP_VERSION
     OPT_DEFS += -DSKIP_VERSION
 endif
 
+# `make <keyboard>:<keymap>:sim` builds the keymap into a host simulator
+ifneq ($(filter sim,$(MAKECMDGOALS)),)
+    SIMULATOR := yes
+endif
+
 # Determine which subfolders exist.
 KEYBOARD_FOLDER_PATH_1 := $(KEYBOARD)
 KEYBOARD_FOLDER_PATH_2 := $(patsubst %/,%,$(dir $(KEYBOARD_FOLDER_PATH_1)))
@@ -131,6 +136,16 @@ ifeq ("$(wildcard $(KEYMAP_PATH))", "")
     endif
 endif
 
+# Look for a leader key dictionary next to the keymap
+ifneq ("$(wildcard $(KEYMAP_PATH)/leader.json)","")
+    LEADER_JSON := $(KEYMAP_PATH)/leader.json
+    LEADER_DICTIONARY_C := $(KEYBOARD_OUTPUT)/src/leader_dictionary.c
+
+# Generate the leader_dictionary.c
+$(KEYBOARD_OUTPUT)/src/leader_dictionary.c: $(LEADER_JSON)
+	bin/qmk leader2c --quiet --output $(LEADER_DICTIONARY_C) $(LEADER_JSON)
+endif
+
 ifeq ($(strip $(CTPC)), yes)
   CONVERT_TO_PROTON_C=yes
 endif
@@ -237,6 +252,10 @@ else
     FIRMWARE_FORMAT?=hex
 endif
 
+ifeq ($(strip $(SIMULATOR)), yes)
+    include build_sim.mk
+endif
+
 # Find all of the config.h files and add them to our CONFIG_H define.
 CONFIG_H :=
 ifneq ("$(wildcard $(KEYBOARD_PATH_5)/config.h)","")
@@ -317,7 +336,11 @@ SRC += $(TMK_COMMON_SRC)
 OPT_DEFS += $(TMK_COMMON_DEFS)
 EXTRALDFLAGS += $(TMK_COMMON_LDFLAGS)
 
-include $(TMK_PATH)/$(PLATFORM_KEY).mk
+ifeq ($(strip $(PLATFORM)), TEST)
+    include $(TMK_PATH)/native.mk
+else
+    include $(TMK_PATH)/$(PLATFORM_KEY).mk
+endif
 ifneq ($(strip $(PROTOCOL)),)
     include $(TMK_PATH)/protocol/$(strip $(shell echo $(PROTOCOL) | tr '[:upper:]' '[:lower:]')).mk
 else
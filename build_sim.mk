@@ -0,0 +1,75 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Included by build_keyboard.mk for `make <keyboard>:<keymap>:sim`.
+#
+# The keymap, its userspace and the software features it enables are built
+# for the host, on top of the test platform, with the simulator protocol in
+# tmk_core/protocol/sim standing in for USB and the matrix. Everything that
+# needs real hardware is turned off, and so are the keyboard level sources,
+# since those are mostly matrix and LED drivers.
+
+PLATFORM := TEST
+PLATFORM_KEY := test
+PROTOCOL := SIM
+TARGET := $(TARGET)_sim
+KEYBOARD_OUTPUT := $(KEYBOARD_OUTPUT)_sim
+
+# override, so the userspace rules.mk included later cannot turn them back on
+SIM_HARDWARE_FEATURES := \
+	AUDIO_ENABLE \
+	BACKLIGHT_ENABLE \
+	BLUETOOTH_ENABLE \
+	CONSOLE_ENABLE \
+	DIP_SWITCH_ENABLE \
+	ENCODER_ENABLE \
+	FAUXCLICKY_ENABLE \
+	HAPTIC_ENABLE \
+	LCD_ENABLE \
+	LED_MATRIX_ENABLE \
+	MIDI_ENABLE \
+	OLED_DRIVER_ENABLE \
+	POINTING_DEVICE_ENABLE \
+	PS2_MOUSE_ENABLE \
+	RAW_ENABLE \
+	RGB_MATRIX_ENABLE \
+	RGBLIGHT_ENABLE \
+	SERIAL_LINK_ENABLE \
+	SLEEP_LED_ENABLE \
+	SPLIT_KEYBOARD \
+	STENO_ENABLE \
+	VIRTSER_ENABLE \
+	VISUALIZER_ENABLE \
+	WS2812_DRIVER_REQUIRED
+
+$(foreach FEATURE,$(SIM_HARDWARE_FEATURES),$(eval override $(FEATURE) := no))
+
+override QWIIC_ENABLE :=
+override CUSTOM_MATRIX := yes
+override LTO_ENABLE := no
+
+# Drop the keyboard's own sources, but keep the ones the keymap added
+SIM_KEYBOARD_SRC := $(foreach PATH,$(KEYBOARD_PATHS),$(wildcard $(PATH)/*.c $(PATH)/*.cpp))
+KEYBOARD_SRC :=
+SIM_KEYMAP_SRC := $(filter-out $(SIM_KEYBOARD_SRC) $(notdir $(SIM_KEYBOARD_SRC)),$(SRC))
+# recursively expanded, later additions may refer to variables that are not set yet
+SRC = $(SIM_KEYMAP_SRC)
+QUANTUM_LIB_SRC :=
+LIB_SRC :=
+
+.PHONY: sim
+sim: elf
+	$(SILENT) || printf "Copying $(TARGET) to $(BUILD_DIR) folder" | $(AWK_CMD)
+	$(COPY) $(BUILD_DIR)/$(TARGET).elf $(BUILD_DIR)/$(TARGET) && $(PRINT_OK)
@@ -17,6 +17,7 @@ SERIAL_PATH := $(QUANTUM_PATH)/serial_link
 
 QUANTUM_SRC += \
     $(QUANTUM_DIR)/quantum.c \
+    $(QUANTUM_DIR)/deadline.c \
     $(QUANTUM_DIR)/keymap_common.c \
     $(QUANTUM_DIR)/keycode_config.c
 
@@ -28,20 +29,39 @@ ifeq ($(strip $(API_SYSEX_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/api.c
 endif
 
+VALID_AUDIO_DRIVER_TYPES := timer dac_mixer
+
+AUDIO_DRIVER ?= timer
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
+    ifeq ($(filter $(AUDIO_DRIVER),$(VALID_AUDIO_DRIVER_TYPES)),)
+        $(error AUDIO_DRIVER="$(AUDIO_DRIVER)" is not a valid audio driver)
+    endif
     OPT_DEFS += -DAUDIO_ENABLE
+    OPT_DEFS += -DAUDIO_DRIVER_$(strip $(shell echo $(AUDIO_DRIVER) | tr '[:lower:]' '[:upper:]'))
     MUSIC_ENABLE = yes
     SRC += $(QUANTUM_DIR)/process_keycode/process_audio.c
     SRC += $(QUANTUM_DIR)/process_keycode/process_clicky.c
-    SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY).c
+    ifeq ($(strip $(AUDIO_DRIVER)), dac_mixer)
+        ifneq ($(strip $(PLATFORM)), CHIBIOS)
+            $(error AUDIO_DRIVER="dac_mixer" needs a ChibiOS board with a DAC)
+        endif
+        OPT_DEFS += -DSTM32_DMA_REQUIRED=TRUE
+        SRC += $(QUANTUM_DIR)/audio/audio_dac_mixer.c
+        SRC += $(QUANTUM_DIR)/audio/audio_mixer.c
+    else
+        SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY).c
+    endif
     SRC += $(QUANTUM_DIR)/audio/voices.c
+    SRC += $(QUANTUM_DIR)/audio/wavetable.c
     SRC += $(QUANTUM_DIR)/audio/luts.c
 endif
 
 ifeq ($(strip $(MIDI_ENABLE)), yes)
     OPT_DEFS += -DMIDI_ENABLE
     MUSIC_ENABLE = yes
+    COMMON_VPATH += $(QUANTUM_DIR)/midi
     SRC += $(QUANTUM_DIR)/process_keycode/process_midi.c
+    SRC += $(QUANTUM_DIR)/midi/midi_sequencer.c
 endif
 
 MUSIC_ENABLE ?= no
@@ -346,9 +366,24 @@ ifeq ($(strip $(WPM_ENABLE)), yes)
     OPT_DEFS += -DWPM_ENABLE
 endif
 
+ifeq ($(strip $(SEND_STRING_ASYNC_ENABLE)), yes)
+    SRC += $(QUANTUM_DIR)/send_string_async.c
+    OPT_DEFS += -DSEND_STRING_ASYNC_ENABLE
+endif
+
+VALID_ENCODER_DRIVER_TYPES := poll interrupt
+ENCODER_DRIVER ?= poll
 ifeq ($(strip $(ENCODER_ENABLE)), yes)
+    ifeq ($(filter $(ENCODER_DRIVER),$(VALID_ENCODER_DRIVER_TYPES)),)
+        $(error ENCODER_DRIVER="$(ENCODER_DRIVER)" is not a valid encoder driver)
+    endif
+    COMMON_VPATH += $(QUANTUM_PATH)/encoder
     SRC += $(QUANTUM_DIR)/encoder.c
+    SRC += $(QUANTUM_DIR)/encoder/encoder_decoder.c
     OPT_DEFS += -DENCODER_ENABLE
+    ifeq ($(strip $(ENCODER_DRIVER)), interrupt)
+        OPT_DEFS += -DENCODER_INTERRUPT
+    endif
 endif
 
 ifeq ($(strip $(VELOCIKEY_ENABLE)), yes)
@@ -369,6 +404,10 @@ ifeq ($(strip $(DYNAMIC_KEYMAP_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/dynamic_keymap.c
 endif
 
+ifeq ($(strip $(KEYMAP_COMPRESSION_ENABLE)), yes)
+    OPT_DEFS += -DKEYMAP_COMPRESSION_ENABLE
+endif
+
 ifeq ($(strip $(DIP_SWITCH_ENABLE)), yes)
     OPT_DEFS += -DDIP_SWITCH_ENABLE
     SRC += $(QUANTUM_DIR)/dip_switch.c
@@ -420,7 +459,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     OPT_DEFS += -DSPLIT_KEYBOARD
 
     # Include files used by all split keyboards
-    QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_util.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_util.c \
+                   $(QUANTUM_DIR)/split_common/matrix_codec.c \
+                   $(QUANTUM_DIR)/split_common/split_events.c
 
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
@@ -435,6 +476,10 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
         SERIAL_DRIVER ?= bitbang
         ifeq ($(strip $(SERIAL_DRIVER)), bitbang)
             QUANTUM_LIB_SRC += serial.c
+        else ifeq ($(strip $(SERIAL_DRIVER)), usart_duplex)
+            OPT_DEFS += -DSERIAL_DRIVER_USART_DUPLEX
+            QUANTUM_SRC += $(QUANTUM_DIR)/split_common/serial_stream.c
+            QUANTUM_LIB_SRC += serial_usart_duplex.c
         else
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
         endif
@@ -537,6 +582,10 @@ endif
 ifeq ($(strip $(LEADER_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_leader.c
     OPT_DEFS += -DLEADER_ENABLE
+    ifneq ($(strip $(LEADER_DICTIONARY_C)),)
+        OPT_DEFS += -DLEADER_DICTIONARY_ENABLE
+        SRC += $(LEADER_DICTIONARY_C)
+    endif
 endif
 
 ifeq ($(strip $(AUTO_SHIFT_ENABLE)), yes)
@@ -0,0 +1,219 @@
+#include "quantum.h"
+#include "serial.h"
+#include "serial_stream.h"
+#include "printf.h"
+
+#include "ch.h"
+#include "hal.h"
+
+#include <string.h>
+
+#ifndef USART_CR1_M0
+#    define USART_CR1_M0 USART_CR1_M  // some platforms (f1xx) dont have this so
+#endif
+
+#ifndef USE_GPIOV1
+// The default PAL alternate modes are used to signal that the pins are used for USART
+#    ifndef SERIAL_USART_TX_PAL_MODE
+#        define SERIAL_USART_TX_PAL_MODE 7
+#    endif
+#    ifndef SERIAL_USART_RX_PAL_MODE
+#        define SERIAL_USART_RX_PAL_MODE 7
+#    endif
+#endif
+
+#ifndef SERIAL_USART_DRIVER
+#    define SERIAL_USART_DRIVER SD1
+#endif
+
+#ifndef SERIAL_USART_CR1
+#    define SERIAL_USART_CR1 (USART_CR1_PCE | USART_CR1_PS | USART_CR1_M0)  // parity enable, odd parity, 9 bit length
+#endif
+
+#ifndef SERIAL_USART_CR2
+#    define SERIAL_USART_CR2 (USART_CR2_STOP_1)  // 2 stop bits
+#endif
+
+#ifndef SERIAL_USART_CR3
+#    define SERIAL_USART_CR3 0
+#endif
+
+#if defined(SOFT_SERIAL_PIN) && !defined(SERIAL_USART_TX_PIN)
+#    define SERIAL_USART_TX_PIN SOFT_SERIAL_PIN
+#endif
+
+#ifndef SERIAL_USART_RX_PIN
+#    error SERIAL_USART_RX_PIN must be defined for the full duplex driver
+#endif
+
+#ifndef SELECT_SOFT_SERIAL_SPEED
+#    define SELECT_SOFT_SERIAL_SPEED 1
+#endif
+
+#ifdef SERIAL_USART_SPEED
+// Allow advanced users to directly set SERIAL_USART_SPEED
+#elif SELECT_SOFT_SERIAL_SPEED == 0
+#    define SERIAL_USART_SPEED 460800
+#elif SELECT_SOFT_SERIAL_SPEED == 1
+#    define SERIAL_USART_SPEED 230400
+#elif SELECT_SOFT_SERIAL_SPEED == 2
+#    define SERIAL_USART_SPEED 115200
+#elif SELECT_SOFT_SERIAL_SPEED == 3
+#    define SERIAL_USART_SPEED 57600
+#elif SELECT_SOFT_SERIAL_SPEED == 4
+#    define SERIAL_USART_SPEED 38400
+#elif SELECT_SOFT_SERIAL_SPEED == 5
+#    define SERIAL_USART_SPEED 19200
+#else
+#    error invalid SELECT_SOFT_SERIAL_SPEED value
+#endif
+
+// How long the master keeps using the last frame before reporting the slave as gone
+#ifndef SERIAL_STREAM_TIMEOUT
+#    define SERIAL_STREAM_TIMEOUT 20
+#endif
+
+// How often the slave streams its state
+#ifndef SERIAL_STREAM_PERIOD_US
+#    define SERIAL_STREAM_PERIOD_US 250
+#endif
+
+#if SERIAL_BUFFERS_SIZE < 2 * SERIAL_STREAM_FRAME_SIZE(SERIAL_STREAM_MAX_PAYLOAD)
+#    error "SERIAL_BUFFERS_SIZE in halconf.h is too small to hold two full split frames, raise it or lower SERIAL_STREAM_MAX_PAYLOAD"
+#endif
+
+static SerialConfig sdcfg = {
+    (SERIAL_USART_SPEED),  // speed - mandatory
+    (SERIAL_USART_CR1),    // CR1
+    (SERIAL_USART_CR2),    // CR2
+    (SERIAL_USART_CR3)     // CR3
+};
+
+static SSTD_t*         Transaction_table      = NULL;
+static uint8_t         Transaction_table_size = 0;
+static serial_stream_t stream;
+static bool            link_up    = false;
+static uint16_t        last_frame = 0;
+
+static uint8_t usart_read(uint8_t* data, uint8_t size) { return sdReadTimeout(&SERIAL_USART_DRIVER, data, size, TIME_IMMEDIATE); }
+
+static bool usart_write(const uint8_t* data, uint8_t size) {
+    osalSysLock();
+    bool fits = oqGetEmptyI(&(SERIAL_USART_DRIVER).oqueue) >= size;
+    osalSysUnlock();
+
+    // The output queue is drained by the USART interrupt, so this never waits
+    return fits && sdWriteTimeout(&SERIAL_USART_DRIVER, (uint8_t*)data, size, TIME_IMMEDIATE) == size;
+}
+
+__attribute__((weak)) void usart_init(void) {
+#if defined(USE_GPIOV1)
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_INPUT);
+#else
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_TX_PAL_MODE) | PAL_STM32_OTYPE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_RX_PAL_MODE) | PAL_STM32_PUPDR_PULLUP);
+#endif
+}
+
+// Latest intact slave state wins; stale frames are simply overwritten
+static void initiator_receive(serial_stream_t* stream, uint8_t id, const uint8_t* payload, uint8_t size) {
+    if (id >= Transaction_table_size) return;
+    SSTD_t* trans = &Transaction_table[id];
+
+    if (size != trans->target2initiator_buffer_size) return;
+    memcpy(trans->target2initiator_buffer, payload, size);
+    link_up    = true;
+    last_frame = timer_read();
+}
+
+static void target_receive(serial_stream_t* stream, uint8_t id, const uint8_t* payload, uint8_t size) {
+    if (id >= Transaction_table_size) return;
+    SSTD_t* trans = &Transaction_table[id];
+
+    if (size != trans->initiator2target_buffer_size) return;
+    memcpy(trans->initiator2target_buffer, payload, size);
+    if (trans->status) {
+        *trans->status = TRANSACTION_ACCEPTED;
+    }
+}
+
+/*
+ * This thread runs on the slave. It applies whatever the master sent and
+ * streams the slave side buffers back, independent of the main loop.
+ */
+static THD_WORKING_AREA(waStreamThread, 256);
+static THD_FUNCTION(StreamThread, arg) {
+    (void)arg;
+    chRegSetThreadName("slave_transport");
+
+    while (true) {
+        serial_stream_poll(&stream);
+        for (uint8_t i = 0; i < Transaction_table_size; i++) {
+            SSTD_t* trans = &Transaction_table[i];
+            if (trans->target2initiator_buffer_size) {
+                serial_stream_send(&stream, i, trans->target2initiator_buffer, trans->target2initiator_buffer_size);
+            }
+        }
+        chThdSleep(TIME_US2I(SERIAL_STREAM_PERIOD_US));
+    }
+}
+
+void soft_serial_initiator_init(SSTD_t* sstd_table, int sstd_table_size) {
+    Transaction_table      = sstd_table;
+    Transaction_table_size = (uint8_t)sstd_table_size;
+
+    usart_init();
+    sdStart(&SERIAL_USART_DRIVER, &sdcfg);
+    serial_stream_init(&stream, usart_read, usart_write, initiator_receive);
+}
+
+void soft_serial_target_init(SSTD_t* sstd_table, int sstd_table_size) {
+    Transaction_table      = sstd_table;
+    Transaction_table_size = (uint8_t)sstd_table_size;
+
+    usart_init();
+    sdStart(&SERIAL_USART_DRIVER, &sdcfg);
+    serial_stream_init(&stream, usart_read, usart_write, target_receive);
+
+    // Start transport thread
+    chThdCreateStatic(waStreamThread, sizeof(waStreamThread), HIGHPRIO, StreamThread, NULL);
+}
+
+/////////
+//  start transaction by initiator
+//
+// int  soft_serial_transaction(int sstd_index)
+//
+// Never blocks: consumes whatever the slave streamed since the last call and
+// queues the master side buffer for the slave.
+//
+// Returns:
+//    TRANSACTION_END
+//    TRANSACTION_NO_RESPONSE
+//    TRANSACTION_TYPE_ERROR
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) {
+    uint8_t sstd_index = 0;
+#else
+int soft_serial_transaction(int index) {
+    uint8_t sstd_index = index;
+#endif
+
+    if (sstd_index >= Transaction_table_size) return TRANSACTION_TYPE_ERROR;
+    SSTD_t* trans = &Transaction_table[sstd_index];
+
+    serial_stream_poll(&stream);
+
+    // A full output queue is normal when scanning faster than the link runs, this copy is
+    // skipped and a newer one goes out with a later call. Only a stale link is an error.
+    bool sent  = serial_stream_send(&stream, sstd_index, trans->initiator2target_buffer, trans->initiator2target_buffer_size);
+    bool fresh = link_up && timer_elapsed(last_frame) <= SERIAL_STREAM_TIMEOUT;
+
+    if (!fresh && (!sent || trans->target2initiator_buffer_size)) {
+        dprintf("serial::usart_stream NO_RESPONSE\n");
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    return TRANSACTION_END;
+}
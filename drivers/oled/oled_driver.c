@@ -112,6 +112,11 @@ uint32_t oled_timeout;
 #if OLED_SCROLL_TIMEOUT > 0
 uint32_t oled_scroll_timeout;
 #endif
+#ifdef OLED_DOUBLE_BUFFER
+// What the display currently shows, for blocks not marked in oled_front_stale
+static uint8_t         oled_front_buffer[OLED_MATRIX_SIZE];
+static OLED_BLOCK_TYPE oled_front_stale = -1;
+#endif
 
 // Internal variables to reduce math instructions
 
@@ -200,6 +205,9 @@ bool oled_init(uint8_t rotation) {
     oled_scroll_timeout = timer_read32() + OLED_SCROLL_TIMEOUT;
 #endif
 
+#ifdef OLED_DOUBLE_BUFFER
+    oled_front_stale = -1;
+#endif
     oled_clear();
     oled_initialized = true;
     oled_active      = true;
@@ -260,18 +268,227 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
+#ifdef OLED_RENDER_BATCH_SIZE
+_Static_assert(OLED_RENDER_BATCH_SIZE >= OLED_BLOCK_SIZE, "OLED_RENDER_BATCH_SIZE must be at least OLED_BLOCK_SIZE");
+#endif
+
+#if defined(OLED_RENDER_BATCH_SIZE) || defined(OLED_DOUBLE_BUFFER)
+static void calc_window(uint16_t start, uint8_t *cmd_array) {
+    // Calculate commands to set memory addressing bounds for a run of blocks.
+    uint8_t start_page   = start / OLED_DISPLAY_WIDTH;
+    uint8_t start_column = start % OLED_DISPLAY_WIDTH;
+#    if (OLED_IC == OLED_IC_SH1106)
+    cmd_array[0] = PAM_PAGE_ADDR | start_page;
+    cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
+    cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
+    cmd_array[3] = NOP;
+    cmd_array[4] = NOP;
+    cmd_array[5] = NOP;
+#    else
+    cmd_array[1] = start_column;
+    cmd_array[2] = OLED_DISPLAY_WIDTH - 1;
+    cmd_array[4] = start_page;
+    cmd_array[5] = OLED_DISPLAY_HEIGHT / 8 - 1;
+#    endif
+}
+
+// Writes wrap back to the window's first column at the end of a page (and
+// stay in the page on SH1106), so only a write starting at column 0 may
+// continue onto the next page. Returns the end of the longest write from start.
+static uint16_t window_end(uint16_t start) {
+#    if (OLED_IC == OLED_IC_SH1106)
+    return start - start % OLED_DISPLAY_WIDTH + OLED_DISPLAY_WIDTH;
+#    else
+    return start % OLED_DISPLAY_WIDTH ? start - start % OLED_DISPLAY_WIDTH + OLED_DISPLAY_WIDTH : OLED_MATRIX_SIZE;
+#    endif
+}
+
+static bool send_window(uint16_t start, uint16_t length) {
+    static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+
+    calc_window(start, &display_start[1]);  // Offset from I2C_CMD byte at the start
+    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
+        print("oled_render offset command failed\n");
+        return false;
+    }
+    if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[start], length) != I2C_STATUS_SUCCESS) {
+        print("oled_render data failed\n");
+        return false;
+    }
+    return true;
+}
+#endif
+
+#if defined(OLED_RENDER_BATCH_SIZE) && !defined(OLED_DOUBLE_BUFFER)
+// Sends each run of adjacent dirty blocks with a single address window and
+// data write, until OLED_RENDER_BATCH_SIZE bytes have been sent.
+// Returns false if nothing could be sent.
+static bool render_batch(void) {
+    uint16_t budget   = OLED_RENDER_BATCH_SIZE;
+    bool     rendered = false;
+
+    for (uint8_t block = 0; block < OLED_BLOCK_COUNT && budget >= OLED_BLOCK_SIZE;) {
+        if (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << block))) {
+            ++block;
+            continue;
+        }
+
+        uint16_t start = OLED_BLOCK_SIZE * block;
+        uint16_t limit = window_end(start) - start;
+        if (limit > budget) {
+            limit = budget;
+        }
+
+        uint8_t  end    = block;
+        uint16_t length = 0;
+        do {
+            length += OLED_BLOCK_SIZE;
+            ++end;
+        } while (end < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << end)) && length + OLED_BLOCK_SIZE <= limit);
+
+        if (!send_window(start, length)) {
+            return rendered;
+        }
+
+        for (; block < end; ++block) {
+            oled_dirty &= ~((OLED_BLOCK_TYPE)1 << block);
+        }
+        budget -= length;
+        rendered = true;
+    }
+
+    return rendered;
+}
+#endif
+
+#ifdef OLED_DOUBLE_BUFFER
+_Static_assert(OLED_BLOCK_SIZE % sizeof(uint32_t) == 0, "OLED_DOUBLE_BUFFER needs OLED_BLOCK_SIZE to be a multiple of 4");
+
+#    ifndef OLED_DIFF_GAP
+#        define OLED_DIFF_GAP 8
+#    endif
+#    ifdef OLED_RENDER_BATCH_SIZE
+#        define OLED_DIFF_BUDGET OLED_RENDER_BATCH_SIZE
+#    else
+#        define OLED_DIFF_BUDGET OLED_MATRIX_SIZE
+#    endif
+
+static inline uint32_t read_word(const uint8_t *data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static bool word_changed(uint16_t index) {
+    if (oled_front_stale & ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE))) {
+        return true;
+    }
+    return read_word(&oled_buffer[index]) != read_word(&oled_front_buffer[index]);
+}
+
+static void block_rendered(uint8_t block) {
+    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << block);
+    oled_front_stale &= ~((OLED_BLOCK_TYPE)1 << block);
+}
+
+// Compares the dirty blocks against the front buffer a word at a time and
+// sends only the changed spans, joining spans less than OLED_DIFF_GAP bytes
+// apart. Returns false if nothing was sent.
+static bool render_diff(void) {
+    uint16_t budget   = OLED_DIFF_BUDGET;
+    bool     rendered = false;
+
+    for (uint16_t index = 0; index < OLED_MATRIX_SIZE;) {
+        uint8_t block = index / OLED_BLOCK_SIZE;
+        if (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << block))) {
+            index = OLED_BLOCK_SIZE * (block + 1);
+            continue;
+        }
+        if (!word_changed(index)) {
+            index += sizeof(uint32_t);
+            if (index % OLED_BLOCK_SIZE == 0) {
+                block_rendered(block);
+            }
+            continue;
+        }
+        if (budget < sizeof(uint32_t)) {
+            break;
+        }
+
+        uint16_t start = index;
+        uint16_t end   = start + sizeof(uint32_t);
+        uint16_t limit = window_end(start);
+        if (limit > start + budget) {
+            limit = start + budget;
+        }
+        for (uint16_t next = end; next < limit && (oled_dirty & ((OLED_BLOCK_TYPE)1 << (next / OLED_BLOCK_SIZE))); next += sizeof(uint32_t)) {
+            if (word_changed(next)) {
+                end = next + sizeof(uint32_t);
+            } else if (next + sizeof(uint32_t) - end > OLED_DIFF_GAP) {
+                break;
+            }
+        }
+
+        if (!send_window(start, end - start)) {
+            break;
+        }
+        memcpy(&oled_front_buffer[start], &oled_buffer[start], end - start);
+        budget -= end - start;
+        rendered = true;
+
+        for (; block < end / OLED_BLOCK_SIZE; ++block) {
+            block_rendered(block);
+        }
+        index = end;
+    }
+
+    return rendered;
+}
+#endif
+
 void oled_render(void) {
     // Do we have work to do?
     if (!oled_dirty || oled_scrolling) {
         return;
     }
 
+#if defined(OLED_DOUBLE_BUFFER)
+    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        if (render_diff()) {
+            // Turn on display if it is off
+            oled_on();
+        }
+        return;
+    }
+#elif defined(OLED_RENDER_BATCH_SIZE)
+    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        if (render_batch()) {
+            // Turn on display if it is off
+            oled_on();
+        }
+        return;
+    }
+#endif
+
     // Find first dirty block
     uint8_t update_start = 0;
     while (!(oled_dirty & (1 << update_start))) {
         ++update_start;
     }
 
+#ifdef OLED_DOUBLE_BUFFER
+    // Skip blocks redrawn with what the display already shows
+    while (!(oled_front_stale & ((OLED_BLOCK_TYPE)1 << update_start)) && memcmp(&oled_buffer[OLED_BLOCK_SIZE * update_start], &oled_front_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) == 0) {
+        block_rendered(update_start);
+        if (!oled_dirty) {
+            return;
+        }
+        while (!(oled_dirty & (1 << update_start))) {
+            ++update_start;
+        }
+    }
+#endif
+
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
@@ -313,8 +530,13 @@ void oled_render(void) {
     // Turn on display if it is off
     oled_on();
 
+#ifdef OLED_DOUBLE_BUFFER
+    memcpy(&oled_front_buffer[OLED_BLOCK_SIZE * update_start], &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE);
+    block_rendered(update_start);
+#else
     // Clear dirty flag
     oled_dirty &= ~(1 << update_start);
+#endif
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -481,7 +703,99 @@ void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
     oled_dirty |= (1 << (index / OLED_BLOCK_SIZE));
 }
 
+// Replaces the pixels selected by mask in one byte of the buffer
+static void write_bits(uint16_t x, uint8_t page, uint8_t bits, uint8_t mask) {
+    if (x >= OLED_DISPLAY_WIDTH || page >= OLED_DISPLAY_HEIGHT / 8 || !mask) {
+        return;
+    }
+    uint16_t index = x + page * OLED_DISPLAY_WIDTH;
+    uint8_t  data  = (oled_buffer[index] & ~mask) | (bits & mask);
+    if (oled_buffer[index] == data) return;
+    oled_buffer[index] = data;
+    oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
+}
+
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    uint16_t right  = x + width < OLED_DISPLAY_WIDTH ? x + width : OLED_DISPLAY_WIDTH;
+    uint16_t bottom = y + height < OLED_DISPLAY_HEIGHT ? y + height : OLED_DISPLAY_HEIGHT;
+
+    for (uint16_t top = y; top < bottom; top = (top / 8 + 1) * 8) {
+        // Rows of this page inside the rectangle
+        uint8_t mask = 0xFF << (top % 8);
+        if (bottom - top < 8 - top % 8) {
+            mask &= 0xFF >> (8 - bottom % 8);
+        }
+        for (uint16_t column = x; column < right; column++) {
+            write_bits(column, top / 8, on ? 0xFF : 0, mask);
+        }
+    }
+}
+
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on) {
+    if (!width || !height) {
+        return;
+    }
+    oled_fill_rect(x, y, width, 1, on);
+    oled_fill_rect(x, y + height - 1, width, 1, on);
+    oled_fill_rect(x, y, 1, height, on);
+    oled_fill_rect(x + width - 1, y, 1, height, on);
+}
+
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on) {
+    if (x0 == x1 || y0 == y1) {
+        // Straight lines are filled a byte at a time
+        uint8_t x = x0 < x1 ? x0 : x1;
+        uint8_t y = y0 < y1 ? y0 : y1;
+        oled_fill_rect(x, y, (x0 < x1 ? x1 - x0 : x0 - x1) + 1, (y0 < y1 ? y1 - y0 : y0 - y1) + 1, on);
+        return;
+    }
+
+    // Bresenham
+    int16_t dx    = x0 < x1 ? x1 - x0 : x0 - x1;
+    int16_t dy    = y0 < y1 ? y0 - y1 : y1 - y0;
+    int8_t  sx    = x0 < x1 ? 1 : -1;
+    int8_t  sy    = y0 < y1 ? 1 : -1;
+    int16_t error = dx + dy;
+    while (true) {
+        oled_write_pixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t error2 = 2 * error;
+        if (error2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (error2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void blit(const char *data, uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool progmem) {
+    uint8_t shift = y % 8;
+
+    for (uint8_t page = 0; page * 8 < height; page++) {
+        // Source rows below height are left alone
+        uint8_t mask = height - page * 8 < 8 ? 0xFF >> (8 - (height - page * 8)) : 0xFF;
+        uint8_t top  = y / 8 + page;
+        for (uint8_t column = 0; column < width; column++) {
+            const char *source = data + page * width + column;
+            uint8_t     bits   = progmem ? pgm_read_byte(source) : *source;
+            write_bits(x + column, top, bits << shift, mask << shift);
+            if (shift) {
+                write_bits(x + column, top + 1, bits >> (8 - shift), mask >> (8 - shift));
+            }
+        }
+    }
+}
+
+void oled_blit(const char *data, uint8_t x, uint8_t y, uint8_t width, uint8_t height) { blit(data, x, y, width, height, false); }
+
 #if defined(__AVR__)
+void oled_blit_P(const char *data, uint8_t x, uint8_t y, uint8_t width, uint8_t height) { blit(data, x, y, width, height, true); }
+
 void oled_write_P(const char *data, bool invert) {
     uint8_t c = pgm_read_byte(data);
     while (c != 0) {
@@ -596,6 +910,10 @@ bool oled_scroll_off(void) {
         }
         oled_scrolling = false;
         oled_dirty     = -1;
+#ifdef OLED_DOUBLE_BUFFER
+        // Scrolling moved the display contents around
+        oled_front_stale = -1;
+#endif
     }
     return !oled_scrolling;
 }
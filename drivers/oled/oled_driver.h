@@ -223,6 +223,21 @@ void oled_write_raw_byte(const char data, uint16_t index);
 // Coordinates start at top-left and go right and down for positive x and y
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
 
+// Sets all pixels of a rectangle on or off, clipped to the display
+// Whole bytes of the buffer are written at a time
+void oled_fill_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Sets the outline of a rectangle on or off, clipped to the display
+void oled_draw_rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool on);
+
+// Sets the pixels of a line between two points on or off, including both ends
+void oled_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on);
+
+// Copies a width by height image with its top-left corner at x, y, clipped to the display
+// The image uses the buffer layout: rows of width bytes, each byte holding 8 pixels
+// from top (LSB) to bottom, for every 8 pixel rows of the image
+void oled_blit(const char *data, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+
 #if defined(__AVR__)
 // Writes a PROGMEM string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -236,6 +251,9 @@ void oled_write_P(const char *data, bool invert);
 void oled_write_ln_P(const char *data, bool invert);
 
 void oled_write_raw_P(const char *data, uint16_t size);
+
+// Copies a PROGMEM image, see oled_blit
+void oled_blit_P(const char *data, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
 #else
 // Writes a string to the buffer at current cursor position
 // Advances the cursor while writing, inverts the pixels if true
@@ -247,6 +265,8 @@ void oled_write_raw_P(const char *data, uint16_t size);
 #    define oled_write_ln_P(data, invert) oled_write(data, invert)
 
 #    define oled_write_raw_P(data, size) oled_write_raw(data, size)
+
+#    define oled_blit_P(data, x, y, width, height) oled_blit(data, x, y, width, height)
 #endif  // defined(__AVR__)
 
 // Can be used to manually turn on the screen if it is off
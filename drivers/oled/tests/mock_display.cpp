@@ -0,0 +1,46 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include "mock_display.h"
+
+MockDisplay display;
+
+extern "C" {
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (display.fail()) {
+        return I2C_STATUS_ERROR;
+    }
+    EXPECT_EQ(data[0], 0x00) << "only commands are sent with i2c_transmit";
+    display.command(data + 1, length - 1);
+    display.commands++;
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (display.fail()) {
+        return I2C_STATUS_ERROR;
+    }
+    EXPECT_EQ(regaddr, 0x40);
+    display.write(data, length);
+    display.data_writes++;
+    display.data_lengths.push_back(length);
+    return I2C_STATUS_SUCCESS;
+}
+}
@@ -0,0 +1,98 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "i2c_master.h"
+#include "oled_driver.h"
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+}
+
+#define OLED_PAGES (OLED_DISPLAY_HEIGHT / 8)
+#define BLOCK_SIZE (OLED_MATRIX_SIZE / (sizeof(OLED_BLOCK_TYPE) * 8))
+
+// Mock I2C bus emulating the SSD1306 horizontal addressing mode, so tests
+// can check both the transactions and what ends up in display memory.
+struct MockDisplay {
+    uint8_t ram[OLED_MATRIX_SIZE];
+    uint8_t column_start, column_end, page_start, page_end;
+    uint8_t column, page;
+
+    unsigned             commands;
+    unsigned             data_writes;
+    std::vector<uint16_t> data_lengths;
+    int                  fail_after;  // fail the transaction after this many more, -1 never
+
+    void reset() {
+        std::memset(ram, 0, sizeof(ram));
+        column_start = column = 0;
+        column_end            = OLED_DISPLAY_WIDTH - 1;
+        page_start = page = 0;
+        page_end          = OLED_PAGES - 1;
+        fail_after        = -1;
+        clear_counts();
+    }
+    void clear_counts() {
+        commands    = 0;
+        data_writes = 0;
+        data_lengths.clear();
+    }
+    bool fail() { return fail_after >= 0 && fail_after-- == 0; }
+
+    void command(const uint8_t* data, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            switch (data[i]) {
+                case 0x21:  // COLUMN_ADDR
+                    column_start = column = data[++i];
+                    column_end            = data[++i];
+                    break;
+                case 0x22:  // PAGE_ADDR
+                    page_start = page = data[++i];
+                    page_end          = data[++i];
+                    break;
+                case 0x20:
+                case 0x81:
+                case 0x8D:
+                case 0xA8:
+                case 0xD3:
+                case 0xD5:
+                case 0xD9:
+                case 0xDA:
+                case 0xDB:
+                    i++;  // single argument commands
+                    break;
+            }
+        }
+    }
+    void write(const uint8_t* data, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            ram[page * OLED_DISPLAY_WIDTH + column] = data[i];
+            if (column++ == column_end) {
+                column = column_start;
+                page   = page == page_end ? page_start : page + 1;
+            }
+        }
+    }
+};
+
+extern MockDisplay display;
@@ -0,0 +1,174 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <functional>
+#include <random>
+#include "mock_display.h"
+
+class OledDoubleBuffer : public testing::Test {
+   public:
+    OledDoubleBuffer() {
+        display.reset();
+        oled_init(OLED_ROTATION_0);
+        oled_render();
+        display.clear_counts();
+    }
+
+    void expect_display_matches() { EXPECT_EQ(0, std::memcmp(display.ram, oled_buffer, OLED_MATRIX_SIZE)); }
+};
+
+TEST_F(OledDoubleBuffer, FirstRenderSendsTheWholeScreen) {
+    display.reset();
+    std::memset(display.ram, 0xAA, sizeof(display.ram));
+    oled_init(OLED_ROTATION_0);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>{OLED_MATRIX_SIZE});
+    expect_display_matches();
+}
+
+TEST_F(OledDoubleBuffer, RedrawingTheSameFrameSendsNothing) {
+    oled_write("Layer: Base", false);
+    oled_render();
+    display.clear_counts();
+
+    oled_clear();
+    oled_write("Layer: Base", false);
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    EXPECT_EQ(display.commands, 0);
+    EXPECT_EQ(display.data_writes, 0);
+}
+
+TEST_F(OledDoubleBuffer, ChangesAreSentAtWordGranularity) {
+    oled_write_pixel(37, 9, true);
+
+    oled_render();
+    EXPECT_EQ(display.commands, 1);
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>{4});
+    expect_display_matches();
+}
+
+TEST_F(OledDoubleBuffer, NearbyChangesShareAWindow) {
+    oled_write_pixel(0, 0, true);
+    oled_write_pixel(10, 0, true);
+    oled_write_pixel(100, 0, true);
+
+    oled_render();
+    EXPECT_EQ(display.commands, 2);
+    EXPECT_EQ(display.data_lengths, (std::vector<uint16_t>{12, 4}));
+    expect_display_matches();
+}
+
+TEST_F(OledDoubleBuffer, SpansCrossBlocksButNotMidPageBoundaries) {
+    // Column 124 to column 3 of the next page
+    oled_fill_rect(124, 0, 4, 1, true);
+    oled_fill_rect(0, 8, 4, 1, true);
+
+    oled_render();
+    EXPECT_EQ(display.data_lengths, (std::vector<uint16_t>{4, 4}));
+    expect_display_matches();
+
+    display.clear_counts();
+    oled_fill_rect(0, 8, 128, 16, true);
+    oled_render();
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>{256});
+    expect_display_matches();
+}
+
+TEST_F(OledDoubleBuffer, ScrollingInvalidatesTheFrontBuffer) {
+    oled_write("scroll", false);
+    oled_render();
+    oled_scroll_left();
+    oled_scroll_off();
+    display.clear_counts();
+
+    oled_render();
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>{OLED_MATRIX_SIZE});
+}
+
+TEST_F(OledDoubleBuffer, RandomFramesEndUpOnTheDisplay) {
+    std::mt19937 rng(35);
+    for (int frame = 0; frame < 200; frame++) {
+        oled_clear();
+        for (int i = 0; i < 6; i++) {
+            oled_fill_rect(rng() % OLED_DISPLAY_WIDTH, rng() % OLED_DISPLAY_HEIGHT, rng() % 40, rng() % 20, rng() % 2);
+            oled_write_pixel(rng() % OLED_DISPLAY_WIDTH, rng() % OLED_DISPLAY_HEIGHT, true);
+        }
+        oled_render();
+        ASSERT_EQ(oled_dirty, 0);
+        expect_display_matches();
+    }
+}
+
+class OledPrimitives : public OledDoubleBuffer {
+   public:
+    bool pixel(uint8_t x, uint8_t y) { return oled_buffer[x + y / 8 * OLED_DISPLAY_WIDTH] & (1 << (y % 8)); }
+
+    void expect_only(std::function<bool(uint8_t, uint8_t)> on) {
+        for (uint8_t y = 0; y < OLED_DISPLAY_HEIGHT; y++) {
+            for (uint8_t x = 0; x < OLED_DISPLAY_WIDTH; x++) {
+                ASSERT_EQ(pixel(x, y), on(x, y)) << "at " << (int)x << "," << (int)y;
+            }
+        }
+    }
+};
+
+TEST_F(OledPrimitives, FillRectMatchesPixels) {
+    for (uint8_t y = 0; y < 12; y++) {
+        for (uint8_t h = 0; h < 22; h++) {
+            oled_clear();
+            oled_fill_rect(5, y, 3, h, true);
+            expect_only([&](uint8_t px, uint8_t py) { return px >= 5 && px < 8 && py >= y && py < y + h; });
+        }
+    }
+}
+
+TEST_F(OledPrimitives, FillRectClearsAndClips) {
+    oled_fill_rect(0, 0, 255, 255, true);
+    oled_fill_rect(120, 30, 20, 20, false);
+    expect_only([](uint8_t x, uint8_t y) { return !(x >= 120 && y >= 30); });
+}
+
+TEST_F(OledPrimitives, DrawRect) {
+    oled_draw_rect(2, 3, 10, 6, true);
+    expect_only([](uint8_t x, uint8_t y) { return ((x == 2 || x == 11) && y >= 3 && y <= 8) || ((y == 3 || y == 8) && x >= 2 && x <= 11); });
+}
+
+TEST_F(OledPrimitives, DrawLine) {
+    oled_draw_line(40, 20, 10, 20, true);
+    oled_draw_line(50, 31, 50, 0, true);
+    oled_draw_line(60, 0, 67, 7, true);
+    expect_only([](uint8_t x, uint8_t y) { return (y == 20 && x >= 10 && x <= 40) || x == 50 || (x >= 60 && x <= 67 && y == x - 60); });
+}
+
+TEST_F(OledPrimitives, BlitAtAnyRow) {
+    // A 3x10 image: columns of all, none and alternate pixels
+    const char image[] = {(char)0xFF, 0x00, 0x55, 0x03, 0x00, 0x01};
+    for (uint8_t y = 0; y < 16; y++) {
+        oled_clear();
+        oled_fill_rect(0, 0, OLED_DISPLAY_WIDTH, OLED_DISPLAY_HEIGHT, true);
+        oled_blit(image, 126, y, 3, 10);
+        expect_only([&](uint8_t x, uint8_t py) {
+            if (x < 126 || py < y || py >= y + 10) return true;
+            uint8_t row = py - y;
+            return (bool)(image[row / 8 * 3 + x - 126] & (1 << (row % 8)));
+        });
+    }
+}
@@ -0,0 +1,131 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+#include "mock_display.h"
+
+class OledRenderBatch : public testing::Test {
+   public:
+    OledRenderBatch() {
+        display.reset();
+        oled_init(OLED_ROTATION_0);
+        render_all();
+        display.clear_counts();
+    }
+
+    int render_all() {
+        int calls = 0;
+        while (oled_dirty && calls < 100) {
+            oled_render();
+            calls++;
+        }
+        return calls;
+    }
+
+    void draw_block(uint8_t block, uint8_t value) {
+        for (uint16_t i = 0; i < BLOCK_SIZE; i++) {
+            oled_write_raw_byte(value, block * BLOCK_SIZE + i);
+        }
+    }
+
+    void expect_display_matches() { EXPECT_EQ(0, std::memcmp(display.ram, oled_buffer, OLED_MATRIX_SIZE)); }
+};
+
+TEST_F(OledRenderBatch, FullScreenIsSentInBudgetSizedWrites) {
+    for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+        oled_write_raw_byte(i * 7, i);
+    }
+
+    EXPECT_EQ(render_all(), OLED_MATRIX_SIZE / OLED_RENDER_BATCH_SIZE);
+    EXPECT_EQ(display.commands, OLED_MATRIX_SIZE / OLED_RENDER_BATCH_SIZE);
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>(OLED_MATRIX_SIZE / OLED_RENDER_BATCH_SIZE, OLED_RENDER_BATCH_SIZE));
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, AdjacentBlocksShareOneWindow) {
+    draw_block(2, 0x11);
+    draw_block(3, 0x22);
+    draw_block(4, 0x33);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    EXPECT_EQ(display.commands, 1);
+    EXPECT_EQ(display.data_lengths, std::vector<uint16_t>{3 * BLOCK_SIZE});
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, RunStartingMidPageIsSplitAtThePageEnd) {
+    // Block 1 is the second half of page 0, the window would wrap back to its column
+    draw_block(1, 0x5A);
+    draw_block(2, 0xA5);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    EXPECT_EQ(display.commands, 2);
+    EXPECT_EQ(display.data_lengths, (std::vector<uint16_t>{BLOCK_SIZE, BLOCK_SIZE}));
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, SeparateRunsAreSentInOneCall) {
+    draw_block(0, 0x01);
+    draw_block(6, 0x02);
+    draw_block(7, 0x03);
+    draw_block(12, 0x04);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    EXPECT_EQ(display.commands, 3);
+    EXPECT_EQ(display.data_lengths, (std::vector<uint16_t>{BLOCK_SIZE, 2 * BLOCK_SIZE, BLOCK_SIZE}));
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, BudgetBoundsEachCall) {
+    for (uint8_t block = 0; block < 8; block += 2) {
+        draw_block(block, block + 1);
+    }
+    draw_block(10, 0x77);
+
+    oled_render();
+    EXPECT_EQ(display.data_writes, OLED_RENDER_BATCH_SIZE / BLOCK_SIZE);
+    EXPECT_EQ(oled_dirty, 1 << 10);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, FailedTransferIsRetried) {
+    draw_block(0, 0x0F);
+    draw_block(8, 0xF0);
+
+    // The second run's data write fails
+    display.fail_after = 3;
+    oled_render();
+    EXPECT_EQ(oled_dirty, 1 << 8);
+
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    expect_display_matches();
+}
+
+TEST_F(OledRenderBatch, NothingIsSentWhenClean) {
+    oled_render();
+    EXPECT_EQ(display.commands, 0);
+    EXPECT_EQ(display.data_writes, 0);
+}
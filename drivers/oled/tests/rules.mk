@@ -0,0 +1,28 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+oled_render_batch_DEFS := -DOLED_DISPLAY_128X64 -DOLED_RENDER_BATCH_SIZE=256 -DOLED_DISABLE_TIMEOUT -DNO_PRINT
+oled_render_batch_INC := $(DRIVER_PATH)/oled/tests $(DRIVER_PATH)/oled
+oled_render_batch_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_render_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/mock_display.cpp \
+	$(DRIVER_PATH)/oled/oled_driver.c
+
+oled_double_buffer_DEFS := -DOLED_DOUBLE_BUFFER -DOLED_DISABLE_TIMEOUT -DNO_PRINT
+oled_double_buffer_INC := $(DRIVER_PATH)/oled/tests $(DRIVER_PATH)/oled
+oled_double_buffer_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_double_buffer_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/mock_display.cpp \
+	$(DRIVER_PATH)/oled/oled_driver.c
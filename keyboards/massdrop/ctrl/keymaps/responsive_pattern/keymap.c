@@ -646,10 +646,10 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 #ifdef CONSOLE_ENABLE
                 led_info_t *entry = get_led_info_by_scancode(keycode);
                 uprintf(("KL: kc: %u, led id: %u, x: %f, y: %f, "
-                        "col: %u, row: %u, pressed: %u, time: %u\n"),
+                        "col: %u, row: %u, pressed: %u, time: %lu\n"),
                         keycode, entry->id, entry->x, entry->y,
                         record->event.key.col, record->event.key.row,
-                        record->event.pressed, record->event.time);
+                        record->event.pressed, (unsigned long)record->event.time);
 #endif
             }
             return true; //Process all other keycodes normally
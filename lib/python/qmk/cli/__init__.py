@@ -18,6 +18,8 @@ from . import json
 from . import json2c
 from . import list
 from . import kle2json
+from . import leader2c
+from . import log_decode
 from . import new
 from . import pyformat
 from . import pytest
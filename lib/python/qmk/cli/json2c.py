@@ -9,6 +9,7 @@ import qmk.path
 
 
 @cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('-c', '--compress', arg_only=True, action='store_true', help="Generate a compressed keymap (requires KEYMAP_COMPRESSION_ENABLE)")
 @cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
 @cli.argument('filename', type=qmk.path.normpath, arg_only=True, help='Configurator JSON file')
 @cli.subcommand('Creates a keymap.c from a QMK Configurator export.')
@@ -38,7 +39,10 @@ def json2c(cli):
         user_keymap = json.load(fd)
 
     # Generate the keymap
-    keymap_c = qmk.keymap.generate(user_keymap['keyboard'], user_keymap['layout'], user_keymap['layers'])
+    if cli.args.compress:
+        keymap_c = qmk.keymap.generate_compressed(user_keymap['keyboard'], user_keymap['layout'], user_keymap['layers'])
+    else:
+        keymap_c = qmk.keymap.generate(user_keymap['keyboard'], user_keymap['layout'], user_keymap['layers'])
 
     if cli.args.output:
         cli.args.output.parent.mkdir(parents=True, exist_ok=True)
@@ -0,0 +1,48 @@
+"""Generate a leader_dictionary.c from a leader.json file.
+"""
+import json
+
+from milc import cli
+
+import qmk.leader
+import qmk.path
+
+
+@cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
+@cli.argument('filename', type=qmk.path.normpath, arg_only=True, help='leader.json file')
+@cli.subcommand('Creates a leader_dictionary.c from a leader.json file.')
+def leader2c(cli):
+    """Generate a leader_dictionary.c from a leader.json file.
+
+    This command uses the `qmk.leader` module to compile the leader sequences into a trie. The generated file is written to stdout, or to a file if -o is provided.
+    """
+    if not cli.args.filename.exists():
+        cli.log.error('JSON file does not exist!')
+        cli.print_usage()
+        exit(1)
+
+    # Environment processing
+    if cli.args.output and cli.args.output.name == '-':
+        cli.args.output = None
+
+    # Parse the leader json
+    with cli.args.filename.open('r') as fd:
+        leader_json = json.load(fd)
+
+    # Generate the dictionary
+    try:
+        leader_c = qmk.leader.generate(leader_json.get('sequences', []))
+    except ValueError as e:
+        cli.log.error(e)
+        exit(1)
+
+    if cli.args.output:
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        cli.args.output.write_text(leader_c)
+
+        if not cli.args.quiet:
+            cli.log.info('Wrote leader dictionary to %s.', cli.args.output)
+
+    else:
+        print(leader_c)
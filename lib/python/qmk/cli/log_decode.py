@@ -0,0 +1,44 @@
+"""Decode the binary console log.
+"""
+import sys
+
+from milc import cli
+
+import qmk.debug_log
+import qmk.path
+
+
+@cli.argument('-e', '--elf', arg_only=True, required=True, type=qmk.path.normpath, help='The firmware ELF file the keyboard is running')
+@cli.argument('input', arg_only=True, nargs='?', type=qmk.path.normpath, help='A hidraw device, or a file with the captured console output. Reads stdin by default')
+@cli.subcommand('Decodes the console output of a keyboard built with CONSOLE_LOG = binary.')
+def log_decode(cli):
+    """Decode the binary console log.
+
+    This command uses the `qmk.debug_log` module to look the format strings up in the ELF file and format the messages, which are printed as they arrive.
+    """
+    if not cli.args.elf.exists():
+        cli.log.error('ELF file does not exist!')
+        cli.print_usage()
+        exit(1)
+
+    try:
+        strings = qmk.debug_log.ElfStrings(cli.args.elf.read_bytes())
+    except ValueError as e:
+        cli.log.error('Could not read %s: %s', cli.args.elf, e)
+        exit(1)
+
+    decoder = qmk.debug_log.Decoder(strings)
+    source = cli.args.input.open('rb', buffering=0) if cli.args.input else sys.stdin.buffer
+    read = getattr(source, 'read1', source.read)
+
+    try:
+        with source:
+            # A hidraw device returns one report per read
+            data = read(64)
+            while data:
+                for message in decoder.feed(data):
+                    print(message, end='', flush=True)
+                data = read(64)
+
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,198 @@
+"""Functions that help you decode the binary console log.
+
+With `CONSOLE_LOG = binary` the keyboard doesn't format its messages. Each record holds the address of the format string and the raw arguments, and the format strings are looked up in the firmware's ELF file. The record layout is described in `tmk_core/common/debug_log.h`.
+"""
+import re
+import struct
+
+# Record kinds, the top two bits of the header byte
+FORMAT = 0x00
+LITERAL = 0x40
+TEXT = 0x80
+KIND_MASK = 0xC0
+
+# Argument tag for strings, the low bits are the number of characters sent
+STRING = 0x80
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+EM_AVR = 83
+
+# AVR RAM is mapped here in the ELF file, format strings are always in flash
+AVR_DATA_OFFSET = 0x800000
+
+CONVERSION_RE = re.compile(r'%([-+ #0]*)(\d+)?(?:\.(\d+))?(?:hh|h|ll|l|z|j|t)?([diuxXobcsSpfFeEgG%])')
+
+
+class ElfStrings:
+    """The strings a firmware ELF file holds, by address.
+    """
+    def __init__(self, data):
+        if data[:4] != b'\x7fELF':
+            raise ValueError('Not an ELF file.')
+
+        wide = data[4] == 2
+        order = '<' if data[5] == 1 else '>'
+        header = struct.unpack_from(order + ('HHIQQQIHHHHHH' if wide else 'HHIIIIIHHHHHH'), data, 16)
+        machine, section_offset, section_size, section_count = header[1], header[5], header[10], header[11]
+
+        if machine == EM_AVR:
+            self.pointer_size = 2
+        else:
+            self.pointer_size = 8 if wide else 4
+
+        self.sections = []
+        for index in range(section_count):
+            fields = struct.unpack_from(order + ('IIQQQQIIQQ' if wide else 'IIIIIIIIII'), data, section_offset + index * section_size)
+            kind, flags, address, offset, size = fields[1:6]
+
+            if kind != SHT_PROGBITS or not flags & SHF_ALLOC:
+                continue
+            if machine == EM_AVR and address >= AVR_DATA_OFFSET:
+                continue
+
+            self.sections.append((address, data[offset:offset + size]))
+
+    def string_at(self, address):
+        """Returns the NUL terminated string at `address`, or None when no section holds it.
+        """
+        for start, contents in self.sections:
+            if start <= address < start + len(contents):
+                end = contents.find(b'\0', address - start)
+                return contents[address - start:end if end >= 0 else len(contents)].decode('utf-8', errors='replace')
+
+        return None
+
+
+def _parse_arguments(data, pointer_size):
+    """Returns the arguments of a format record, ints as raw bytes and strings as an (address, text) pair.
+    """
+    arguments = []
+    index = 0
+
+    while index < len(data):
+        tag = data[index]
+        index += 1
+
+        if tag & STRING:
+            length = tag & ~STRING
+            address = int.from_bytes(data[index:index + pointer_size], 'little')
+            text = data[index + pointer_size:index + pointer_size + length].decode('utf-8', errors='replace')
+            arguments.append((address, text))
+            index += pointer_size + length
+        else:
+            arguments.append(bytes(data[index:index + tag]))
+            index += tag
+
+    return arguments
+
+
+def format_message(fmt, arguments, strings=None):
+    """Formats a message the way the firmware's printf would have.
+
+    Arguments that weren't sent, because they didn't fit in the record, are shown as `?`.
+
+    Args:
+        fmt
+            The printf style format string.
+
+        arguments
+            The arguments from the record, ints as little endian bytes and strings as an (address, text) pair.
+
+        strings
+            An ElfStrings, to look up `%S` arguments, which are in flash on AVR.
+    """
+    arguments = list(arguments)
+
+    def convert(match):
+        flags, width, precision, conversion = match.groups()
+
+        if conversion == '%':
+            return '%'
+        if not arguments:
+            return '?'
+
+        argument = arguments.pop(0)
+        spec = '%' + flags + (width or '') + ('.' + precision if precision else '')
+
+        if isinstance(argument, tuple):
+            address, text = argument
+            if conversion == 'S' and strings:
+                text = strings.string_at(address) or text
+            return (spec + 's') % text
+
+        if conversion in 'fFeEgG' and len(argument) in (4, 8):
+            return (spec + conversion) % struct.unpack('<f' if len(argument) == 4 else '<d', argument)[0]
+
+        value = int.from_bytes(argument, 'little', signed=conversion in 'di')
+
+        if conversion == 'b':
+            digits = format(value, 'b')
+            pad = '0' if '0' in flags else ' '
+            return digits.ljust(int(width or 0)) if '-' in flags else digits.rjust(int(width or 0), pad)
+        if conversion == 'c':
+            return (spec + 'c') % (value & 0xFF)
+        if conversion == 'p':
+            return '0x%x' % value
+        if conversion in 'sS':
+            return '?'
+
+        return (spec + ('d' if conversion == 'u' else conversion)) % value
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+class Decoder:
+    """Turns the bytes read from the console endpoint back into messages.
+
+    Records can be split across reports, so whatever is left over is kept for the next call to `feed()`.
+    """
+    def __init__(self, strings):
+        self.strings = strings
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        """Adds `data` to the stream and returns the messages it completed.
+        """
+        self.buffer += data
+        messages = []
+
+        while self.buffer:
+            header = self.buffer[0]
+            if not header:
+                # Padding at the end of a report
+                del self.buffer[0]
+                continue
+
+            length = header & ~KIND_MASK
+            if len(self.buffer) < 1 + length:
+                break
+
+            body = bytes(self.buffer[1:1 + length])
+            del self.buffer[:1 + length]
+            messages.append(self.decode(header & KIND_MASK, body))
+
+        return messages
+
+    def decode(self, kind, body):
+        """Returns the message a single record holds.
+        """
+        if kind == TEXT:
+            return body.decode('utf-8', errors='replace')
+
+        pointer_size = self.strings.pointer_size
+        address = int.from_bytes(body[:pointer_size], 'little')
+        arguments = _parse_arguments(body[pointer_size:], pointer_size)
+
+        if not address:
+            count = int.from_bytes(arguments[0], 'little') if arguments else 0
+            return '[%d messages dropped]\n' % count
+
+        fmt = self.strings.string_at(address)
+        if fmt is None:
+            return '[unknown message at 0x%x, is this the right ELF file?]\n' % address
+
+        if kind == LITERAL:
+            return fmt
+
+        return format_message(fmt, arguments, self.strings)
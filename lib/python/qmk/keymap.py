@@ -5,6 +5,7 @@ from pathlib import Path
 from milc import cli
 
 from qmk.keyboard import rules_mk
+import qmk.info
 import qmk.path
 
 # The `keymap.c` template to use when a keyboard doesn't have its own
@@ -21,6 +22,21 @@ __KEYMAP_GOES_HERE__
 };
 """
 
+# The `keymap.c` template to use for compressed keymaps
+DEFAULT_COMPRESSED_KEYMAP_C = """#include QMK_KEYBOARD_H
+
+/* THIS FILE WAS GENERATED!
+ *
+ * This file was generated by qmk json2c --compress. You may or may not want to
+ * edit it directly.
+ */
+
+__KEYMAP_GOES_HERE__
+"""
+
+# Keycodes that fall through to the next active layer and can be left out of a compressed keymap
+TRANSPARENT_KEYCODES = ('KC_TRNS', 'KC_TRANSPARENT', '_______')
+
 
 def template(keyboard):
     """Returns the `keymap.c` template for a keyboard.
@@ -86,6 +102,119 @@ def generate(keyboard, layout, layers):
     return keymap_c.replace('__KEYMAP_GOES_HERE__', keymap)
 
 
+def compress(matrix_rows, matrix_cols, layers):
+    """Returns the C tables for a compressed keymap.
+
+    Each layer is stored as a bitmap of the keys that are not transparent, plus the index of the first stored keycode of every row. Only the keycodes of keys in the bitmap are stored.
+
+    Args:
+        matrix_rows
+            The number of rows in the keyboard matrix.
+
+        matrix_cols
+            The number of columns in the keyboard matrix.
+
+        layers
+            An array of layers. Each layer is an array of matrix rows, and each row is an array of keycodes. Matrix positions without a key should be `None`.
+    """
+    keycodes_txt = []
+    layers_txt = []
+    hex_width = 2 * ((matrix_cols + 7) // 8 if matrix_cols <= 16 else 4)
+    index = 0
+
+    for layer_num, layer in enumerate(layers):
+        presence = []
+        offset = []
+        keycodes = []
+
+        for row in range(matrix_rows):
+            row_bits = 0
+            offset.append(str(index))
+
+            for col in range(matrix_cols):
+                keycode = layer[row][col]
+
+                # The base layer keeps empty matrix positions as KC_NO, so they are not seen as real keys
+                if keycode is None:
+                    keycode = 'KC_NO' if layer_num == 0 else 'KC_TRNS'
+
+                if keycode in TRANSPARENT_KEYCODES:
+                    continue
+
+                row_bits |= 1 << col
+                keycodes.append(keycode)
+                index += 1
+
+            presence.append('0x%0*x' % (hex_width, row_bits))
+
+        keycodes_txt.append('\t// Layer %s' % layer_num)
+        if keycodes:
+            keycodes_txt.append('\t%s,' % ', '.join(keycodes))
+
+        layers_txt.append('\t[%s] = {\n\t\t.presence = {%s},\n\t\t.offset   = {%s},\n\t},' % (layer_num, ', '.join(presence), ', '.join(offset)))
+
+    if not index:
+        # Avoid a zero length array when every layer is transparent
+        keycodes_txt.append('\tKC_TRNS,')
+
+    return '\n'.join((
+        'const uint16_t PROGMEM keymap_compressed_keycodes[] = {',
+        '\n'.join(keycodes_txt),
+        '};',
+        '',
+        'const keymap_compressed_layer_t PROGMEM keymap_compressed_layers[] = {',
+        '\n'.join(layers_txt),
+        '};',
+        '',
+        'const uint8_t keymap_compressed_layer_count = sizeof(keymap_compressed_layers) / sizeof(keymap_compressed_layers[0]);',
+    ))
+
+
+def generate_compressed(keyboard, layout, layers):
+    """Returns a compressed keymap.c for the specified keyboard, layout, and layers.
+
+    The matrix position of every key is looked up in the keyboard's LAYOUT macro, so the resulting tables can be used without the LAYOUT macro.
+
+    Args:
+        keyboard
+            The name of the keyboard
+
+        layout
+            The LAYOUT macro this keymap uses.
+
+        layers
+            An array of arrays describing the keymap. Each item in the inner array should be a string that is a valid QMK keycode.
+    """
+    info_data = qmk.info.info_json(keyboard)
+    matrix_rows = info_data['matrix_size']['rows']
+    matrix_cols = info_data['matrix_size']['cols']
+
+    if layout not in info_data['layouts']:
+        raise KeyError('Invalid layout for %s: %s' % (keyboard, layout))
+
+    layout_keys = info_data['layouts'][layout]['layout']
+    matrix_layers = []
+
+    for layer_num, layer in enumerate(layers):
+        if len(layer) != len(layout_keys):
+            raise ValueError('Layer %s has %s keys, but %s has %s.' % (layer_num, len(layer), layout, len(layout_keys)))
+
+        matrix_layer = [[None] * matrix_cols for row in range(matrix_rows)]
+
+        for key, keycode in zip(layout_keys, layer):
+            if not key.get('matrix'):
+                raise ValueError('%s: Could not find the matrix position of %s in %s.' % (keyboard, key['label'], layout))
+
+            row, col = key['matrix']
+            matrix_layer[row][col] = _strip_any(keycode)
+
+        matrix_layers.append(matrix_layer)
+
+    keymap = compress(matrix_rows, matrix_cols, matrix_layers)
+
+    return DEFAULT_COMPRESSED_KEYMAP_C.replace('__KEYMAP_GOES_HERE__', keymap)
+
+
 def write(keyboard, keymap, layout, layers):
     """Generate the `keymap.c` and write it to disk.
 
@@ -0,0 +1,150 @@
+"""Functions that help you work with leader key dictionaries.
+"""
+import string
+
+# The `leader_dictionary.c` template
+DEFAULT_LEADER_C = """#include QMK_KEYBOARD_H
+
+/* THIS FILE WAS GENERATED!
+ *
+ * This file was generated by qmk leader2c. You may or may not want to
+ * edit it directly.
+ */
+
+__LEADER_GOES_HERE__
+"""
+
+
+def _build_trie(sequences):
+    """Returns the root of a trie built from a list of sequences.
+
+    Every node is a dict with a `children` dict keyed by keycode and the index of the `action` that ends at this node, or None.
+    """
+    root = {'children': {}, 'action': None}
+
+    for action, sequence in enumerate(sequences):
+        if not sequence['keys']:
+            raise ValueError('Leader sequence %s has no keys.' % action)
+
+        node = root
+        for keycode in sequence['keys']:
+            node = node['children'].setdefault(keycode, {'children': {}, 'action': None})
+
+        if node['action'] is not None:
+            raise ValueError('Leader sequence %s is defined twice.' % ', '.join(sequence['keys']))
+
+        node['action'] = action
+
+    return root
+
+
+def trie(sequences):
+    """Returns the flattened trie for a list of sequences, as a list of C expressions.
+
+    Every node is stored as its child count, its action index plus one (0 when no sequence ends at the node) and then a keycode and node index pair for each child. Children are sorted by keycode name so the order is stable, the firmware scans them in order.
+
+    Args:
+        sequences
+            A list of dicts, each with a `keys` list of keycodes.
+    """
+    nodes = []
+
+    def flatten(node):
+        index = len(nodes)
+        nodes.append(None)
+        children = []
+
+        for keycode in sorted(node['children']):
+            children.append((keycode, flatten(node['children'][keycode])))
+
+        action = 0 if node['action'] is None else node['action'] + 1
+        nodes[index] = (len(children), action, children)
+
+        return index
+
+    flatten(_build_trie(sequences))
+
+    # Convert node numbers into word offsets
+    offsets = []
+    offset = 0
+    for child_count, action, children in nodes:
+        offsets.append(offset)
+        offset += 2 + 2 * child_count
+
+    words = []
+    for child_count, action, children in nodes:
+        node_words = [str(child_count), str(action)]
+        for keycode, child in children:
+            node_words.extend((keycode, str(offsets[child])))
+        words.append(node_words)
+
+    return words
+
+
+def _c_string(text):
+    """Returns `text` as a C string literal.
+
+    Control characters become `\\xNN` escapes. A hex escape swallows every hex digit after it, so the literal is split when one follows.
+    """
+    escapes = {'\\': '\\\\', '"': '\\"', '\n': '\\n', '\t': '\\t', '\r': '\\r'}
+    literal = ''
+    after_hex = False
+
+    for char in text:
+        if char in escapes:
+            literal += escapes[char]
+            after_hex = False
+        elif ord(char) < 0x20 or ord(char) == 0x7f:
+            literal += '\\x%02x' % ord(char)
+            after_hex = True
+        else:
+            if after_hex and char in string.hexdigits:
+                literal += '" "'
+            literal += char
+            after_hex = False
+
+    return '"%s"' % literal
+
+
+def _action_function(number, sequence):
+    """Returns the C function name and an optional definition for a sequence's action.
+    """
+    if 'function' in sequence:
+        return sequence['function'], 'void %s(void);' % sequence['function']
+
+    if 'send_string' in sequence:
+        name = 'leader_send_string_%s' % number
+        return name, 'static void %s(void) { SEND_STRING(%s); }' % (name, _c_string(sequence['send_string']))
+
+    raise ValueError('Leader sequence %s needs a function or send_string.' % ', '.join(sequence['keys']))
+
+
+def generate(sequences):
+    """Returns a leader_dictionary.c for the specified sequences.
+
+    Args:
+        sequences
+            A list of dicts, each with a `keys` list of keycodes and either the name of a `function` to call or a `send_string` to type.
+    """
+    if not sequences:
+        raise ValueError('There are no leader sequences.')
+
+    functions = [_action_function(number, sequence) for number, sequence in enumerate(sequences)]
+    declarations = sorted(set(declaration for name, declaration in functions))
+
+    trie_txt = ['\t%s,' % ', '.join(node_words) for node_words in trie(sequences)]
+    actions_txt = ['\t%s,' % name for name, declaration in functions]
+
+    leader_c = '\n'.join((
+        '\n'.join(declarations),
+        '',
+        'const uint16_t PROGMEM leader_dictionary_trie[] = {',
+        '\n'.join(trie_txt),
+        '};',
+        '',
+        'const leader_action_t PROGMEM leader_dictionary_actions[] = {',
+        '\n'.join(actions_txt),
+        '};',
+    ))
+
+    return DEFAULT_LEADER_C.replace('__LEADER_GOES_HERE__', leader_c)
@@ -0,0 +1,74 @@
+import struct
+
+import qmk.debug_log
+
+EM_ARM = 40
+
+
+def _elf(sections, machine=EM_ARM):
+    """Returns a minimal 32 bit little endian ELF file with an allocated section for each (address, contents) pair.
+    """
+    names = b'\0.rodata\0.shstrtab\0'
+    data = b''
+    headers = [struct.pack('<IIIIIIIIII', *[0] * 10)]
+
+    for address, contents in sections:
+        headers.append(struct.pack('<IIIIIIIIII', 1, 1, 0x2, address, 52 + len(data), len(contents), 0, 0, 1, 0))
+        data += contents
+
+    headers.append(struct.pack('<IIIIIIIIII', 9, 3, 0, 0, 52 + len(data), len(names), 0, 0, 1, 0))
+    data += names
+
+    ident = b'\x7fELF\x01\x01\x01' + bytes(9)
+    header = struct.pack('<HHIIIIIHHHHHH', 2, machine, 1, 0, 0, 52 + len(data), 0, 52, 0, 0, 40, len(headers), len(headers) - 1)
+
+    return ident + header + data + b''.join(headers)
+
+
+STRINGS = qmk.debug_log.ElfStrings(_elf([(0x1000, b'%u %d\n\x00100%\n\x00name %S\n\x00flash\x00')]))
+
+
+def test_elf_strings():
+    assert STRINGS.pointer_size == 4
+    assert STRINGS.string_at(0x1000) == '%u %d\n'
+    assert STRINGS.string_at(0x1007) == '100%\n'
+    assert STRINGS.string_at(0x2000) is None
+
+
+def test_avr_elf_strings_are_in_flash():
+    strings = qmk.debug_log.ElfStrings(_elf([(0x100, b'flash\0'), (0x800100, b'ram\0')], machine=qmk.debug_log.EM_AVR))
+    assert strings.pointer_size == 2
+    assert strings.string_at(0x100) == 'flash'
+    assert strings.string_at(0x800100) is None
+
+
+def test_format_message():
+    assert qmk.debug_log.format_message('%u %d', [b'\xc8\x00', b'\xfb\xff']) == '200 -5'
+    assert qmk.debug_log.format_message('%02X:%08lX', [b'\x0a\x00', b'\xef\xbe\xad\xde']) == '0A:DEADBEEF'
+    assert qmk.debug_log.format_message('%08b|%-4b|', [b'\x05\x00', b'\x01\x00']) == '00000101|1   |'
+    assert qmk.debug_log.format_message('%c%s %%', [b'Q\x00', (0x1234, 'MK')]) == 'QMK %'
+
+
+def test_format_message_missing_arguments():
+    assert qmk.debug_log.format_message('%d %d %s', [b'\x01\x00\x00\x00']) == '1 ? ?'
+
+
+def test_format_message_flash_strings():
+    assert qmk.debug_log.format_message('%S', [(0x1016, 'garbage')], STRINGS) == 'flash'
+
+
+def test_decoder_reassembles_records_across_reports():
+    decoder = qmk.debug_log.Decoder(STRINGS)
+    stream = bytes([0x0e]) + b'\x00\x10\x00\x00' + b'\x04\xc8\x00\x00\x00' + b'\x04\xfb\xff\xff\xff'
+    stream += bytes([0x44]) + b'\x07\x10\x00\x00'
+    stream += bytes([0x83]) + b'ok\n'
+
+    # A full report can end inside a record, padding only follows the last one
+    assert decoder.feed(stream[:6]) == []
+    assert decoder.feed(stream[6:] + bytes(10)) == ['200 -5\n', '100%\n', 'ok\n']
+
+
+def test_decoder_reports_drops_and_unknown_addresses():
+    decoder = qmk.debug_log.Decoder(STRINGS)
+    assert decoder.feed(bytes([0x07]) + bytes(4) + b'\x02\x03\x00') == ['[3 messages dropped]\n']
+    assert decoder.feed(bytes([0x44]) + b'\x00\x30\x00\x00') == ['[unknown message at 0x3000, is this the right ELF file?]\n']
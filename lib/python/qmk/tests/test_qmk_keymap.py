@@ -1,4 +1,7 @@
+import re
+
 import qmk.keymap
+from qmk.constants import QMK_FIRMWARE
 
 
 def test_template_onekey_proton_c():
@@ -16,4 +19,42 @@ def test_generate_onekey_pytest():
     assert templ == '#include QMK_KEYBOARD_H\nconst uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {\t[0] = LAYOUT(KC_A)};\n'
 
 
+def test_compress_skips_transparent_keys():
+    keymap = qmk.keymap.compress(1, 3, [[['KC_A', 'KC_TRNS', None]], [['_______', 'KC_B', None]]])
+    assert 'KC_A, KC_NO,\n' in keymap
+    assert 'KC_B,\n' in keymap
+    assert '.presence = {0x05},\n\t\t.offset   = {0},' in keymap
+    assert '.presence = {0x02},\n\t\t.offset   = {2},' in keymap
+
+
+def _split_keycodes(row):
+    """Splits a row of C keycodes on the commas that are not inside parentheses.
+    """
+    keycodes = ['']
+    depth = 0
+
+    for char in row:
+        if char == ',' and not depth:
+            keycodes.append('')
+            continue
+
+        depth += (char == '(') - (char == ')')
+        keycodes[-1] += char
+
+    return [keycode.strip() for keycode in keycodes if keycode.strip()]
+
+
+def test_compress_matches_keymap_compression_test():
+    # The keyboard test decodes hand written tables, make sure they are what the compressor produces for its reference keymap
+    keymap_c = (QMK_FIRMWARE / 'tests' / 'keymap_compression' / 'keymap.c').read_text()
+    reference = keymap_c[keymap_c.index('keymaps_reference'):]
+    rows = [_split_keycodes(row) for row in re.findall(r'^\s*\{(.*)\},$', reference, re.MULTILINE)]
+    layers = [rows[i:i + 4] for i in range(0, len(rows), 4)]
+
+    keymap = qmk.keymap.compress(4, 10, layers)
+
+    assert len(layers) == 4
+    assert re.sub(r'\s', '', keymap) in re.sub(r'\s', '', keymap_c)
+
+
 # FIXME(skullydazed): Add a test for qmk.keymap.write that mocks up an FD.
@@ -0,0 +1,34 @@
+import pytest
+
+import qmk.leader
+
+
+def test_trie_shares_prefixes():
+    trie = qmk.leader.trie([{'keys': ['KC_A']}, {'keys': ['KC_B', 'KC_A']}, {'keys': ['KC_B', 'KC_C']}])
+    assert trie == [
+        ['2', '0', 'KC_A', '6', 'KC_B', '8'],
+        ['0', '1'],
+        ['2', '0', 'KC_A', '14', 'KC_C', '16'],
+        ['0', '2'],
+        ['0', '3'],
+    ]
+
+
+def test_generate_send_string():
+    leader_c = qmk.leader.generate([{'keys': ['KC_F'], 'send_string': 'QMK "rocks"'}])
+    assert 'static void leader_send_string_0(void) { SEND_STRING("QMK \\"rocks\\""); }' in leader_c
+    assert 'const leader_action_t PROGMEM leader_dictionary_actions[] = {\n\tleader_send_string_0,\n};' in leader_c
+
+
+def test_generate_send_string_escapes_control_characters():
+    # The example from docs/feature_leader_key.md
+    leader_c = qmk.leader.generate([{'keys': ['KC_D', 'KC_D', 'KC_S'], 'send_string': 'https://start.duckduckgo.com\n'}])
+    assert 'SEND_STRING("https://start.duckduckgo.com\\n");' in leader_c
+
+    leader_c = qmk.leader.generate([{'keys': ['KC_F'], 'send_string': '\ta\r\x1bB\x07z'}])
+    assert 'SEND_STRING("\\ta\\r\\x1b" "B\\x07z");' in leader_c
+
+
+def test_generate_without_sequences():
+    with pytest.raises(ValueError):
+        qmk.leader.generate([])
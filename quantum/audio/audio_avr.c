@@ -24,6 +24,7 @@
 #endif
 #include "print.h"
 #include "audio.h"
+#include "wavetable.h"
 #include "keymap.h"
 #include "wait.h"
 
@@ -117,18 +118,23 @@
 
 // -----------------------------------------------------------------------------
 
-int   voices        = 0;
-int   voice_place   = 0;
-float frequency     = 0;
-float frequency_alt = 0;
-int   volume        = 0;
-long  position      = 0;
+int  voices      = 0;
+int  voice_place = 0;
+int  volume      = 0;
+long position    = 0;
 
 float frequencies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 int   volumes[8]     = {0, 0, 0, 0, 0, 0, 0, 0};
 bool  sliding        = false;
 
-float place = 0;
+uint16_t place = 0;
+
+// Per note parameters are worked out once in play_note()/play_notes(), the ISRs
+// only step the channels, see wavetable.h
+static wavetable_note_t    voice_notes[8];
+static wavetable_note_t    song_note;
+static wavetable_channel_t channel_1;
+static wavetable_channel_t channel_2;
 
 uint8_t* sample;
 uint16_t sample_length = 0;
@@ -149,20 +155,17 @@ uint16_t current_note = 0;
 uint8_t  rest_counter = 0;
 
 #ifdef VIBRATO_ENABLE
-float vibrato_counter  = 0;
 float vibrato_strength = .5;
 float vibrato_rate     = 0.125;
 #endif
 
-float polyphony_rate = 0;
+float           polyphony_rate = 0;
+static uint32_t polyphony_step = 0;
 
 static bool audio_initialized = false;
 
 audio_config_t audio_config;
 
-uint16_t envelope_index = 0;
-bool     glissando      = true;
-
 #ifndef STARTUP_SONG
 #    define STARTUP_SONG SONG(STARTUP_SOUND)
 #endif
@@ -176,6 +179,17 @@ float startup_song[][2]   = STARTUP_SONG;
 float audio_on_song[][2]  = AUDIO_ON_SONG;
 float audio_off_song[][2] = AUDIO_OFF_SONG;
 
+#ifdef VIBRATO_ENABLE
+// Notes pick up the vibrato settings when they start, see wavetable_note_init()
+static void update_vibrato(void) {
+#    ifdef VIBRATO_STRENGTH_ENABLE
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength);
+#    else
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength > 0 ? 1.0f : 0);
+#    endif
+}
+#endif
+
 void audio_init() {
     // Check EEPROM
     if (!eeconfig_is_enabled()) {
@@ -225,6 +239,12 @@ void audio_init() {
         TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (440 * CPU_PRESCALER)) * note_timbre);
 #endif
 
+        wavetable_channel_init(&channel_1);
+        wavetable_channel_init(&channel_2);
+#ifdef VIBRATO_ENABLE
+        update_vibrato();
+#endif
+
         audio_initialized = true;
     }
 
@@ -253,9 +273,9 @@ void stop_all_notes() {
 
     playing_notes = false;
     playing_note  = false;
-    frequency     = 0;
-    frequency_alt = 0;
     volume        = 0;
+    wavetable_channel_init(&channel_1);
+    wavetable_channel_init(&channel_2);
 
     for (uint8_t i = 0; i < 8; i++) {
         frequencies[i] = 0;
@@ -277,6 +297,7 @@ void stop_note(float freq) {
                 for (int j = i; (j < 7); j++) {
                     frequencies[j]     = frequencies[j + 1];
                     frequencies[j + 1] = 0;
+                    voice_notes[j]     = voice_notes[j + 1];
                     volumes[j]         = volumes[j + 1];
                     volumes[j + 1]     = 0;
                 }
@@ -297,157 +318,58 @@ void stop_note(float freq) {
             DISABLE_AUDIO_COUNTER_1_ISR;
             DISABLE_AUDIO_COUNTER_1_OUTPUT;
 #endif
-            frequency     = 0;
-            frequency_alt = 0;
-            volume        = 0;
-            playing_note  = false;
+            volume       = 0;
+            playing_note = false;
+            wavetable_channel_init(&channel_1);
+            wavetable_channel_init(&channel_2);
         }
     }
 }
 
-#ifdef VIBRATO_ENABLE
-
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
-
-float vibrato(float average_freq) {
-#    ifdef VIBRATO_STRENGTH_ENABLE
-    float vibrated_freq = average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
-#    else
-    float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
-#    endif
-    vibrato_counter = mod((vibrato_counter + vibrato_rate * (1.0 + 440.0 / average_freq)), VIBRATO_LUT_LENGTH);
-    return vibrated_freq;
-}
-
-#endif
-
 #ifdef CPIN_AUDIO
 ISR(TIMER3_AUDIO_vect) {
-    float freq;
+    uint32_t freq;
+    uint16_t period;
 
     if (playing_note) {
         if (voices > 0) {
 #    ifdef BPIN_AUDIO
-            float freq_alt = 0;
             if (voices > 1) {
-                if (polyphony_rate == 0) {
-                    if (glissando) {
-                        if (frequency_alt != 0 && frequency_alt < frequencies[voices - 2] && frequency_alt < frequencies[voices - 2] * pow(2, -440 / frequencies[voices - 2] / 12 / 2)) {
-                            frequency_alt = frequency_alt * pow(2, 440 / frequency_alt / 12 / 2);
-                        } else if (frequency_alt != 0 && frequency_alt > frequencies[voices - 2] && frequency_alt > frequencies[voices - 2] * pow(2, 440 / frequencies[voices - 2] / 12 / 2)) {
-                            frequency_alt = frequency_alt * pow(2, -440 / frequency_alt / 12 / 2);
-                        } else {
-                            frequency_alt = frequencies[voices - 2];
-                        }
-                    } else {
-                        frequency_alt = frequencies[voices - 2];
-                    }
-
-#        ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq_alt = vibrato(frequency_alt);
-                    } else {
-                        freq_alt = frequency_alt;
-                    }
-#        else
-                    freq_alt = frequency_alt;
-#        endif
-                }
-
-                if (envelope_index < 65535) {
-                    envelope_index++;
-                }
-
-                freq_alt = voice_envelope(freq_alt);
-
-                if (freq_alt < 30.517578125) {
-                    freq_alt = 30.52;
-                }
+                uint32_t freq_alt = wavetable_step(&channel_2, &voice_notes[voices - 2], polyphony_rate == 0);
 
-                TIMER_1_PERIOD     = (uint16_t)(((float)F_CPU) / (freq_alt * CPU_PRESCALER));
-                TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq_alt * CPU_PRESCALER)) * note_timbre);
+                period             = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq_alt);
+                TIMER_1_PERIOD     = period;
+                TIMER_1_DUTY_CYCLE = WAVETABLE_DUTY(period, channel_2.timbre);
             }
 #    endif
 
-            if (polyphony_rate > 0) {
+            if (polyphony_rate > 0 && polyphony_step > 0) {
                 if (voices > 1) {
                     voice_place %= voices;
-                    if (place++ > (frequencies[voice_place] / polyphony_rate / CPU_PRESCALER)) {
+                    if (place++ > voice_notes[voice_place].frequency / polyphony_step) {
                         voice_place = (voice_place + 1) % voices;
-                        place       = 0.0;
+                        place       = 0;
                     }
                 }
 
-#    ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequencies[voice_place]);
-                } else {
-                    freq = frequencies[voice_place];
-                }
-#    else
-                freq = frequencies[voice_place];
-#    endif
+                freq = wavetable_step(&channel_1, &voice_notes[voice_place], false);
             } else {
-                if (glissando) {
-                    if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, 440 / frequency / 12 / 2);
-                    } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, -440 / frequency / 12 / 2);
-                    } else {
-                        frequency = frequencies[voices - 1];
-                    }
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-#    ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequency);
-                } else {
-                    freq = frequency;
-                }
-#    else
-                freq = frequency;
-#    endif
-            }
-
-            if (envelope_index < 65535) {
-                envelope_index++;
+                freq = wavetable_step(&channel_1, &voice_notes[voices - 1], true);
             }
 
-            freq = voice_envelope(freq);
-
-            if (freq < 30.517578125) {
-                freq = 30.52;
-            }
-
-            TIMER_3_PERIOD     = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_3_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            period             = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            TIMER_3_PERIOD     = period;
+            TIMER_3_DUTY_CYCLE = WAVETABLE_DUTY(period, channel_1.timbre);
         }
     }
 
     if (playing_notes) {
-        if (note_frequency > 0) {
-#    ifdef VIBRATO_ENABLE
-            if (vibrato_strength > 0) {
-                freq = vibrato(note_frequency);
-            } else {
-                freq = note_frequency;
-            }
-#    else
-            freq = note_frequency;
-#    endif
+        if (song_note.frequency > 0) {
+            freq = wavetable_step(&channel_1, &song_note, false);
 
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
-
-            TIMER_3_PERIOD     = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_3_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            period             = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            TIMER_3_PERIOD     = period;
+            TIMER_3_DUTY_CYCLE = WAVETABLE_DUTY(period, channel_1.timbre);
         } else {
             TIMER_3_PERIOD     = 0;
             TIMER_3_DUTY_CYCLE = 0;
@@ -487,11 +409,12 @@ ISR(TIMER3_AUDIO_vect) {
                     note_length    = 1;
                 }
             } else {
-                note_resting   = false;
-                envelope_index = 0;
+                note_resting = false;
+                wavetable_channel_restart(&channel_1);
                 note_frequency = (*notes_pointer)[current_note][0];
                 note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
             }
+            wavetable_note_init(&song_note, note_frequency);
 
             note_position = 0;
         }
@@ -507,86 +430,38 @@ ISR(TIMER3_AUDIO_vect) {
 #ifdef BPIN_AUDIO
 ISR(TIMER1_AUDIO_vect) {
 #    if defined(BPIN_AUDIO) && !defined(CPIN_AUDIO)
-    float freq = 0;
+    uint32_t freq;
+    uint16_t period;
 
     if (playing_note) {
         if (voices > 0) {
-            if (polyphony_rate > 0) {
+            if (polyphony_rate > 0 && polyphony_step > 0) {
                 if (voices > 1) {
                     voice_place %= voices;
-                    if (place++ > (frequencies[voice_place] / polyphony_rate / CPU_PRESCALER)) {
+                    if (place++ > voice_notes[voice_place].frequency / polyphony_step) {
                         voice_place = (voice_place + 1) % voices;
-                        place       = 0.0;
+                        place       = 0;
                     }
                 }
 
-#        ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequencies[voice_place]);
-                } else {
-                    freq = frequencies[voice_place];
-                }
-#        else
-                freq = frequencies[voice_place];
-#        endif
+                freq = wavetable_step(&channel_1, &voice_notes[voice_place], false);
             } else {
-                if (glissando) {
-                    if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, 440 / frequency / 12 / 2);
-                    } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, -440 / frequency / 12 / 2);
-                    } else {
-                        frequency = frequencies[voices - 1];
-                    }
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-#        ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequency);
-                } else {
-                    freq = frequency;
-                }
-#        else
-                freq = frequency;
-#        endif
+                freq = wavetable_step(&channel_1, &voice_notes[voices - 1], true);
             }
 
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-
-            freq = voice_envelope(freq);
-
-            if (freq < 30.517578125) {
-                freq = 30.52;
-            }
-
-            TIMER_1_PERIOD     = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            period             = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            TIMER_1_PERIOD     = period;
+            TIMER_1_DUTY_CYCLE = WAVETABLE_DUTY(period, channel_1.timbre);
         }
     }
 
     if (playing_notes) {
-        if (note_frequency > 0) {
-#        ifdef VIBRATO_ENABLE
-            if (vibrato_strength > 0) {
-                freq = vibrato(note_frequency);
-            } else {
-                freq = note_frequency;
-            }
-#        else
-            freq = note_frequency;
-#        endif
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
+        if (song_note.frequency > 0) {
+            freq = wavetable_step(&channel_1, &song_note, false);
 
-            TIMER_1_PERIOD     = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            period             = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            TIMER_1_PERIOD     = period;
+            TIMER_1_DUTY_CYCLE = WAVETABLE_DUTY(period, channel_1.timbre);
         } else {
             TIMER_1_PERIOD     = 0;
             TIMER_1_DUTY_CYCLE = 0;
@@ -626,11 +501,12 @@ ISR(TIMER1_AUDIO_vect) {
                     note_length    = 1;
                 }
             } else {
-                note_resting   = false;
-                envelope_index = 0;
+                note_resting = false;
+                wavetable_channel_restart(&channel_1);
                 note_frequency = (*notes_pointer)[current_note][0];
                 note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
             }
+            wavetable_note_init(&song_note, note_frequency);
 
             note_position = 0;
         }
@@ -664,11 +540,13 @@ void play_note(float freq, int vol) {
 
         playing_note = true;
 
-        envelope_index = 0;
+        wavetable_channel_restart(&channel_1);
+        wavetable_channel_restart(&channel_2);
 
         if (freq > 0) {
             frequencies[voices] = freq;
-            volumes[voices]     = vol;
+            wavetable_note_init(&voice_notes[voices], freq);
+            volumes[voices] = vol;
             voices++;
         }
 
@@ -718,6 +596,8 @@ void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
         note_frequency = (*notes_pointer)[current_note][0];
         note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
         note_position  = 0;
+        wavetable_note_init(&song_note, note_frequency);
+        wavetable_channel_restart(&channel_1);
 
 #ifdef CPIN_AUDIO
         ENABLE_AUDIO_COUNTER_3_ISR;
@@ -761,19 +641,37 @@ void audio_off(void) {
 
 // Vibrato rate functions
 
-void set_vibrato_rate(float rate) { vibrato_rate = rate; }
+void set_vibrato_rate(float rate) {
+    vibrato_rate = rate;
+    update_vibrato();
+}
 
-void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+void increase_vibrato_rate(float change) {
+    vibrato_rate *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+void decrease_vibrato_rate(float change) {
+    vibrato_rate /= change;
+    update_vibrato();
+}
 
 #    ifdef VIBRATO_STRENGTH_ENABLE
 
-void set_vibrato_strength(float strength) { vibrato_strength = strength; }
+void set_vibrato_strength(float strength) {
+    vibrato_strength = strength;
+    update_vibrato();
+}
 
-void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+void increase_vibrato_strength(float change) {
+    vibrato_strength *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+void decrease_vibrato_strength(float change) {
+    vibrato_strength /= change;
+    update_vibrato();
+}
 
 #    endif /* VIBRATO_STRENGTH_ENABLE */
 
@@ -781,15 +679,33 @@ void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
 
 // Polyphony functions
 
-void set_polyphony_rate(float rate) { polyphony_rate = rate; }
+// The ISRs run once per timer period, so the step also scales by CPU_PRESCALER like the float version
+static void update_polyphony(void) { polyphony_step = (uint32_t)(polyphony_rate * CPU_PRESCALER * 65536.0f); }
+
+void set_polyphony_rate(float rate) {
+    polyphony_rate = rate;
+    update_polyphony();
+}
 
-void enable_polyphony() { polyphony_rate = 5; }
+void enable_polyphony() {
+    polyphony_rate = 5;
+    update_polyphony();
+}
 
-void disable_polyphony() { polyphony_rate = 0; }
+void disable_polyphony() {
+    polyphony_rate = 0;
+    update_polyphony();
+}
 
-void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+void increase_polyphony_rate(float change) {
+    polyphony_rate *= change;
+    update_polyphony();
+}
 
-void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+void decrease_polyphony_rate(float change) {
+    polyphony_rate /= change;
+    update_polyphony();
+}
 
 // Timbre function
 
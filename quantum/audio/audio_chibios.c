@@ -15,6 +15,7 @@
  */
 
 #include "audio.h"
+#include "wavetable.h"
 #include "ch.h"
 #include "hal.h"
 
@@ -26,18 +27,23 @@
 
 // -----------------------------------------------------------------------------
 
-int   voices        = 0;
-int   voice_place   = 0;
-float frequency     = 0;
-float frequency_alt = 0;
-int   volume        = 0;
-long  position      = 0;
+int  voices      = 0;
+int  voice_place = 0;
+int  volume      = 0;
+long position    = 0;
 
 float frequencies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 int   volumes[8]     = {0, 0, 0, 0, 0, 0, 0, 0};
 bool  sliding        = false;
 
-float place = 0;
+uint16_t place = 0;
+
+// Per note parameters are worked out once in play_note()/play_notes(), the ISR
+// only steps the channels, see wavetable.h
+static wavetable_note_t    voice_notes[8];
+static wavetable_note_t    song_note;
+static wavetable_channel_t channel_1;
+static wavetable_channel_t channel_2;
 
 uint8_t *sample;
 uint16_t sample_length = 0;
@@ -58,25 +64,33 @@ uint16_t current_note = 0;
 uint8_t  rest_counter = 0;
 
 #ifdef VIBRATO_ENABLE
-float vibrato_counter  = 0;
 float vibrato_strength = .5;
 float vibrato_rate     = 0.125;
 #endif
 
-float polyphony_rate = 0;
+float           polyphony_rate = 0;
+static uint32_t polyphony_step = 0;
 
 static bool audio_initialized = false;
 
 audio_config_t audio_config;
 
-uint16_t envelope_index = 0;
-bool     glissando      = true;
-
 #ifndef STARTUP_SONG
 #    define STARTUP_SONG SONG(STARTUP_SOUND)
 #endif
 float startup_song[][2] = STARTUP_SONG;
 
+#ifdef VIBRATO_ENABLE
+// Notes pick up the vibrato settings when they start, see wavetable_note_init()
+static void update_vibrato(void) {
+#    ifdef VIBRATO_STRENGTH_ENABLE
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength);
+#    else
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength > 0 ? 1.0f : 0);
+#    endif
+}
+#endif
+
 static void gpt_cb8(GPTDriver *gptp);
 
 #define DAC_BUFFER_SIZE 100
@@ -98,11 +112,12 @@ static void gpt_cb8(GPTDriver *gptp);
 #define RESTART_CHANNEL_2() \
     STOP_CHANNEL_2();       \
     START_CHANNEL_2()
-#define UPDATE_CHANNEL_1_FREQ(freq)              \
-    gpt6cfg1.frequency = freq * DAC_BUFFER_SIZE; \
+// freq is Q16.16 Hz, see wavetable.h
+#define UPDATE_CHANNEL_1_FREQ(freq)                              \
+    gpt6cfg1.frequency = (((freq) >> 8) * DAC_BUFFER_SIZE) >> 8; \
     RESTART_CHANNEL_1()
-#define UPDATE_CHANNEL_2_FREQ(freq)              \
-    gpt7cfg1.frequency = freq * DAC_BUFFER_SIZE; \
+#define UPDATE_CHANNEL_2_FREQ(freq)                              \
+    gpt7cfg1.frequency = (((freq) >> 8) * DAC_BUFFER_SIZE) >> 8; \
     RESTART_CHANNEL_2()
 #define GET_CHANNEL_1_FREQ (uint16_t)(gpt6cfg1.frequency * DAC_BUFFER_SIZE)
 #define GET_CHANNEL_2_FREQ (uint16_t)(gpt7cfg1.frequency * DAC_BUFFER_SIZE)
@@ -285,6 +300,12 @@ void audio_init() {
     dacStartConversion(&DACD1, &dacgrpcfg1, (dacsample_t *)dac_buffer, DAC_BUFFER_SIZE);
     dacStartConversion(&DACD2, &dacgrpcfg2, (dacsample_t *)dac_buffer_2, DAC_BUFFER_SIZE);
 
+    wavetable_channel_init(&channel_1);
+    wavetable_channel_init(&channel_2);
+#ifdef VIBRATO_ENABLE
+    update_vibrato();
+#endif
+
     audio_initialized = true;
 
     if (audio_config.enable) {
@@ -308,9 +329,9 @@ void stop_all_notes() {
 
     playing_notes = false;
     playing_note  = false;
-    frequency     = 0;
-    frequency_alt = 0;
     volume        = 0;
+    wavetable_channel_init(&channel_1);
+    wavetable_channel_init(&channel_2);
 
     for (uint8_t i = 0; i < 8; i++) {
         frequencies[i] = 0;
@@ -332,6 +353,7 @@ void stop_note(float freq) {
                 for (int j = i; (j < 7); j++) {
                     frequencies[j]     = frequencies[j + 1];
                     frequencies[j + 1] = 0;
+                    voice_notes[j]     = voice_notes[j + 1];
                     volumes[j]         = volumes[j + 1];
                     volumes[j + 1]     = 0;
                 }
@@ -349,165 +371,59 @@ void stop_note(float freq) {
             STOP_CHANNEL_1();
             STOP_CHANNEL_2();
             gptStopTimer(&GPTD8);
-            frequency     = 0;
-            frequency_alt = 0;
-            volume        = 0;
-            playing_note  = false;
+            volume       = 0;
+            playing_note = false;
+            wavetable_channel_init(&channel_1);
+            wavetable_channel_init(&channel_2);
         }
     }
 }
 
-#ifdef VIBRATO_ENABLE
-
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
-
-float vibrato(float average_freq) {
-#    ifdef VIBRATO_STRENGTH_ENABLE
-    float vibrated_freq = average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
-#    else
-    float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
-#    endif
-    vibrato_counter = mod((vibrato_counter + vibrato_rate * (1.0 + 440.0 / average_freq)), VIBRATO_LUT_LENGTH);
-    return vibrated_freq;
-}
-
-#endif
-
 static void gpt_cb8(GPTDriver *gptp) {
-    float freq;
+    uint32_t freq;
 
     if (playing_note) {
         if (voices > 0) {
-            float freq_alt = 0;
             if (voices > 1) {
-                if (polyphony_rate == 0) {
-                    if (glissando) {
-                        if (frequency_alt != 0 && frequency_alt < frequencies[voices - 2] && frequency_alt < frequencies[voices - 2] * pow(2, -440 / frequencies[voices - 2] / 12 / 2)) {
-                            frequency_alt = frequency_alt * pow(2, 440 / frequency_alt / 12 / 2);
-                        } else if (frequency_alt != 0 && frequency_alt > frequencies[voices - 2] && frequency_alt > frequencies[voices - 2] * pow(2, 440 / frequencies[voices - 2] / 12 / 2)) {
-                            frequency_alt = frequency_alt * pow(2, -440 / frequency_alt / 12 / 2);
-                        } else {
-                            frequency_alt = frequencies[voices - 2];
-                        }
-                    } else {
-                        frequency_alt = frequencies[voices - 2];
-                    }
+                uint32_t freq_alt = wavetable_step(&channel_2, &voice_notes[voices - 2], polyphony_rate == 0);
 
-#ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq_alt = vibrato(frequency_alt);
-                    } else {
-                        freq_alt = frequency_alt;
-                    }
-#else
-                    freq_alt = frequency_alt;
-#endif
-                }
-
-                if (envelope_index < 65535) {
-                    envelope_index++;
-                }
-
-                freq_alt = voice_envelope(freq_alt);
-
-                if (freq_alt < 30.517578125) {
-                    freq_alt = 30.52;
-                }
-
-                if (GET_CHANNEL_2_FREQ != (uint16_t)freq_alt) {
+                if (GET_CHANNEL_2_FREQ != (uint16_t)(freq_alt >> 16)) {
                     UPDATE_CHANNEL_2_FREQ(freq_alt);
                 } else {
                     RESTART_CHANNEL_2();
                 }
-                // note_timbre;
             }
 
-            if (polyphony_rate > 0) {
+            if (polyphony_rate > 0 && polyphony_step > 0) {
                 if (voices > 1) {
                     voice_place %= voices;
-                    if (place++ > (frequencies[voice_place] / polyphony_rate)) {
+                    if (place++ > voice_notes[voice_place].frequency / polyphony_step) {
                         voice_place = (voice_place + 1) % voices;
-                        place       = 0.0;
+                        place       = 0;
                     }
                 }
 
-#ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequencies[voice_place]);
-                } else {
-                    freq = frequencies[voice_place];
-                }
-#else
-                freq = frequencies[voice_place];
-#endif
+                freq = wavetable_step(&channel_1, &voice_notes[voice_place], false);
             } else {
-                if (glissando) {
-                    if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, 440 / frequency / 12 / 2);
-                    } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440 / frequencies[voices - 1] / 12 / 2)) {
-                        frequency = frequency * pow(2, -440 / frequency / 12 / 2);
-                    } else {
-                        frequency = frequencies[voices - 1];
-                    }
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-#ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequency);
-                } else {
-                    freq = frequency;
-                }
-#else
-                freq = frequency;
-#endif
-            }
-
-            if (envelope_index < 65535) {
-                envelope_index++;
+                freq = wavetable_step(&channel_1, &voice_notes[voices - 1], true);
             }
 
-            freq = voice_envelope(freq);
-
-            if (freq < 30.517578125) {
-                freq = 30.52;
-            }
-
-            if (GET_CHANNEL_1_FREQ != (uint16_t)freq) {
+            if (GET_CHANNEL_1_FREQ != (uint16_t)(freq >> 16)) {
                 UPDATE_CHANNEL_1_FREQ(freq);
             } else {
                 RESTART_CHANNEL_1();
             }
-            // note_timbre;
         }
     }
 
     if (playing_notes) {
-        if (note_frequency > 0) {
-#ifdef VIBRATO_ENABLE
-            if (vibrato_strength > 0) {
-                freq = vibrato(note_frequency);
-            } else {
-                freq = note_frequency;
-            }
-#else
-            freq = note_frequency;
-#endif
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
+        if (song_note.frequency > 0) {
+            freq = wavetable_step(&channel_1, &song_note, false);
 
-            if (GET_CHANNEL_1_FREQ != (uint16_t)freq) {
+            if (GET_CHANNEL_1_FREQ != (uint16_t)(freq >> 16)) {
                 UPDATE_CHANNEL_1_FREQ(freq);
                 UPDATE_CHANNEL_2_FREQ(freq);
             }
-            // note_timbre;
         } else {
             // gptStopTimer(&GPTD6);
             // gptStopTimer(&GPTD7);
@@ -548,11 +464,12 @@ static void gpt_cb8(GPTDriver *gptp) {
                     note_length    = 1;
                 }
             } else {
-                note_resting   = false;
-                envelope_index = 0;
+                note_resting = false;
+                wavetable_channel_restart(&channel_1);
                 note_frequency = (*notes_pointer)[current_note][0];
                 note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
             }
+            wavetable_note_init(&song_note, note_frequency);
 
             note_position = 0;
         }
@@ -579,11 +496,13 @@ void play_note(float freq, int vol) {
 
         playing_note = true;
 
-        envelope_index = 0;
+        wavetable_channel_restart(&channel_1);
+        wavetable_channel_restart(&channel_2);
 
         if (freq > 0) {
             frequencies[voices] = freq;
-            volumes[voices]     = vol;
+            wavetable_note_init(&voice_notes[voices], freq);
+            volumes[voices] = vol;
             voices++;
         }
 
@@ -617,6 +536,8 @@ void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
         note_frequency = (*notes_pointer)[current_note][0];
         note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
         note_position  = 0;
+        wavetable_note_init(&song_note, note_frequency);
+        wavetable_channel_restart(&channel_1);
 
         gptStart(&GPTD8, &gpt8cfg1);
         gptStartContinuous(&GPTD8, 2U);
@@ -653,19 +574,37 @@ void audio_off(void) {
 
 // Vibrato rate functions
 
-void set_vibrato_rate(float rate) { vibrato_rate = rate; }
+void set_vibrato_rate(float rate) {
+    vibrato_rate = rate;
+    update_vibrato();
+}
 
-void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+void increase_vibrato_rate(float change) {
+    vibrato_rate *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+void decrease_vibrato_rate(float change) {
+    vibrato_rate /= change;
+    update_vibrato();
+}
 
 #    ifdef VIBRATO_STRENGTH_ENABLE
 
-void set_vibrato_strength(float strength) { vibrato_strength = strength; }
+void set_vibrato_strength(float strength) {
+    vibrato_strength = strength;
+    update_vibrato();
+}
 
-void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+void increase_vibrato_strength(float change) {
+    vibrato_strength *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+void decrease_vibrato_strength(float change) {
+    vibrato_strength /= change;
+    update_vibrato();
+}
 
 #    endif /* VIBRATO_STRENGTH_ENABLE */
 
@@ -673,15 +612,33 @@ void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
 
 // Polyphony functions
 
-void set_polyphony_rate(float rate) { polyphony_rate = rate; }
+// The ISR compares against the Q16.16 note frequency divided by this
+static void update_polyphony(void) { polyphony_step = (uint32_t)(polyphony_rate * 65536.0f); }
+
+void set_polyphony_rate(float rate) {
+    polyphony_rate = rate;
+    update_polyphony();
+}
 
-void enable_polyphony() { polyphony_rate = 5; }
+void enable_polyphony() {
+    polyphony_rate = 5;
+    update_polyphony();
+}
 
-void disable_polyphony() { polyphony_rate = 0; }
+void disable_polyphony() {
+    polyphony_rate = 0;
+    update_polyphony();
+}
 
-void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+void increase_polyphony_rate(float change) {
+    polyphony_rate *= change;
+    update_polyphony();
+}
 
-void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+void decrease_polyphony_rate(float change) {
+    polyphony_rate /= change;
+    update_polyphony();
+}
 
 // Timbre function
 
@@ -0,0 +1,276 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* ChibiOS audio driver that streams a mixed signal to the DAC.
+ *
+ * TIM6 triggers both DAC channels at a fixed sample rate and DMA feeds them
+ * from circular buffers. The DAC callback runs at every half and full
+ * transfer and renders the half that was just played with audio_mixer.c, so
+ * notes never reprogram a timer and the interrupt load does not depend on
+ * how many notes are playing or how high they are.
+ */
+
+#include "audio.h"
+#include "audio_mixer.h"
+#include "ch.h"
+#include "hal.h"
+
+#include "print.h"
+#include "eeconfig.h"
+
+#ifndef AUDIO_MIXER_SAMPLE_RATE
+#    define AUDIO_MIXER_SAMPLE_RATE 25000U
+#endif
+
+// Samples in each circular DMA buffer, the mixer renders half of it per callback
+#ifndef AUDIO_MIXER_BUFFER_SIZE
+#    define AUDIO_MIXER_BUFFER_SIZE 256U
+#endif
+
+#ifndef DAC_SAMPLE_MAX
+#    define DAC_SAMPLE_MAX 4095U
+#endif
+
+// Must divide the timer clock exactly, and be a multiple of the sample rate
+#define AUDIO_MIXER_TIMER_FREQUENCY 1000000U
+
+_Static_assert(AUDIO_MIXER_TIMER_FREQUENCY % AUDIO_MIXER_SAMPLE_RATE == 0, "AUDIO_MIXER_SAMPLE_RATE must divide 1 MHz");
+_Static_assert(AUDIO_MIXER_BUFFER_SIZE % 2 == 0, "AUDIO_MIXER_BUFFER_SIZE must be even");
+
+// voices.c and the process_keycode code expect these from the audio driver
+uint8_t  note_tempo     = TEMPO_DEFAULT;
+float    note_timbre    = TIMBRE_DEFAULT;
+float    polyphony_rate = 0;
+uint16_t envelope_index = 0;
+bool     glissando      = true;
+
+#ifdef VIBRATO_ENABLE
+float vibrato_strength = .5;
+float vibrato_rate     = 0.125;
+#endif
+
+audio_config_t audio_config;
+
+static bool          audio_initialized = false;
+static audio_mixer_t mixer;
+
+static dacsample_t dac_buffer[AUDIO_MIXER_BUFFER_SIZE];
+static dacsample_t dac_buffer_inverted[AUDIO_MIXER_BUFFER_SIZE];
+
+#ifndef STARTUP_SONG
+#    define STARTUP_SONG SONG(STARTUP_SOUND)
+#endif
+float startup_song[][2] = STARTUP_SONG;
+
+static void dac_end(DACDriver *dacp) {
+    size_t offset = dacIsBufferComplete(dacp) ? AUDIO_MIXER_BUFFER_SIZE / 2 : 0;
+
+    audio_mixer_fill(&mixer, &dac_buffer[offset], AUDIO_MIXER_BUFFER_SIZE / 2);
+
+    // DAC2 drives the other side of the speaker
+    for (size_t i = offset; i < offset + AUDIO_MIXER_BUFFER_SIZE / 2; i++) {
+        dac_buffer_inverted[i] = DAC_SAMPLE_MAX - dac_buffer[i];
+    }
+}
+
+static void dac_error(DACDriver *dacp, dacerror_t err) {
+    (void)dacp;
+    (void)err;
+
+    chSysHalt("DAC failure");
+}
+
+static const GPTConfig gpt6cfg = {.frequency = AUDIO_MIXER_TIMER_FREQUENCY,
+                                  .callback  = NULL,
+                                  .cr2       = TIM_CR2_MMS_1, /* MMS = 010 = TRGO on Update Event.    */
+                                  .dier      = 0U};
+
+static const DACConfig dac_config = {.init = DAC_SAMPLE_MAX / 2, .datamode = DAC_DHRM_12BIT_RIGHT};
+
+static const DACConversionGroup dac_group = {.num_channels = 1U, .end_cb = dac_end, .error_cb = dac_error, .trigger = DAC_TRG(0)};
+
+static const DACConversionGroup dac_group_inverted = {.num_channels = 1U, .end_cb = NULL, .error_cb = dac_error, .trigger = DAC_TRG(0)};
+
+void audio_init() {
+    if (audio_initialized) {
+        return;
+    }
+
+// Check EEPROM
+#ifdef EEPROM_ENABLE
+    if (!eeconfig_is_enabled()) {
+        eeconfig_init();
+    }
+    audio_config.raw = eeconfig_read_audio();
+#else  // ARM EEPROM
+    audio_config.enable = true;
+#    ifdef AUDIO_CLICKY_ON
+    audio_config.clicky_enable = true;
+#    endif
+#endif  // ARM EEPROM
+
+    audio_mixer_init(&mixer, AUDIO_MIXER_SAMPLE_RATE, DAC_SAMPLE_MAX);
+    for (size_t i = 0; i < AUDIO_MIXER_BUFFER_SIZE; i++) {
+        dac_buffer[i]          = DAC_SAMPLE_MAX / 2;
+        dac_buffer_inverted[i] = DAC_SAMPLE_MAX - DAC_SAMPLE_MAX / 2;
+    }
+
+    palSetPadMode(GPIOA, 4, PAL_MODE_INPUT_ANALOG);
+    palSetPadMode(GPIOA, 5, PAL_MODE_INPUT_ANALOG);
+    dacStart(&DACD1, &dac_config);
+    dacStart(&DACD2, &dac_config);
+
+    dacStartConversion(&DACD1, &dac_group, dac_buffer, AUDIO_MIXER_BUFFER_SIZE);
+    dacStartConversion(&DACD2, &dac_group_inverted, dac_buffer_inverted, AUDIO_MIXER_BUFFER_SIZE);
+
+    // The sample clock runs for good, notes only change what the mixer renders
+    gptStart(&GPTD6, &gpt6cfg);
+    gptStartContinuous(&GPTD6, AUDIO_MIXER_TIMER_FREQUENCY / AUDIO_MIXER_SAMPLE_RATE);
+
+    audio_initialized = true;
+
+    if (audio_config.enable) {
+        PLAY_SONG(startup_song);
+    }
+}
+
+void stop_all_notes() {
+    dprintf("audio stop all notes");
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    chSysLock();
+    audio_mixer_all_off(&mixer);
+    chSysUnlock();
+}
+
+void stop_note(float freq) {
+    dprintf("audio stop note freq=%d", (int)freq);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    chSysLock();
+    audio_mixer_note_off(&mixer, freq);
+    chSysUnlock();
+}
+
+void play_note(float freq, int vol) {
+    dprintf("audio play note freq=%d vol=%d", (int)freq, vol);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        chSysLock();
+        audio_mixer_note_on(&mixer, freq, note_timbre);
+        chSysUnlock();
+    }
+}
+
+void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        chSysLock();
+        audio_mixer_play_song(&mixer, np, n_count, n_repeat, note_tempo, note_timbre);
+        chSysUnlock();
+    }
+}
+
+bool is_playing_notes(void) { return audio_mixer_song_playing(&mixer); }
+
+bool is_audio_on(void) { return (audio_config.enable != 0); }
+
+void audio_toggle(void) {
+    audio_config.enable ^= 1;
+    eeconfig_update_audio(audio_config.raw);
+    if (audio_config.enable) {
+        audio_on_user();
+    } else {
+        stop_all_notes();
+    }
+}
+
+void audio_on(void) {
+    audio_config.enable = 1;
+    eeconfig_update_audio(audio_config.raw);
+    audio_on_user();
+}
+
+void audio_off(void) {
+    stop_all_notes();
+    audio_config.enable = 0;
+    eeconfig_update_audio(audio_config.raw);
+}
+
+#ifdef VIBRATO_ENABLE
+
+// The mixer has no vibrato, these only keep the settings
+
+void set_vibrato_rate(float rate) { vibrato_rate = rate; }
+
+void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+
+void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+
+#    ifdef VIBRATO_STRENGTH_ENABLE
+
+void set_vibrato_strength(float strength) { vibrato_strength = strength; }
+
+void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+
+void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+
+#    endif /* VIBRATO_STRENGTH_ENABLE */
+
+#endif /* VIBRATO_ENABLE */
+
+// Polyphony functions, every note gets its own mixer voice so there is no rate to set
+
+void set_polyphony_rate(float rate) { polyphony_rate = rate; }
+
+void enable_polyphony() { polyphony_rate = 5; }
+
+void disable_polyphony() { polyphony_rate = 0; }
+
+void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+
+void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+
+// Timbre function
+
+void set_timbre(float timbre) { note_timbre = timbre; }
+
+// Tempo functions
+
+void set_tempo(uint8_t tempo) { note_tempo = tempo; }
+
+void decrease_tempo(uint8_t tempo_change) { note_tempo += tempo_change; }
+
+void increase_tempo(uint8_t tempo_change) {
+    if (note_tempo - tempo_change < 10) {
+        note_tempo = 10;
+    } else {
+        note_tempo -= tempo_change;
+    }
+}
@@ -0,0 +1,260 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include "audio_mixer.h"
+
+#define LEVEL_FULL (1UL << 24)
+#define LEVEL_SUSTAIN (LEVEL_FULL / 100 * AUDIO_MIXER_SUSTAIN_LEVEL)
+
+_Static_assert(AUDIO_MIXER_VOICES < AUDIO_MIXER_NO_VOICE, "AUDIO_MIXER_VOICES must be below 255");
+_Static_assert(AUDIO_MIXER_SUSTAIN_LEVEL <= 100, "AUDIO_MIXER_SUSTAIN_LEVEL is a percentage");
+
+static uint32_t ms_to_samples(const audio_mixer_t *mixer, uint32_t ms) {
+    uint32_t samples = mixer->sample_rate * ms / 1000;
+    return samples ? samples : 1;
+}
+
+void audio_mixer_init(audio_mixer_t *mixer, uint32_t sample_rate, uint16_t sample_max) {
+    memset(mixer, 0, sizeof(audio_mixer_t));
+    mixer->sample_rate  = sample_rate;
+    mixer->sample_max   = sample_max;
+    mixer->song.voice   = AUDIO_MIXER_NO_VOICE;
+    mixer->attack_step  = LEVEL_FULL / ms_to_samples(mixer, AUDIO_MIXER_ATTACK_MS);
+    mixer->decay_step   = (LEVEL_FULL - LEVEL_SUSTAIN) / ms_to_samples(mixer, AUDIO_MIXER_DECAY_MS);
+    mixer->release_step = LEVEL_FULL / ms_to_samples(mixer, AUDIO_MIXER_RELEASE_MS);
+    if (mixer->decay_step == 0) {
+        mixer->decay_step = 1;
+    }
+}
+
+static uint16_t timbre_to_duty(float timbre) {
+    if (timbre <= 0) return 0;
+    if (timbre >= 1) return UINT16_MAX;
+    return (uint16_t)(timbre * 65536.0f);
+}
+
+static uint8_t start_voice(audio_mixer_t *mixer, float frequency, uint16_t duty) {
+    // Free voices first, then the oldest fading one, then the oldest of all
+    uint8_t  chosen     = 0;
+    uint32_t chosen_age = 0;
+    uint8_t  chosen_bad = UINT8_MAX;
+    for (uint8_t i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        audio_mixer_voice_t *voice = &mixer->voices[i];
+        uint8_t              bad   = voice->stage == AUDIO_MIXER_IDLE ? 0 : voice->stage == AUDIO_MIXER_RELEASE ? 1 : 2;
+        uint32_t             age   = mixer->started - voice->started;
+        if (bad < chosen_bad || (bad == chosen_bad && age > chosen_age)) {
+            chosen     = i;
+            chosen_age = age;
+            chosen_bad = bad;
+        }
+    }
+
+    float nyquist = mixer->sample_rate / 2;
+    if (frequency > nyquist) {
+        frequency = nyquist;
+    }
+
+    // A stolen voice keeps its level and ramps from there, so there is no click
+    audio_mixer_voice_t *voice = &mixer->voices[chosen];
+    voice->phase               = 0;
+    voice->increment           = (uint32_t)(frequency * 4294967296.0f / mixer->sample_rate);
+    voice->duty                = duty;
+    voice->frequency           = frequency;
+    voice->started             = ++mixer->started;
+    voice->stage               = AUDIO_MIXER_ATTACK;
+    voice->song                = false;
+    if (chosen_bad == 0) {
+        voice->level = 0;
+    }
+    return chosen;
+}
+
+uint8_t audio_mixer_note_on(audio_mixer_t *mixer, float frequency, float timbre) {
+    if (frequency <= 0) {
+        return AUDIO_MIXER_NO_VOICE;
+    }
+    return start_voice(mixer, frequency, timbre_to_duty(timbre));
+}
+
+void audio_mixer_note_off(audio_mixer_t *mixer, float frequency) {
+    audio_mixer_voice_t *latest = NULL;
+    for (uint8_t i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        audio_mixer_voice_t *voice = &mixer->voices[i];
+        if (voice->song || voice->frequency != frequency || voice->stage == AUDIO_MIXER_IDLE || voice->stage == AUDIO_MIXER_RELEASE) {
+            continue;
+        }
+        if (!latest || voice->started - latest->started < UINT32_MAX / 2) {
+            latest = voice;
+        }
+    }
+    if (latest) {
+        latest->stage = AUDIO_MIXER_RELEASE;
+    }
+}
+
+void audio_mixer_all_off(audio_mixer_t *mixer) {
+    mixer->song.playing = false;
+    for (uint8_t i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        if (mixer->voices[i].stage != AUDIO_MIXER_IDLE) {
+            mixer->voices[i].stage = AUDIO_MIXER_RELEASE;
+        }
+    }
+}
+
+uint32_t audio_mixer_note_samples(const audio_mixer_t *mixer, float duration, uint8_t tempo) {
+    // A quarter note (16) lasts 600 ms at TEMPO_DEFAULT, longer as the tempo value grows
+    uint32_t samples = (uint32_t)(duration * tempo * 3.0f * mixer->sample_rate / 8000.0f);
+    return samples ? samples : 1;
+}
+
+static void release_song_voice(audio_mixer_t *mixer) {
+    audio_mixer_song_t *song = &mixer->song;
+    if (song->voice != AUDIO_MIXER_NO_VOICE && mixer->voices[song->voice].song) {
+        mixer->voices[song->voice].stage = AUDIO_MIXER_RELEASE;
+        mixer->voices[song->voice].song  = false;
+    }
+    song->voice = AUDIO_MIXER_NO_VOICE;
+}
+
+void audio_mixer_play_song(audio_mixer_t *mixer, float (*notes)[][2], uint16_t count, bool repeat, uint8_t tempo, float timbre) {
+    release_song_voice(mixer);
+    audio_mixer_song_t *song = &mixer->song;
+    song->notes              = notes;
+    song->count              = count;
+    song->index              = 0;
+    song->remaining          = 0;
+    song->repeat             = repeat;
+    song->tempo              = tempo;
+    song->duty               = timbre_to_duty(timbre);
+    song->playing            = count > 0;
+}
+
+void audio_mixer_stop_song(audio_mixer_t *mixer) {
+    release_song_voice(mixer);
+    mixer->song.playing = false;
+}
+
+bool audio_mixer_song_playing(const audio_mixer_t *mixer) { return mixer->song.playing; }
+
+bool audio_mixer_is_active(const audio_mixer_t *mixer) {
+    if (mixer->song.playing) {
+        return true;
+    }
+    for (uint8_t i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        if (mixer->voices[i].stage != AUDIO_MIXER_IDLE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void next_song_note(audio_mixer_t *mixer) {
+    audio_mixer_song_t *song = &mixer->song;
+    release_song_voice(mixer);
+
+    if (song->index >= song->count) {
+        if (!song->repeat) {
+            song->playing = false;
+            return;
+        }
+        song->index = 0;
+    }
+
+    float frequency = (*song->notes)[song->index][0];
+    song->remaining = audio_mixer_note_samples(mixer, (*song->notes)[song->index][1], song->tempo);
+    song->index++;
+
+    if (frequency > 0) {
+        song->voice                     = start_voice(mixer, frequency, song->duty);
+        mixer->voices[song->voice].song = true;
+    }
+}
+
+static inline void step_envelope(const audio_mixer_t *mixer, audio_mixer_voice_t *voice) {
+    switch (voice->stage) {
+        case AUDIO_MIXER_ATTACK:
+            voice->level += mixer->attack_step;
+            if (voice->level >= LEVEL_FULL) {
+                voice->level = LEVEL_FULL;
+                voice->stage = AUDIO_MIXER_DECAY;
+            }
+            break;
+        case AUDIO_MIXER_DECAY:
+            if (voice->level > LEVEL_SUSTAIN + mixer->decay_step) {
+                voice->level -= mixer->decay_step;
+            } else {
+                voice->level = LEVEL_SUSTAIN;
+                voice->stage = AUDIO_MIXER_SUSTAIN;
+            }
+            break;
+        case AUDIO_MIXER_RELEASE:
+            if (voice->level > mixer->release_step) {
+                voice->level -= mixer->release_step;
+            } else {
+                voice->level = 0;
+                voice->stage = AUDIO_MIXER_IDLE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void render(audio_mixer_t *mixer, uint16_t *samples, size_t count) {
+    const int32_t half = mixer->sample_max / 2;
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t mix = 0;
+        for (uint8_t v = 0; v < AUDIO_MIXER_VOICES; v++) {
+            audio_mixer_voice_t *voice = &mixer->voices[v];
+            if (voice->stage == AUDIO_MIXER_IDLE) {
+                continue;
+            }
+            step_envelope(mixer, voice);
+            int32_t level = voice->level >> 12;
+            mix += (voice->phase >> 16) < voice->duty ? level : -level;
+            voice->phase += voice->increment;
+        }
+
+        int32_t sample = half + mix * half / (AUDIO_MIXER_HEADROOM << 12);
+        if (sample < 0) sample = 0;
+        if (sample > mixer->sample_max) sample = mixer->sample_max;
+        samples[i] = sample;
+    }
+}
+
+void audio_mixer_fill(audio_mixer_t *mixer, uint16_t *samples, size_t count) {
+    audio_mixer_song_t *song = &mixer->song;
+
+    while (count) {
+        size_t chunk = count;
+        if (song->playing) {
+            if (song->remaining == 0) {
+                next_song_note(mixer);
+            }
+            if (song->playing && chunk > song->remaining) {
+                chunk = song->remaining;
+            }
+        }
+
+        render(mixer, samples, chunk);
+        samples += chunk;
+        count -= chunk;
+        if (song->playing) {
+            song->remaining -= chunk;
+        }
+    }
+}
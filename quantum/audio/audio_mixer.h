@@ -0,0 +1,116 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Sample based polyphonic mixer.
+ *
+ * Every voice is a pulse wave with its own integer phase accumulator and a
+ * linear attack/decay/sustain/release envelope. audio_mixer_fill() renders
+ * any number of samples at a fixed rate, so a DMA driven DAC can call it for
+ * each half of a circular buffer and never touch a timer per note. Songs
+ * from play_notes() are sequenced by sample count inside the same call.
+ *
+ * The mixer does no locking, callers serialise audio_mixer_fill() against
+ * the other functions.
+ */
+
+#ifndef AUDIO_MIXER_VOICES
+#    define AUDIO_MIXER_VOICES 8
+#endif
+
+#ifndef AUDIO_MIXER_ATTACK_MS
+#    define AUDIO_MIXER_ATTACK_MS 2
+#endif
+#ifndef AUDIO_MIXER_DECAY_MS
+#    define AUDIO_MIXER_DECAY_MS 50
+#endif
+// Sustain level in percent of full scale
+#ifndef AUDIO_MIXER_SUSTAIN_LEVEL
+#    define AUDIO_MIXER_SUSTAIN_LEVEL 70
+#endif
+#ifndef AUDIO_MIXER_RELEASE_MS
+#    define AUDIO_MIXER_RELEASE_MS 20
+#endif
+
+// Number of full scale voices that fit before the mix clips
+#ifndef AUDIO_MIXER_HEADROOM
+#    define AUDIO_MIXER_HEADROOM 2
+#endif
+
+#define AUDIO_MIXER_NO_VOICE 0xFF
+
+typedef enum {
+    AUDIO_MIXER_IDLE,
+    AUDIO_MIXER_ATTACK,
+    AUDIO_MIXER_DECAY,
+    AUDIO_MIXER_SUSTAIN,
+    AUDIO_MIXER_RELEASE,
+} audio_mixer_stage_t;
+
+typedef struct {
+    uint32_t phase;      // Q0.32 position in the waveform period
+    uint32_t increment;  // Q0.32 phase advance per sample
+    uint32_t level;      // Q8.24 envelope level, 1 << 24 is full scale
+    uint32_t started;    // note on order, the oldest voice is stolen first
+    float    frequency;  // the note this voice plays, used to find it again
+    uint16_t duty;       // Q0.16 part of the period spent high
+    uint8_t  stage;
+    bool     song;
+} audio_mixer_voice_t;
+
+typedef struct {
+    float (*notes)[][2];
+    uint16_t count;
+    uint16_t index;
+    uint32_t remaining;  // samples left of the current note
+    uint16_t duty;
+    uint8_t  voice;
+    uint8_t  tempo;
+    bool     repeat;
+    bool     playing;
+} audio_mixer_song_t;
+
+typedef struct {
+    audio_mixer_voice_t voices[AUDIO_MIXER_VOICES];
+    audio_mixer_song_t  song;
+    uint32_t            sample_rate;
+    uint32_t            started;
+    uint32_t            attack_step;
+    uint32_t            decay_step;
+    uint32_t            release_step;
+    uint16_t            sample_max;
+} audio_mixer_t;
+
+void audio_mixer_init(audio_mixer_t *mixer, uint32_t sample_rate, uint16_t sample_max);
+
+uint8_t audio_mixer_note_on(audio_mixer_t *mixer, float frequency, float timbre);
+void    audio_mixer_note_off(audio_mixer_t *mixer, float frequency);
+void    audio_mixer_all_off(audio_mixer_t *mixer);
+
+void audio_mixer_play_song(audio_mixer_t *mixer, float (*notes)[][2], uint16_t count, bool repeat, uint8_t tempo, float timbre);
+void audio_mixer_stop_song(audio_mixer_t *mixer);
+
+bool audio_mixer_song_playing(const audio_mixer_t *mixer);
+bool audio_mixer_is_active(const audio_mixer_t *mixer);
+
+// Length of a song note in samples, `duration` counts 64ths of a whole note
+uint32_t audio_mixer_note_samples(const audio_mixer_t *mixer, float duration, uint8_t tempo);
+
+void audio_mixer_fill(audio_mixer_t *mixer, uint16_t *samples, size_t count);
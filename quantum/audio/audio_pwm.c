@@ -21,6 +21,7 @@
 #include <avr/io.h>
 #include "print.h"
 #include "audio.h"
+#include "wavetable.h"
 #include "keymap.h"
 
 #include "eeconfig.h"
@@ -94,7 +95,6 @@ uint16_t current_note = 0;
 uint8_t  rest_counter = 0;
 
 #ifdef VIBRATO_ENABLE
-float vibrato_counter  = 0;
 float vibrato_strength = .5;
 float vibrato_rate     = 0.125;
 #endif
@@ -105,7 +105,22 @@ static bool audio_initialized = false;
 
 audio_config_t audio_config;
 
-uint16_t envelope_index = 0;
+#ifndef PWM_AUDIO
+static wavetable_note_t    voice_notes[8];
+static wavetable_note_t    song_note;
+static wavetable_channel_t channel;
+#endif
+
+#ifdef VIBRATO_ENABLE
+// Notes pick up the vibrato settings when they start, see wavetable_note_init()
+static void update_vibrato(void) {
+#    ifdef VIBRATO_STRENGTH_ENABLE
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength);
+#    else
+    wavetable_set_vibrato(vibrato_rate, vibrato_strength > 0 ? 1.0f : 0);
+#    endif
+}
+#endif
 
 void audio_init() {
     // Check EEPROM
@@ -150,6 +165,11 @@ void audio_init() {
     TCCR3A = (0 << COM3A1) | (0 << COM3A0) | (1 << WGM31) | (0 << WGM30);
     TCCR3B = (1 << WGM33) | (1 << WGM32) | (0 << CS32) | (1 << CS31) | (0 << CS30);
 
+    wavetable_channel_init(&channel);
+#    ifdef VIBRATO_ENABLE
+    update_vibrato();
+#    endif
+
 #endif
 
     audio_initialized = true;
@@ -218,25 +238,6 @@ void stop_note(float freq) {
     }
 }
 
-#ifdef VIBRATO_ENABLE
-
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
-
-float vibrato(float average_freq) {
-#    ifdef VIBRATO_STRENGTH_ENABLE
-    float vibrated_freq = average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
-#    else
-    float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
-#    endif
-    vibrato_counter = mod((vibrato_counter + vibrato_rate * (1.0 + 440.0 / average_freq)), VIBRATO_LUT_LENGTH);
-    return vibrated_freq;
-}
-
-#endif
-
 ISR(TIMER3_COMPA_vect) {
     if (playing_note) {
 #ifdef PWM_AUDIO
@@ -286,7 +287,7 @@ ISR(TIMER3_COMPA_vect) {
         }
 #else
         if (voices > 0) {
-            float freq;
+            uint32_t freq;
             if (polyphony_rate > 0) {
                 if (voices > 1) {
                     voice_place %= voices;
@@ -295,43 +296,15 @@ ISR(TIMER3_COMPA_vect) {
                         place       = 0.0;
                     }
                 }
-#    ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequencies[voice_place]);
-                } else {
-#    else
-                {
-#    endif
-                    freq = frequencies[voice_place];
-                }
-            } else {
-                if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440 / frequencies[voices - 1] / 12 / 2)) {
-                    frequency = frequency * pow(2, 440 / frequency / 12 / 2);
-                } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440 / frequencies[voices - 1] / 12 / 2)) {
-                    frequency = frequency * pow(2, -440 / frequency / 12 / 2);
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-#    ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(frequency);
-                } else {
-#    else
-                {
-#    endif
-                    freq = frequency;
-                }
-            }
 
-            if (envelope_index < 65535) {
-                envelope_index++;
+                freq = wavetable_step(&channel, &voice_notes[voice_place], false);
+            } else {
+                freq = wavetable_step(&channel, &voice_notes[voices - 1], true);
             }
-            freq = voice_envelope(freq);
 
-            if (freq < 30.517578125) freq = 30.52;
-            NOTE_PERIOD     = (int)(((double)F_CPU) / (freq * CPU_PRESCALER));                  // Set max to the period
-            NOTE_DUTY_CYCLE = (int)((((double)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);  // Set compare to half the period
+            uint16_t period = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            NOTE_PERIOD     = period;
+            NOTE_DUTY_CYCLE = WAVETABLE_DUTY(period, channel.timbre);
         }
 #endif
     }
@@ -355,25 +328,10 @@ ISR(TIMER3_COMPA_vect) {
         if (place >= SINE_LENGTH) place -= SINE_LENGTH;
 #else
         if (note_frequency > 0) {
-            float freq;
-
-#    ifdef VIBRATO_ENABLE
-            if (vibrato_strength > 0) {
-                freq = vibrato(note_frequency);
-            } else {
-#    else
-            {
-#    endif
-                freq = note_frequency;
-            }
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
-
-            NOTE_PERIOD     = (int)(((double)F_CPU) / (freq * CPU_PRESCALER));                  // Set max to the period
-            NOTE_DUTY_CYCLE = (int)((((double)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);  // Set compare to half the period
+            uint32_t freq   = wavetable_step(&channel, &song_note, false);
+            uint16_t period = WAVETABLE_PERIOD(F_CPU / CPU_PRESCALER, freq);
+            NOTE_PERIOD     = period;
+            NOTE_DUTY_CYCLE = WAVETABLE_DUTY(period, channel.timbre);
         } else {
             NOTE_PERIOD     = 0;
             NOTE_DUTY_CYCLE = 0;
@@ -407,15 +365,19 @@ ISR(TIMER3_COMPA_vect) {
                 note_frequency = 0;
                 note_length    = notes_rest;
                 current_note--;
+#ifndef PWM_AUDIO
+                wavetable_note_init(&song_note, note_frequency);
+#endif
             } else {
                 note_resting = false;
 #ifdef PWM_AUDIO
                 note_frequency = (*notes_pointer)[current_note][0] / SAMPLE_RATE;
                 note_length    = (*notes_pointer)[current_note][1] * (((float)note_tempo) / 100);
 #else
-                envelope_index = 0;
+                wavetable_channel_restart(&channel);
                 note_frequency = (*notes_pointer)[current_note][0];
                 note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
+                wavetable_note_init(&song_note, note_frequency);
 #endif
             }
             note_position = 0;
@@ -441,14 +403,17 @@ void play_note(float freq, int vol) {
 
         playing_note = true;
 
-        envelope_index = 0;
-
 #ifdef PWM_AUDIO
         freq = freq / SAMPLE_RATE;
+#else
+        wavetable_channel_restart(&channel);
 #endif
         if (freq > 0) {
             frequencies[voices] = freq;
-            volumes[voices]     = vol;
+#ifndef PWM_AUDIO
+            wavetable_note_init(&voice_notes[voices], freq);
+#endif
+            volumes[voices] = vol;
             voices++;
         }
 
@@ -488,6 +453,8 @@ void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat, float n_rest)
 #else
         note_frequency = (*notes_pointer)[current_note][0];
         note_length    = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
+        wavetable_note_init(&song_note, note_frequency);
+        wavetable_channel_restart(&channel);
 #endif
         note_position = 0;
 
@@ -538,19 +505,37 @@ void audio_off(void) {
 
 // Vibrato rate functions
 
-void set_vibrato_rate(float rate) { vibrato_rate = rate; }
+void set_vibrato_rate(float rate) {
+    vibrato_rate = rate;
+    update_vibrato();
+}
 
-void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+void increase_vibrato_rate(float change) {
+    vibrato_rate *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+void decrease_vibrato_rate(float change) {
+    vibrato_rate /= change;
+    update_vibrato();
+}
 
 #    ifdef VIBRATO_STRENGTH_ENABLE
 
-void set_vibrato_strength(float strength) { vibrato_strength = strength; }
+void set_vibrato_strength(float strength) {
+    vibrato_strength = strength;
+    update_vibrato();
+}
 
-void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+void increase_vibrato_strength(float change) {
+    vibrato_strength *= change;
+    update_vibrato();
+}
 
-void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+void decrease_vibrato_strength(float change) {
+    vibrato_strength /= change;
+    update_vibrato();
+}
 
 #    endif /* VIBRATO_STRENGTH_ENABLE */
 
@@ -22,6 +22,7 @@
 #    include "ch.h"
 #    include "hal.h"
 #endif
+#include <stdint.h>
 
 #ifndef LUTS_H
 #    define LUTS_H
@@ -31,6 +32,7 @@
 #    define FREQUENCY_LUT_LENGTH 349
 
 extern const float    vibrato_lut[VIBRATO_LUT_LENGTH];
+extern const int16_t  vibrato_delta_lut[VIBRATO_LUT_LENGTH];
 extern const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH];
 
 #endif /* LUTS_H */
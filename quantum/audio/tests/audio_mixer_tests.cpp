@@ -0,0 +1,239 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+extern "C" {
+#include "musical_notes.h"
+#include "audio_mixer.h"
+#include "pcm_renderer.h"
+}
+
+#define SAMPLE_RATE 25000
+#define SAMPLE_MAX 4095
+#define SILENCE (SAMPLE_MAX / 2)
+
+class AudioMixer : public testing::Test {
+   protected:
+    void SetUp() override { audio_mixer_init(&mixer, SAMPLE_RATE, SAMPLE_MAX); }
+
+    std::vector<uint16_t> render(size_t count) {
+        std::vector<uint16_t> samples(count);
+        audio_mixer_fill(&mixer, samples.data(), count);
+        return samples;
+    }
+
+    // Rising edges through the midpoint, one per period of a pulse wave
+    static int rising_edges(const std::vector<uint16_t> &samples) {
+        int edges = 0;
+        for (size_t i = 1; i < samples.size(); i++) {
+            if (samples[i - 1] <= SILENCE && samples[i] > SILENCE) {
+                edges++;
+            }
+        }
+        return edges;
+    }
+
+    audio_mixer_t mixer;
+};
+
+TEST_F(AudioMixer, SilentWhenIdle) {
+    for (uint16_t sample : render(1000)) {
+        ASSERT_EQ(sample, SILENCE);
+    }
+    EXPECT_FALSE(audio_mixer_is_active(&mixer));
+}
+
+TEST_F(AudioMixer, PlaysAtNoteFrequency) {
+    audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    // one second of samples holds one rising edge per period
+    EXPECT_NEAR(rising_edges(render(SAMPLE_RATE)), NOTE_A4, 1);
+}
+
+TEST_F(AudioMixer, MixesVoices) {
+    audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    audio_mixer_note_on(&mixer, NOTE_E5, TIMBRE_50);
+    std::vector<uint16_t> samples = render(SAMPLE_RATE / 5);
+
+    // two in phase pulse waves give three levels once the envelope has settled
+    std::vector<uint16_t> levels;
+    for (size_t i = SAMPLE_RATE / 10; i < samples.size(); i++) {
+        if (std::find(levels.begin(), levels.end(), samples[i]) == levels.end()) {
+            levels.push_back(samples[i]);
+        }
+    }
+    EXPECT_EQ(levels.size(), 3u);
+}
+
+TEST_F(AudioMixer, EnvelopeRisesAndReleasesToSilence) {
+    audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    std::vector<uint16_t> samples = render(SAMPLE_RATE * AUDIO_MIXER_ATTACK_MS / 1000 + SAMPLE_RATE * AUDIO_MIXER_DECAY_MS / 1000 + 100);
+
+    // the first sample is barely above silence, the peak is full scale for one voice
+    EXPECT_LT(abs(samples[0] - SILENCE), SILENCE / AUDIO_MIXER_HEADROOM / 10);
+    uint16_t peak = *std::max_element(samples.begin(), samples.end());
+    EXPECT_NEAR(peak, SILENCE + SILENCE / AUDIO_MIXER_HEADROOM, 2);
+    // and it settles at the sustain level
+    uint16_t sustain = *std::max_element(samples.end() - 100, samples.end());
+    EXPECT_NEAR(sustain, SILENCE + SILENCE / AUDIO_MIXER_HEADROOM * AUDIO_MIXER_SUSTAIN_LEVEL / 100, 2);
+
+    audio_mixer_note_off(&mixer, NOTE_A4);
+    EXPECT_TRUE(audio_mixer_is_active(&mixer));
+    render(SAMPLE_RATE * AUDIO_MIXER_RELEASE_MS / 1000 + 1);
+    EXPECT_FALSE(audio_mixer_is_active(&mixer));
+    for (uint16_t sample : render(100)) {
+        ASSERT_EQ(sample, SILENCE);
+    }
+}
+
+TEST_F(AudioMixer, NoteOffMatchesLatestVoice) {
+    uint8_t first  = audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    uint8_t second = audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    uint8_t other  = audio_mixer_note_on(&mixer, NOTE_C4, TIMBRE_50);
+    ASSERT_NE(first, second);
+
+    audio_mixer_note_off(&mixer, NOTE_A4);
+    EXPECT_EQ(mixer.voices[second].stage, AUDIO_MIXER_RELEASE);
+    EXPECT_EQ(mixer.voices[first].stage, AUDIO_MIXER_ATTACK);
+    EXPECT_EQ(mixer.voices[other].stage, AUDIO_MIXER_ATTACK);
+
+    audio_mixer_note_off(&mixer, NOTE_A4);
+    EXPECT_EQ(mixer.voices[first].stage, AUDIO_MIXER_RELEASE);
+
+    // nothing left to match
+    audio_mixer_note_off(&mixer, NOTE_E5);
+    EXPECT_EQ(mixer.voices[other].stage, AUDIO_MIXER_ATTACK);
+}
+
+TEST_F(AudioMixer, StealsReleasedThenOldestVoice) {
+    uint8_t voices[AUDIO_MIXER_VOICES];
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        voices[i] = audio_mixer_note_on(&mixer, NOTE_C4 + i * 10, TIMBRE_50);
+    }
+    render(10);
+
+    audio_mixer_note_off(&mixer, NOTE_C4 + 30);
+    EXPECT_EQ(audio_mixer_note_on(&mixer, NOTE_A5, TIMBRE_50), voices[3]);
+    // the stolen voice ramps from where it was instead of jumping to zero
+    EXPECT_GT(mixer.voices[voices[3]].level, 0u);
+
+    EXPECT_EQ(audio_mixer_note_on(&mixer, NOTE_B5, TIMBRE_50), voices[0]);
+    EXPECT_EQ(audio_mixer_note_on(&mixer, NOTE_C6, TIMBRE_50), voices[1]);
+}
+
+TEST_F(AudioMixer, ClipsInsteadOfWrapping) {
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        audio_mixer_note_on(&mixer, NOTE_A4, TIMBRE_50);
+    }
+    std::vector<uint16_t> samples = render(SAMPLE_RATE / 50);
+    EXPECT_EQ(*std::max_element(samples.begin(), samples.end()), SAMPLE_MAX);
+    EXPECT_EQ(*std::min_element(samples.begin(), samples.end()), 0);
+}
+
+TEST_F(AudioMixer, SongFollowsTempo) {
+    float song[][2] = {{NOTE_A4, 16}, {NOTE_REST, 16}, {NOTE_C5, 32}};
+    audio_mixer_play_song(&mixer, &song, 3, false, TEMPO_DEFAULT, TIMBRE_50);
+    EXPECT_TRUE(audio_mixer_song_playing(&mixer));
+
+    // a quarter note is 600 ms at the default tempo
+    uint32_t quarter = audio_mixer_note_samples(&mixer, 16, TEMPO_DEFAULT);
+    EXPECT_EQ(quarter, SAMPLE_RATE * 600 / 1000);
+
+    EXPECT_NEAR(rising_edges(render(quarter)), NOTE_A4 * 0.6f, 1);
+    render(quarter);
+    EXPECT_NEAR(rising_edges(render(quarter * 2)), NOTE_C5 * 1.2f, 1);
+    render(1);
+    EXPECT_FALSE(audio_mixer_song_playing(&mixer));
+
+    render(SAMPLE_RATE * AUDIO_MIXER_RELEASE_MS / 1000 + 1);
+    EXPECT_FALSE(audio_mixer_is_active(&mixer));
+}
+
+TEST_F(AudioMixer, RepeatingSongLoops) {
+    float song[][2] = {{NOTE_A4, 1}};
+    audio_mixer_play_song(&mixer, &song, 1, true, TEMPO_DEFAULT, TIMBRE_50);
+    render(audio_mixer_note_samples(&mixer, 1, TEMPO_DEFAULT) * 10);
+    EXPECT_TRUE(audio_mixer_song_playing(&mixer));
+
+    audio_mixer_stop_song(&mixer);
+    EXPECT_FALSE(audio_mixer_song_playing(&mixer));
+}
+
+TEST_F(AudioMixer, KeyNotesPlayOverSong) {
+    float song[][2] = {{NOTE_C4, 64}};
+    audio_mixer_play_song(&mixer, &song, 1, false, TEMPO_DEFAULT, TIMBRE_50);
+    render(10);
+    audio_mixer_note_on(&mixer, NOTE_C4, TIMBRE_50);
+
+    // note_off() leaves the song voice alone even when the frequency matches
+    audio_mixer_note_off(&mixer, NOTE_C4);
+    int playing = 0;
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++) {
+        if (mixer.voices[i].song && mixer.voices[i].stage != AUDIO_MIXER_RELEASE) {
+            playing++;
+        }
+    }
+    EXPECT_EQ(playing, 1);
+}
+
+// Renders in DMA sized halves must match one long render
+TEST_F(AudioMixer, SplitFillMatchesSingleFill) {
+    float song[][2] = {{NOTE_C5, 2}, {NOTE_E5, 2}, {NOTE_REST, 1}, {NOTE_G5, 3}};
+
+    audio_mixer_play_song(&mixer, &song, 4, false, TEMPO_DEFAULT, TIMBRE_50);
+    audio_mixer_note_on(&mixer, NOTE_C4, TIMBRE_25);
+    std::vector<uint16_t> whole = render(SAMPLE_RATE / 2);
+
+    audio_mixer_init(&mixer, SAMPLE_RATE, SAMPLE_MAX);
+    audio_mixer_play_song(&mixer, &song, 4, false, TEMPO_DEFAULT, TIMBRE_50);
+    audio_mixer_note_on(&mixer, NOTE_C4, TIMBRE_25);
+    std::vector<uint16_t> split;
+    while (split.size() < whole.size()) {
+        std::vector<uint16_t> half = render(std::min<size_t>(128, whole.size() - split.size()));
+        split.insert(split.end(), half.begin(), half.end());
+    }
+    EXPECT_EQ(split, whole);
+}
+
+// Renders a chord over a short song and compares it against a known good render.
+// Set QMK_AUDIO_PCM_DIR to write it out as raw s16le 25 kHz mono PCM.
+TEST_F(AudioMixer, GoldenRender) {
+    float song[][2] = {{NOTE_C5, 4}, {NOTE_E5, 4}, {NOTE_G5, 4}, {NOTE_C6, 8}};
+    audio_mixer_play_song(&mixer, &song, 4, false, TEMPO_DEFAULT, TIMBRE_50);
+    audio_mixer_note_on(&mixer, NOTE_C3, TIMBRE_25);
+    audio_mixer_note_on(&mixer, NOTE_G3, TIMBRE_12);
+
+    std::vector<int16_t> pcm;
+    for (uint16_t sample : render(SAMPLE_RATE / 2)) {
+        pcm.push_back((int16_t)((sample - SILENCE) * 8));
+    }
+    audio_mixer_note_off(&mixer, NOTE_C3);
+    audio_mixer_note_off(&mixer, NOTE_G3);
+    for (uint16_t sample : render(SAMPLE_RATE / 10)) {
+        pcm.push_back((int16_t)((sample - SILENCE) * 8));
+    }
+
+    const char *directory = getenv("QMK_AUDIO_PCM_DIR");
+    if (directory) {
+        std::string path = std::string(directory) + "/audio_mixer.pcm";
+        EXPECT_TRUE(pcm_write(path.c_str(), pcm.data(), pcm.size()));
+    }
+    EXPECT_EQ(pcm_hash(pcm.data(), pcm.size()), 0xd071723bu) << std::hex << "renders 0x" << pcm_hash(pcm.data(), pcm.size());
+}
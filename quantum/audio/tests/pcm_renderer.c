@@ -0,0 +1,67 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdio.h>
+#include "pcm_renderer.h"
+
+void pcm_renderer_init(pcm_renderer_t *renderer, uint32_t sample_rate, uint32_t tick_rate, int16_t amplitude) {
+    renderer->sample_rate = sample_rate;
+    renderer->tick_rate   = tick_rate;
+    renderer->amplitude   = amplitude;
+    renderer->phase       = 0;
+    renderer->remainder   = 0;
+}
+
+size_t pcm_render_tick(pcm_renderer_t *renderer, uint32_t frequency, uint16_t timbre, int16_t *out, size_t capacity) {
+    renderer->remainder += renderer->sample_rate;
+    size_t count = renderer->remainder / renderer->tick_rate;
+    renderer->remainder %= renderer->tick_rate;
+    if (count > capacity) {
+        count = capacity;
+    }
+
+    // Q16.16 Hz to Q0.32 period fraction per sample
+    uint32_t step = (uint32_t)(((uint64_t)frequency << 16) / renderer->sample_rate);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (renderer->phase >> 16) < timbre ? renderer->amplitude : -renderer->amplitude;
+        renderer->phase += step;
+    }
+    return count;
+}
+
+uint32_t pcm_hash(const int16_t *samples, size_t count) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t sample = (uint16_t)samples[i];
+        hash            = (hash ^ (sample & 0xFF)) * 16777619UL;
+        hash            = (hash ^ (sample >> 8)) * 16777619UL;
+    }
+    return hash;
+}
+
+bool pcm_write(const char *path, const int16_t *samples, size_t count) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        uint8_t bytes[2] = {(uint8_t)samples[i], (uint8_t)((uint16_t)samples[i] >> 8)};
+        ok               = fwrite(bytes, 1, 2, file) == 2;
+    }
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,42 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Host side PCM renderer for the fixed point note engine in wavetable.c
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t sample_rate;  // output samples per second
+    uint32_t tick_rate;    // wavetable_step() calls per second
+    int16_t  amplitude;
+    uint32_t phase;      // Q0.32 position in the current waveform period
+    uint32_t remainder;  // fraction of a sample carried over between ticks
+} pcm_renderer_t;
+
+void pcm_renderer_init(pcm_renderer_t *renderer, uint32_t sample_rate, uint32_t tick_rate, int16_t amplitude);
+
+// Renders one tick of a pulse wave with the given Q16.16 frequency and Q0.16 duty, returns the sample count
+size_t pcm_render_tick(pcm_renderer_t *renderer, uint32_t frequency, uint16_t timbre, int16_t *out, size_t capacity);
+
+// FNV-1a over the little endian sample bytes
+uint32_t pcm_hash(const int16_t *samples, size_t count);
+
+// Writes raw signed 16-bit little endian mono samples, for listening to a golden render
+bool pcm_write(const char *path, const int16_t *samples, size_t count);
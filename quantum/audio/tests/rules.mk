@@ -0,0 +1,29 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+audio_wavetable_DEFS := -DAUDIO_VOICES
+audio_wavetable_INC := $(QUANTUM_PATH)/audio/tests $(QUANTUM_PATH)/audio
+audio_wavetable_SRC := \
+	$(QUANTUM_PATH)/audio/tests/wavetable_tests.cpp \
+	$(QUANTUM_PATH)/audio/tests/pcm_renderer.c \
+	$(QUANTUM_PATH)/audio/wavetable.c \
+	$(QUANTUM_PATH)/audio/voices.c \
+	$(QUANTUM_PATH)/audio/luts.c
+
+audio_mixer_INC := $(QUANTUM_PATH)/audio/tests $(QUANTUM_PATH)/audio
+audio_mixer_SRC := \
+	$(QUANTUM_PATH)/audio/tests/audio_mixer_tests.cpp \
+	$(QUANTUM_PATH)/audio/tests/pcm_renderer.c \
+	$(QUANTUM_PATH)/audio/audio_mixer.c
@@ -0,0 +1,413 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+extern "C" {
+#include "musical_notes.h"
+#include "voices.h"
+#include "pcm_renderer.h"
+
+extern voice_type voice;
+
+// voices.c zeroes this, it normally lives in audio_avr.c or audio_chibios.c
+float polyphony_rate = 0;
+}
+
+// The state the float voices used to share with the audio ISR
+static uint16_t envelope_index = 0;
+static float    note_timbre    = TIMBRE_DEFAULT;
+static bool     glissando      = true;
+
+// The float voice_envelope() the fixed point voices in voices.c were ported from
+static float reference_voice_envelope(float frequency) {
+    // envelope_index ranges from 0 to 0xFFFF, which is preserved at 880.0 Hz
+    __attribute__((unused)) uint16_t compensated_index = (uint16_t)((float)envelope_index * (880.0 / frequency));
+
+    switch (voice) {
+        case default_voice:
+            glissando      = false;
+            note_timbre    = TIMBRE_50;
+            polyphony_rate = 0;
+            break;
+
+        case something:
+            glissando      = false;
+            polyphony_rate = 0;
+            switch (compensated_index) {
+                case 0 ... 9:
+                    note_timbre = TIMBRE_12;
+                    break;
+
+                case 10 ... 19:
+                    note_timbre = TIMBRE_25;
+                    break;
+
+                case 20 ... 200:
+                    note_timbre = .125 + .125;
+                    break;
+
+                default:
+                    note_timbre = .125;
+                    break;
+            }
+            break;
+
+        case drums:
+            glissando      = false;
+            polyphony_rate = 0;
+
+            if (frequency < 80.0) {
+            } else if (frequency < 160.0) {
+                frequency = (rand() % (int)(40)) + 60;
+                switch (envelope_index) {
+                    case 0 ... 10:
+                        note_timbre = 0.5;
+                        break;
+                    case 11 ... 20:
+                        note_timbre = 0.5 * (21 - envelope_index) / 10;
+                        break;
+                    default:
+                        note_timbre = 0;
+                        break;
+                }
+
+            } else if (frequency < 320.0) {
+                frequency = (rand() % (int)(1000)) + 1000;
+                switch (envelope_index) {
+                    case 0 ... 5:
+                        note_timbre = 0.5;
+                        break;
+                    case 6 ... 20:
+                        note_timbre = 0.5 * (21 - envelope_index) / 15;
+                        break;
+                    default:
+                        note_timbre = 0;
+                        break;
+                }
+
+            } else if (frequency < 640.0) {
+                frequency = (rand() % (int)(2000)) + 3000;
+                switch (envelope_index) {
+                    case 0 ... 15:
+                        note_timbre = 0.5;
+                        break;
+                    case 16 ... 20:
+                        note_timbre = 0.5 * (21 - envelope_index) / 5;
+                        break;
+                    default:
+                        note_timbre = 0;
+                        break;
+                }
+
+            } else if (frequency < 1280.0) {
+                frequency = (rand() % (int)(2000)) + 3000;
+                switch (envelope_index) {
+                    case 0 ... 35:
+                        note_timbre = 0.5;
+                        break;
+                    case 36 ... 50:
+                        note_timbre = 0.5 * (51 - envelope_index) / 15;
+                        break;
+                    default:
+                        note_timbre = 0;
+                        break;
+                }
+            }
+            break;
+        case butts_fader:
+            glissando      = true;
+            polyphony_rate = 0;
+            switch (compensated_index) {
+                case 0 ... 9:
+                    frequency   = frequency / 4;
+                    note_timbre = TIMBRE_12;
+                    break;
+
+                case 10 ... 19:
+                    frequency   = frequency / 2;
+                    note_timbre = TIMBRE_12;
+                    break;
+
+                case 20 ... 200:
+                    note_timbre = .125 - std::pow(((float)compensated_index - 20) / (200 - 20), 2) * .125;
+                    break;
+
+                default:
+                    note_timbre = 0;
+                    break;
+            }
+            break;
+
+        case duty_osc:
+            glissando      = true;
+            polyphony_rate = 0;
+            // triangle wave between .375 and .625
+            note_timbre = (float)std::abs((compensated_index * 10 % 3000) - 1500) * (.25 / 1500) + .375;
+            break;
+
+        case duty_octave_down:
+            glissando      = true;
+            polyphony_rate = 0;
+            note_timbre    = (envelope_index % 2) * .125 + .375 * 2;
+            if ((envelope_index % 4) == 0) note_timbre = 0.5;
+            if ((envelope_index % 8) == 0) note_timbre = 0;
+            break;
+        case delayed_vibrato:
+            glissando      = true;
+            polyphony_rate = 0;
+            note_timbre    = TIMBRE_50;
+            if (compensated_index > 150) {
+                frequency = frequency * vibrato_lut[(int)std::fmod((((float)compensated_index - 151) / 1000 * 50), VIBRATO_LUT_LENGTH)];
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return frequency;
+}
+
+
+// The float per-tick path of the play_note() ISR, kept as the reference for the fixed point engine
+class FloatReference {
+   public:
+    float frequency = 0;
+
+    float step(float target) {
+        if (glissando && frequency != 0 && frequency < target && frequency < target * pow(2, -440 / target / 12 / 2)) {
+            frequency = frequency * pow(2, 440 / frequency / 12 / 2);
+        } else if (glissando && frequency != 0 && frequency > target && frequency > target * pow(2, 440 / target / 12 / 2)) {
+            frequency = frequency * pow(2, -440 / frequency / 12 / 2);
+        } else {
+            frequency = target;
+        }
+
+        if (envelope_index < 65535) {
+            envelope_index++;
+        }
+        float freq = reference_voice_envelope(frequency);
+        if (freq < 30.517578125) {
+            freq = 30.52;
+        }
+        return freq;
+    }
+};
+
+static const char *voice_names[] = {"default_voice", "something", "drums", "butts_fader", "octave_crunch", "duty_osc", "duty_octave_down", "delayed_vibrato"};
+
+class Wavetable : public testing::Test {
+   protected:
+    void SetUp() override {
+        ASSERT_EQ(sizeof(voice_names) / sizeof(voice_names[0]), (size_t)number_of_voices);
+        set_voice(default_voice);
+        envelope_index = 0;
+        note_timbre    = TIMBRE_DEFAULT;
+        glissando      = true;
+        wavetable_set_vibrato(0, 0);
+        wavetable_channel_init(&channel);
+    }
+
+    void TearDown() override { set_voice(default_voice); }
+
+    wavetable_channel_t channel;
+};
+
+TEST_F(Wavetable, MatchesFloatVoices) {
+    const float frequencies[] = {NOTE_A2, NOTE_C4, NOTE_A4, NOTE_E5, NOTE_C6};
+
+    for (int v = 0; v < number_of_voices; v++) {
+        for (float frequency : frequencies) {
+            set_voice((voice_type)v);
+            envelope_index = 0;
+            note_timbre    = TIMBRE_DEFAULT;
+            glissando      = true;
+            FloatReference reference;
+            wavetable_note_t note;
+            wavetable_note_init(&note, frequency);
+            wavetable_channel_init(&channel);
+
+            int mismatches = 0;
+            for (int tick = 0; tick < 400; tick++) {
+                // the drum voice draws from rand(), give both paths the same draw
+                srand(tick);
+                float expected = reference.step(frequency);
+                srand(tick);
+                uint32_t actual = wavetable_step(&channel, &note, true);
+
+                bool frequency_ok = std::fabs(actual / 65536.0f - expected) <= expected * 0.002f + 0.01f;
+                bool timbre_ok    = std::fabs(channel.timbre / 65536.0f - note_timbre) <= 0.002f;
+                if (!frequency_ok || !timbre_ok) {
+                    mismatches++;
+                }
+            }
+            // the compensated index can land on the other side of a step boundary now and then
+            EXPECT_LE(mismatches, 4) << voice_names[v] << " at " << frequency << " Hz";
+        }
+    }
+}
+
+TEST_F(Wavetable, GlidesLikeFloatVoices) {
+    set_voice(duty_osc);
+
+    const float steps[][2] = {{NOTE_A4, NOTE_A5}, {NOTE_A5, NOTE_A4}, {NOTE_C3, NOTE_C5}};
+    for (auto &step : steps) {
+        FloatReference   reference;
+        wavetable_note_t from, to;
+        wavetable_note_init(&from, step[0]);
+        wavetable_note_init(&to, step[1]);
+        wavetable_channel_init(&channel);
+        reference.step(step[0]);
+        wavetable_step(&channel, &from, true);
+
+        int float_ticks = 0, fixed_ticks = 0;
+        while (reference.frequency != step[1] && float_ticks < 1000) {
+            reference.step(step[1]);
+            float_ticks++;
+        }
+        while (channel.frequency != to.frequency && fixed_ticks < 1000) {
+            wavetable_step(&channel, &to, true);
+            fixed_ticks++;
+        }
+        EXPECT_GT(fixed_ticks, 1);
+        EXPECT_NEAR(fixed_ticks, float_ticks, float_ticks / 10 + 1) << step[0] << " -> " << step[1];
+    }
+}
+
+TEST_F(Wavetable, NoGlideWhenNotAsked) {
+    set_voice(duty_osc);
+    wavetable_note_t from, to;
+    wavetable_note_init(&from, NOTE_A4);
+    wavetable_note_init(&to, NOTE_A5);
+    wavetable_step(&channel, &from, true);
+    EXPECT_EQ(wavetable_step(&channel, &to, false), to.frequency);
+}
+
+TEST_F(Wavetable, VibratoStaysWithinTable) {
+    wavetable_set_vibrato(0.125f, 1.0f);
+    wavetable_note_t note;
+    wavetable_note_init(&note, NOTE_A4);
+    ASSERT_NE(note.vibrato_step, 0);
+
+    float lowest = 1e9, highest = 0;
+    for (int tick = 0; tick < 1000; tick++) {
+        float frequency = wavetable_step(&channel, &note, false) / 65536.0f;
+        lowest          = std::min(lowest, frequency);
+        highest         = std::max(highest, frequency);
+    }
+    EXPECT_NEAR(lowest, NOTE_A4 * vibrato_lut[14], 0.05f);
+    EXPECT_NEAR(highest, NOTE_A4 * vibrato_lut[4], 0.05f);
+}
+
+TEST_F(Wavetable, VibratoStrengthScalesDepth) {
+    wavetable_set_vibrato(0.125f, 2.0f);
+    wavetable_note_t note;
+    wavetable_note_init(&note, NOTE_A4);
+
+    float highest = 0;
+    for (int tick = 0; tick < 1000; tick++) {
+        highest = std::max(highest, wavetable_step(&channel, &note, false) / 65536.0f);
+    }
+    EXPECT_NEAR(highest, NOTE_A4 * pow(vibrato_lut[4], 2), 0.05f);
+
+    wavetable_set_vibrato(0.125f, 0);
+    wavetable_note_init(&note, NOTE_A4);
+    EXPECT_EQ(note.vibrato_step, 0);
+}
+
+TEST_F(Wavetable, VoicesDisablePolyphony) {
+    wavetable_note_t note;
+    wavetable_note_init(&note, NOTE_A4);
+    for (int v = 0; v < number_of_voices; v++) {
+        set_voice((voice_type)v);
+        if (v == octave_crunch) {
+            continue;
+        }
+        polyphony_rate = 5;
+        wavetable_step(&channel, &note, false);
+        EXPECT_EQ(polyphony_rate, 0) << voice_names[v];
+    }
+}
+
+TEST_F(Wavetable, ClampsToTimerRange) {
+    set_voice(butts_fader);
+    wavetable_note_t note;
+    wavetable_note_init(&note, NOTE_A2);
+    EXPECT_EQ(wavetable_step(&channel, &note, false), WAVETABLE_MIN_FREQUENCY);
+}
+
+TEST_F(Wavetable, RestartKeepsFrequencyForGlide) {
+    set_voice(duty_osc);
+    wavetable_note_t note;
+    wavetable_note_init(&note, NOTE_A4);
+    for (int tick = 0; tick < 50; tick++) {
+        wavetable_step(&channel, &note, true);
+    }
+    wavetable_channel_restart(&channel);
+    EXPECT_EQ(channel.ticks, 0);
+    EXPECT_EQ(channel.envelope, 0u);
+    EXPECT_EQ(channel.frequency, note.frequency);
+}
+
+TEST_F(Wavetable, TimerPeriodAndDuty) {
+    uint32_t period = WAVETABLE_PERIOD(2000000, WAVETABLE_HZ(NOTE_A4));
+    EXPECT_NEAR(period, 2000000 / NOTE_A4, 1);
+    EXPECT_EQ(WAVETABLE_DUTY(period, WAVETABLE_TIMBRE(TIMBRE_50)), period / 2);
+    EXPECT_EQ(WAVETABLE_DUTY(period, 0), 0);
+}
+
+// Renders a short phrase per voice and compares it against a known good render.
+// Set QMK_AUDIO_PCM_DIR to write the renders out as raw s16le 8 kHz mono PCM.
+TEST_F(Wavetable, GoldenRenders) {
+    const uint32_t golden[] = {
+        0x6c8031c5, 0x8f45d785, 0xfe409905, 0xec064705, 0x95d199c5, 0xedbb6005, 0x60caddc5, 0x8a3cce45,
+    };
+    const float phrase[]    = {NOTE_C4, NOTE_E4, NOTE_G4, NOTE_C5, NOTE_G4, NOTE_C3};
+    const char *directory   = getenv("QMK_AUDIO_PCM_DIR");
+
+    for (int v = 0; v < number_of_voices; v++) {
+        set_voice((voice_type)v);
+        srand(1);
+        wavetable_channel_init(&channel);
+        pcm_renderer_t renderer;
+        pcm_renderer_init(&renderer, 8000, 1000, 8192);
+
+        std::vector<int16_t> pcm;
+        int16_t              samples[16];
+        for (float frequency : phrase) {
+            wavetable_note_t note;
+            wavetable_note_init(&note, frequency);
+            wavetable_channel_restart(&channel);
+            for (int tick = 0; tick < 150; tick++) {
+                uint32_t output = wavetable_step(&channel, &note, true);
+                size_t   count  = pcm_render_tick(&renderer, output, channel.timbre, samples, 16);
+                pcm.insert(pcm.end(), samples, samples + count);
+            }
+        }
+
+        ASSERT_EQ(pcm.size(), 6u * 150 * 8);
+        if (directory) {
+            std::string path = std::string(directory) + "/" + voice_names[v] + ".pcm";
+            EXPECT_TRUE(pcm_write(path.c_str(), pcm.data(), pcm.size()));
+        }
+        EXPECT_EQ(pcm_hash(pcm.data(), pcm.size()), golden[v]) << voice_names[v] << std::hex << " renders 0x" << pcm_hash(pcm.data(), pcm.size());
+    }
+}
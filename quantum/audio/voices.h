@@ -20,11 +20,13 @@
 #endif
 #include "wait.h"
 #include "luts.h"
+#include "wavetable.h"
 
 #ifndef VOICES_H
 #    define VOICES_H
 
-float voice_envelope(float frequency);
+// Sets the channel's timbre and glissando for the selected voice and returns the frequency to play
+uint32_t voice_envelope(wavetable_channel_t *channel, uint32_t frequency);
 
 typedef enum {
     default_voice,
@@ -0,0 +1,113 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include <string.h>
+#include "musical_notes.h"
+#include "wavetable.h"
+#include "voices.h"
+
+/* Glissando moves the frequency by a quarter tone at 440 Hz per tick. The
+ * float ISR multiplied by 2^(440 / f / 24) each tick, which is f + 440 * ln(2) / 24
+ * to first order, so the integer version is a constant step in Hz.
+ */
+#define GLIDE_STEP 832812UL
+
+#define VIBRATO_WRAP ((uint16_t)VIBRATO_LUT_LENGTH << 8)
+
+static const int16_t *vibrato_table = vibrato_delta_lut;
+static int16_t        vibrato_scaled[VIBRATO_LUT_LENGTH];
+static float          note_vibrato_rate = 0;
+
+void wavetable_set_vibrato(float rate, float strength) {
+    if (strength <= 0) {
+        note_vibrato_rate = 0;
+        return;
+    }
+
+    if (strength == 1.0f) {
+        vibrato_table = vibrato_delta_lut;
+    } else {
+        for (uint8_t i = 0; i < VIBRATO_LUT_LENGTH; i++) {
+            float delta = (powf(vibrato_lut[i], strength) - 1.0f) * 65536.0f;
+            if (delta > INT16_MAX) delta = INT16_MAX;
+            if (delta < INT16_MIN) delta = INT16_MIN;
+            vibrato_scaled[i] = (int16_t)delta;
+        }
+        vibrato_table = vibrato_scaled;
+    }
+    note_vibrato_rate = rate;
+}
+
+void wavetable_note_init(wavetable_note_t *note, float frequency) {
+    memset(note, 0, sizeof(wavetable_note_t));
+    if (frequency <= 0) {
+        return;
+    }
+
+    note->frequency    = WAVETABLE_HZ(frequency);
+    note->compensation = (uint32_t)(880.0f * 65536.0f / frequency);
+    if (note_vibrato_rate > 0) {
+        note->vibrato_step = (uint32_t)(note_vibrato_rate * (1.0f + 440.0f / frequency) * 256.0f) % VIBRATO_WRAP;
+    }
+}
+
+void wavetable_channel_init(wavetable_channel_t *channel) {
+    memset(channel, 0, sizeof(wavetable_channel_t));
+    channel->timbre = WAVETABLE_TIMBRE(TIMBRE_DEFAULT);
+    channel->glide  = true;
+}
+
+void wavetable_channel_restart(wavetable_channel_t *channel) {
+    channel->envelope = 0;
+    channel->ticks    = 0;
+}
+
+uint32_t wavetable_step(wavetable_channel_t *channel, const wavetable_note_t *note, bool glide) {
+    uint32_t frequency = note->frequency;
+
+    if (glide && channel->glide && channel->frequency != 0) {
+        if (channel->frequency + GLIDE_STEP < frequency) {
+            frequency = channel->frequency + GLIDE_STEP;
+        } else if (channel->frequency > frequency + GLIDE_STEP) {
+            frequency = channel->frequency - GLIDE_STEP;
+        }
+    }
+    channel->frequency = frequency;
+
+    if (note->vibrato_step) {
+        frequency = wavetable_vibrate(frequency, vibrato_table[channel->vibrato >> 8]);
+        channel->vibrato += note->vibrato_step;
+        if (channel->vibrato >= VIBRATO_WRAP) {
+            channel->vibrato -= VIBRATO_WRAP;
+        }
+    }
+
+    if (channel->ticks < 0xFFFF) {
+        channel->ticks++;
+    }
+    if (channel->envelope < UINT32_MAX - note->compensation) {
+        channel->envelope += note->compensation;
+    } else {
+        channel->envelope = UINT32_MAX;
+    }
+
+    frequency = voice_envelope(channel, frequency);
+
+    if (frequency < WAVETABLE_MIN_FREQUENCY) {
+        frequency = WAVETABLE_MIN_FREQUENCY;
+    }
+    return frequency;
+}
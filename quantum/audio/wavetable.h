@@ -0,0 +1,71 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "luts.h"
+
+/* Fixed point note engine for the audio ISRs.
+ *
+ * Everything that needs a float, a division or pow() is done once per note by
+ * wavetable_note_init(). The per-tick wavetable_step() only advances counters,
+ * reads tables and does a few integer multiplies, so it is cheap enough to run
+ * from interrupt context on AVR and ChibiOS.
+ *
+ * Frequencies are Q16.16 Hz, timbres are Q0.16 duty cycles.
+ */
+
+#define WAVETABLE_HZ(f) ((uint32_t)((f)*65536.0f))
+#define WAVETABLE_TIMBRE(t) ((uint16_t)((t)*65536.0f))
+
+// Lowest frequency the 16-bit audio timers can produce
+#define WAVETABLE_MIN_FREQUENCY WAVETABLE_HZ(30.52f)
+
+// Timer period in clock ticks for a Q16.16 frequency, without overflowing 32 bits
+#define WAVETABLE_PERIOD(clock, frequency) ((((uint32_t)(clock)) << 8) / ((frequency) >> 8))
+// Compare value giving `timbre` duty on a timer with the given period
+#define WAVETABLE_DUTY(period, timbre) ((uint16_t)(((uint32_t)(period) * (timbre)) >> 16))
+
+typedef struct {
+    uint32_t frequency;     // Q16.16 Hz
+    uint32_t compensation;  // Q16.16 envelope steps per tick, 880 Hz / frequency
+    uint16_t vibrato_step;  // Q8.8 vibrato table steps per tick, 0 when vibrato is off
+} wavetable_note_t;
+
+typedef struct {
+    uint32_t frequency;  // Q16.16 Hz after glissando
+    uint32_t envelope;   // Q16.16 frequency compensated envelope index
+    uint16_t ticks;      // raw envelope index
+    uint16_t vibrato;    // Q8.8 vibrato table position
+    uint16_t timbre;     // Q0.16 duty cycle from the last step
+    bool     glide;      // the voice asked for glissando on the last step
+} wavetable_channel_t;
+
+void wavetable_set_vibrato(float rate, float strength);
+
+void wavetable_note_init(wavetable_note_t *note, float frequency);
+
+void wavetable_channel_init(wavetable_channel_t *channel);
+void wavetable_channel_restart(wavetable_channel_t *channel);
+
+uint32_t wavetable_step(wavetable_channel_t *channel, const wavetable_note_t *note, bool glide);
+
+// Applies a Q16 vibrato_delta_lut entry to a Q16.16 frequency
+static inline uint32_t wavetable_vibrate(uint32_t frequency, int16_t delta) {
+    // (frequency >> 10) * delta stays inside 32 bits for any audible frequency
+    return frequency + (((int32_t)(frequency >> 10) * delta) >> 6);
+}
@@ -0,0 +1,79 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "deadline.h"
+#include "timer.h"
+
+#include <stddef.h>
+
+static deadline_t *deadlines = NULL;
+
+static inline int32_t deadline_remaining(const deadline_t *deadline, uint32_t now) { return (int32_t)(deadline->expires - now); }
+
+void deadline_cancel(deadline_t *deadline) {
+    if (!deadline->active) {
+        return;
+    }
+
+    for (deadline_t **link = &deadlines; *link; link = &(*link)->next) {
+        if (*link == deadline) {
+            *link = deadline->next;
+            break;
+        }
+    }
+
+    deadline->next   = NULL;
+    deadline->active = false;
+}
+
+void deadline_set_at(deadline_t *deadline, deadline_callback_t callback, uint32_t expires) {
+    uint32_t now = timer_scan_read32();
+
+    deadline_cancel(deadline);
+    deadline->callback = callback;
+    deadline->expires  = expires;
+    deadline->active   = true;
+
+    // Deadlines with equal expiry fire in the order they were set
+    deadline_t **link      = &deadlines;
+    int32_t      remaining = deadline_remaining(deadline, now);
+    while (*link && deadline_remaining(*link, now) <= remaining) {
+        link = &(*link)->next;
+    }
+    deadline->next = *link;
+    *link          = deadline;
+}
+
+void deadline_set(deadline_t *deadline, deadline_callback_t callback, uint16_t duration) {
+    // The same time base deadline_task() compares against
+    deadline_set_at(deadline, callback, timer_scan_read32() + duration + 1);
+}
+
+bool deadline_is_active(const deadline_t *deadline) { return deadline->active; }
+
+void deadline_task(void) {
+    uint32_t now = timer_scan_read32();
+
+    // Callbacks may set or cancel deadlines, so the head is re-read every time
+    while (deadlines && deadline_remaining(deadlines, now) <= 0) {
+        deadline_t *deadline = deadlines;
+        deadlines            = deadline->next;
+        deadline->next       = NULL;
+        deadline->active     = false;
+        deadline->callback(deadline);
+    }
+}
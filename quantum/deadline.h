@@ -0,0 +1,57 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* One-shot software timers for features that wait on a timeout.
+ *
+ * Armed deadlines are kept in a list ordered by expiry, so deadline_task()
+ * only has to look at the head of the list each scan, regardless of how
+ * many tap dances, combos or leader sequences are in flight. The deadline_t
+ * storage belongs to the caller; embed it in the feature's own state.
+ */
+
+typedef struct deadline_t deadline_t;
+
+typedef void (*deadline_callback_t)(deadline_t *deadline);
+
+struct deadline_t {
+    deadline_t *        next;
+    deadline_callback_t callback;
+    uint32_t            expires;
+    bool                active;
+};
+
+/* Arms the deadline to call callback once more than duration ms have
+ * elapsed since the current scan, i.e. the first scan where
+ * timer_scan_elapsed32(now) > duration. Re-arms the deadline if it was
+ * already active.
+ */
+void deadline_set(deadline_t *deadline, deadline_callback_t callback, uint16_t duration);
+/* Arms the deadline to call callback on the first scan where
+ * timer_scan_read32() has reached expires. A callback that repeats passes its
+ * own deadline->expires plus the period, so late scans don't add up to drift.
+ */
+void deadline_set_at(deadline_t *deadline, deadline_callback_t callback, uint32_t expires);
+void deadline_cancel(deadline_t *deadline);
+bool deadline_is_active(const deadline_t *deadline);
+
+/* Runs the callbacks of all expired deadlines, earliest first. */
+void deadline_task(void);
@@ -106,7 +106,11 @@ void dynamic_keymap_reset(void) {
     for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
         for (int row = 0; row < MATRIX_ROWS; row++) {
             for (int column = 0; column < MATRIX_COLS; column++) {
+#ifdef KEYMAP_COMPRESSION_ENABLE
+                dynamic_keymap_set_keycode(layer, row, column, keymap_compressed_get_keycode(layer, row, column));
+#else
                 dynamic_keymap_set_keycode(layer, row, column, pgm_read_word(&keymaps[layer][row][column]));
+#endif
             }
         }
     }
@@ -16,6 +16,7 @@
  */
 
 #include "encoder.h"
+#include "encoder_decoder.h"
 #ifdef SPLIT_KEYBOARD
 #    include "split_util.h"
 #endif
@@ -42,24 +43,71 @@ static pin_t encoders_pad_b[] = ENCODERS_PAD_B;
 #    define ENCODER_CLOCKWISE false
 #    define ENCODER_COUNTER_CLOCKWISE true
 #endif
-static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
-static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
-static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
+static encoder_decoder_t encoder_decoder[NUMBER_OF_ENCODERS];
 
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
-static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
+static uint8_t            encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
+static encoder_velocity_t encoder_velocity[NUMBER_OF_ENCODERS * 2];
 // row offsets for each hand
 static uint8_t thisHand, thatHand;
 #else
-static uint8_t encoder_value[NUMBER_OF_ENCODERS] = {0};
+static uint8_t            encoder_value[NUMBER_OF_ENCODERS] = {0};
+static encoder_velocity_t encoder_velocity[NUMBER_OF_ENCODERS];
 #endif
 
 __attribute__((weak)) void encoder_update_user(int8_t index, bool clockwise) {}
 
 __attribute__((weak)) void encoder_update_kb(int8_t index, bool clockwise) { encoder_update_user(index, clockwise); }
 
+__attribute__((weak)) bool encoder_steps_user(int8_t index, int8_t steps, uint16_t velocity) { return true; }
+
+__attribute__((weak)) bool encoder_steps_kb(int8_t index, int8_t steps, uint16_t velocity) { return encoder_steps_user(index, steps, velocity); }
+
+static inline uint8_t encoder_read_pins(uint8_t i) { return (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1); }
+
+#ifdef ENCODER_INTERRUPT
+// Encoders whose pins can't raise an interrupt are polled as usual
+static uint8_t encoder_interrupt_driven[NUMBER_OF_ENCODERS] = {0};
+
+static void encoder_pins_changed(void) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        if (encoder_interrupt_driven[i]) {
+            encoder_decoder_update(&encoder_decoder[i], encoder_read_pins(i), ENCODER_RESOLUTION);
+        }
+    }
+}
+
+#    if defined(PROTOCOL_CHIBIOS)
+#        if !defined(PAL_USE_CALLBACKS) || !PAL_USE_CALLBACKS
+#            error "ENCODER_DRIVER = interrupt needs PAL_USE_CALLBACKS set to TRUE in halconf.h"
+#        endif
+
+static void encoder_pin_callback(void *arg) { encoder_pins_changed(); }
+
+static bool encoder_enable_interrupt(pin_t pin) {
+    palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+    palSetLineCallback(pin, encoder_pin_callback, NULL);
+    return true;
+}
+#    elif defined(__AVR__) && defined(PCMSK0)
+// Pin change interrupt 0 covers port B on the ATmega32U4, ATmega32U2, AT90USB and ATmega328P
+ISR(PCINT0_vect) { encoder_pins_changed(); }
+
+static bool encoder_enable_interrupt(pin_t pin) {
+    if ((pin >> PORT_SHIFTER) != PINB_ADDRESS) {
+        return false;
+    }
+    PCMSK0 |= _BV(pin & 0xF);
+    PCICR |= _BV(PCIE0);
+    return true;
+}
+#    else
+#        error "ENCODER_DRIVER = interrupt is not supported on this MCU"
+#    endif
+#endif
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -76,37 +124,60 @@ void encoder_init(void) {
         setPinInputHigh(encoders_pad_a[i]);
         setPinInputHigh(encoders_pad_b[i]);
 
-        encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+        encoder_decoder_init(&encoder_decoder[i], encoder_read_pins(i));
     }
 
+#ifdef ENCODER_INTERRUPT
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        if (encoder_enable_interrupt(encoders_pad_a[i]) && encoder_enable_interrupt(encoders_pad_b[i])) {
+            encoder_interrupt_driven[i] = true;
+        }
+    }
+#endif
+
 #ifdef SPLIT_KEYBOARD
     thisHand = isLeftHand ? 0 : NUMBER_OF_ENCODERS;
     thatHand = NUMBER_OF_ENCODERS - thisHand;
 #endif
 }
 
-static void encoder_update(int8_t index, uint8_t state) {
-    uint8_t i = index;
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
-    if (encoder_pulses[i] >= ENCODER_RESOLUTION) {
-        encoder_value[index]++;
+// delta counts like encoder_value, positive is counter clockwise unless flipped
+static void encoder_update(uint8_t index, int8_t delta) {
+    if (!delta) {
+        return;
+    }
+
+    encoder_value[index] += delta;
+
+    uint16_t velocity = encoder_velocity_update(&encoder_velocity[index], delta, timer_scan_read32());
+    int8_t   steps    = ENCODER_CLOCKWISE ? -delta : delta;
+    if (!encoder_steps_kb(index, steps, velocity)) {
+        return;
+    }
+
+    while (delta > 0) {
+        delta--;
         encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
     }
-    if (encoder_pulses[i] <= -ENCODER_RESOLUTION) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
+    while (delta < 0) {
+        delta++;
         encoder_update_kb(index, ENCODER_CLOCKWISE);
     }
-    encoder_pulses[i] %= ENCODER_RESOLUTION;
 }
 
 void encoder_read(void) {
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        encoder_state[i] <<= 2;
-        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        encoder_update(i, encoder_state[i]);
+#ifdef ENCODER_INTERRUPT
+        if (!encoder_interrupt_driven[i])
+#endif
+        {
+            encoder_decoder_update(&encoder_decoder[i], encoder_read_pins(i), ENCODER_RESOLUTION);
+        }
+        uint8_t index = i;
+#ifdef SPLIT_KEYBOARD
+        index += thisHand;
+#endif
+        encoder_update(index, encoder_decoder_take(&encoder_decoder[i]));
     }
 }
 
@@ -116,17 +187,7 @@ void encoder_state_raw(uint8_t* slave_state) { memcpy(slave_state, &encoder_valu
 void encoder_update_raw(uint8_t* slave_state) {
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
         uint8_t index = i + thatHand;
-        int8_t  delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
-        }
+        encoder_update(index, slave_state[i] - encoder_value[index]);
     }
 }
 #endif
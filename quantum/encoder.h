@@ -25,6 +25,11 @@ void encoder_read(void);
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
 
+// Everything an encoder turned since the last scan, clockwise is positive and velocity is in detents per second.
+// Returning false skips the encoder_update_kb() call for each of the steps.
+bool encoder_steps_kb(int8_t index, int8_t steps, uint16_t velocity);
+bool encoder_steps_user(int8_t index, int8_t steps, uint16_t velocity);
+
 #ifdef SPLIT_KEYBOARD
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
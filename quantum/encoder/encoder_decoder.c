@@ -0,0 +1,71 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "encoder_decoder.h"
+
+static const int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+
+void encoder_decoder_init(encoder_decoder_t *decoder, uint8_t pins) {
+    decoder->state   = pins & 0x3;
+    decoder->pulses  = 0;
+    decoder->counted = 0;
+    decoder->taken   = 0;
+}
+
+void encoder_decoder_update(encoder_decoder_t *decoder, uint8_t pins, uint8_t resolution) {
+    decoder->state = (decoder->state << 2) | (pins & 0x3);
+    decoder->pulses += encoder_LUT[decoder->state & 0xF];
+    if (decoder->pulses >= (int8_t)resolution) {
+        decoder->counted++;
+    }
+    if (decoder->pulses <= -(int8_t)resolution) {
+        decoder->counted--;
+    }
+    decoder->pulses %= (int8_t)resolution;
+}
+
+int8_t encoder_decoder_take(encoder_decoder_t *decoder) {
+    uint8_t counted = decoder->counted;
+    int8_t  steps   = counted - decoder->taken;
+    decoder->taken  = counted;
+    return steps;
+}
+
+uint16_t encoder_velocity_update(encoder_velocity_t *tracker, int8_t steps, uint32_t now) {
+    if (steps == 0) {
+        return tracker->velocity;
+    }
+
+    int8_t   direction = steps > 0 ? 1 : -1;
+    uint32_t elapsed   = now - tracker->last_time;
+    uint32_t count     = steps > 0 ? steps : -steps;
+    bool     turning   = tracker->velocity && direction == tracker->direction && elapsed < ENCODER_VELOCITY_TIMEOUT;
+
+    // A turn that starts or reverses has nothing to measure against yet
+    uint32_t velocity = count * 1000 / (turning ? (elapsed ? elapsed : 1) : ENCODER_VELOCITY_TIMEOUT);
+    if (turning) {
+        // Average with the previous estimate, detents don't come evenly spaced
+        velocity = (velocity + tracker->velocity + 1) / 2;
+    }
+
+    tracker->last_time = now;
+    tracker->direction = direction;
+    tracker->velocity  = velocity > UINT16_MAX ? UINT16_MAX : velocity;
+    if (tracker->velocity == 0) {
+        tracker->velocity = 1;
+    }
+    return tracker->velocity;
+}
@@ -0,0 +1,54 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Quadrature decoding shared by the polled and the interrupt driven backends.
+ *
+ * encoder_decoder_update() is fed every reading of the pins, from the scan
+ * loop or from a pin change interrupt, and keeps a running count of detents.
+ * encoder_decoder_take() runs in the scan loop and returns the detents since
+ * its last call. Each side only writes its own counter and both are a single
+ * byte, so no locking is needed, as long as fewer than 128 detents happen
+ * between two scans.
+ */
+typedef struct {
+    uint8_t          state;    // last two readings, pin A in bit 0 and pin B in bit 1
+    int8_t           pulses;   // transitions since the last detent
+    volatile uint8_t counted;  // written by encoder_decoder_update() only
+    uint8_t          taken;    // written by encoder_decoder_take() only
+} encoder_decoder_t;
+
+void   encoder_decoder_init(encoder_decoder_t *decoder, uint8_t pins);
+void   encoder_decoder_update(encoder_decoder_t *decoder, uint8_t pins, uint8_t resolution);
+int8_t encoder_decoder_take(encoder_decoder_t *decoder);
+
+// Detents per second, a turn that stops for this long starts over from zero
+#ifndef ENCODER_VELOCITY_TIMEOUT
+#    define ENCODER_VELOCITY_TIMEOUT 200
+#endif
+
+typedef struct {
+    uint32_t last_time;
+    uint16_t velocity;
+    int8_t   direction;
+} encoder_velocity_t;
+
+// Called with the steps of every scan that had any, now in milliseconds
+uint16_t encoder_velocity_update(encoder_velocity_t *tracker, int8_t steps, uint32_t now);
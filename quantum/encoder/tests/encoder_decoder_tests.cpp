@@ -0,0 +1,143 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+extern "C" {
+#include "encoder_decoder.h"
+}
+
+// A knob with the usual 4 transitions per detent, turned one transition at a time
+class Knob {
+   public:
+    uint8_t pins() const {
+        static const uint8_t gray[] = {0, 2, 3, 1};
+        return gray[position & 3];
+    }
+    void turn(int transitions) { position += transitions; }
+
+   private:
+    int position = 0;
+};
+
+class EncoderDecoder : public testing::Test {
+   protected:
+    void SetUp() override { encoder_decoder_init(&decoder, knob.pins()); }
+
+    // The pins change, and the interrupt fires
+    void edge(int direction) {
+        knob.turn(direction);
+        encoder_decoder_update(&decoder, knob.pins(), 4);
+    }
+
+    encoder_decoder_t decoder;
+    Knob              knob;
+};
+
+TEST_F(EncoderDecoder, CountsOneDetentEachWay) {
+    for (int i = 0; i < 4; i++) edge(1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), 1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), 0);
+
+    for (int i = 0; i < 4; i++) edge(-1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), -1);
+}
+
+TEST_F(EncoderDecoder, PartialDetentsDontCount) {
+    for (int i = 0; i < 3; i++) edge(1);
+    for (int i = 0; i < 3; i++) edge(-1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), 0);
+}
+
+TEST_F(EncoderDecoder, ContactBounceCancelsOut) {
+    for (int detent = 0; detent < 10; detent++) {
+        for (int i = 0; i < 4; i++) {
+            // Each edge chatters a few times before settling
+            edge(1);
+            edge(-1);
+            edge(1);
+            edge(-1);
+            edge(1);
+        }
+    }
+    EXPECT_EQ(encoder_decoder_take(&decoder), 10);
+}
+
+TEST_F(EncoderDecoder, FastSpinIsNotLostBetweenScans) {
+    // 40 detents within one 20ms scan, an edge every 125us
+    for (int i = 0; i < 40 * 4; i++) edge(1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), 40);
+
+    // The same spin read once per 1ms scan skips edges and can't tell the direction
+    encoder_decoder_t polled;
+    Knob              knob;
+    encoder_decoder_init(&polled, knob.pins());
+    for (int ms = 0; ms < 20; ms++) {
+        knob.turn(8);
+        encoder_decoder_update(&polled, knob.pins(), 4);
+    }
+    EXPECT_NE(encoder_decoder_take(&polled), 40);
+}
+
+TEST_F(EncoderDecoder, ReversalsWithinOneScan) {
+    for (int i = 0; i < 5 * 4; i++) edge(1);
+    for (int i = 0; i < 2 * 4; i++) edge(-1);
+    EXPECT_EQ(encoder_decoder_take(&decoder), 3);
+}
+
+TEST_F(EncoderDecoder, CounterWrapsAround) {
+    int total = 0;
+    for (int scan = 0; scan < 10; scan++) {
+        for (int i = 0; i < 100 * 4; i++) edge(-1);
+        total += encoder_decoder_take(&decoder);
+    }
+    EXPECT_EQ(total, -1000);
+}
+
+TEST(EncoderVelocity, SteadyTurn) {
+    encoder_velocity_t tracker = {};
+    // Nothing to measure against on the first detent
+    EXPECT_EQ(encoder_velocity_update(&tracker, 1, 1000), 1000 / ENCODER_VELOCITY_TIMEOUT);
+
+    uint16_t velocity = 0;
+    for (uint32_t now = 1050; now <= 2000; now += 50) {
+        velocity = encoder_velocity_update(&tracker, 1, now);
+    }
+    EXPECT_EQ(velocity, 20);
+}
+
+TEST(EncoderVelocity, SeveralStepsInOneScan) {
+    encoder_velocity_t tracker = {};
+    encoder_velocity_update(&tracker, -1, 0);
+    uint16_t velocity = 0;
+    for (uint32_t now = 10; now <= 200; now += 10) {
+        velocity = encoder_velocity_update(&tracker, -3, now);
+    }
+    EXPECT_EQ(velocity, 300);
+}
+
+TEST(EncoderVelocity, StartsOverAfterAPauseOrReversal) {
+    encoder_velocity_t tracker = {};
+    for (uint32_t now = 0; now <= 100; now += 10) {
+        encoder_velocity_update(&tracker, 1, now);
+    }
+    EXPECT_GT(tracker.velocity, 50);
+
+    EXPECT_EQ(encoder_velocity_update(&tracker, -1, 110), 1000 / ENCODER_VELOCITY_TIMEOUT);
+    for (uint32_t now = 120; now <= 200; now += 10) {
+        encoder_velocity_update(&tracker, -1, now);
+    }
+    EXPECT_EQ(encoder_velocity_update(&tracker, -1, 200 + ENCODER_VELOCITY_TIMEOUT), 1000 / ENCODER_VELOCITY_TIMEOUT);
+}
@@ -49,7 +49,29 @@ uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
 // translates function id to action
 uint16_t keymap_function_id_to_action(uint16_t function_id);
 
+#ifdef KEYMAP_COMPRESSION_ENABLE
+#    include "matrix.h"
+
+/* Compressed keymap layer, generated by `qmk json2c --compress`.
+ *
+ * Only non-transparent keys are stored. A set bit in presence[row] marks a key
+ * with an entry in keymap_compressed_keycodes[], and offset[row] is the index of
+ * the first entry of that row. Any key without an entry is KC_TRNS.
+ */
+typedef struct {
+    matrix_row_t presence[MATRIX_ROWS];
+    uint16_t     offset[MATRIX_ROWS];
+} keymap_compressed_layer_t;
+
+extern const keymap_compressed_layer_t keymap_compressed_layers[];
+extern const uint16_t                  keymap_compressed_keycodes[];
+extern const uint8_t                   keymap_compressed_layer_count;
+
+// reads a keycode from the compressed keymap in flash
+uint16_t keymap_compressed_get_keycode(uint8_t layer, uint8_t row, uint8_t col);
+#else
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+#endif
 extern const uint16_t fn_actions[];
 
 #endif
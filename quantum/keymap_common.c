@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_macro.h"
 #include "debug.h"
 #include "quantum.h"
+#include "util.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -176,10 +177,44 @@ __attribute__((weak)) const macro_t *action_get_macro(keyrecord_t *record, uint8
 /* Function */
 __attribute__((weak)) void action_function(keyrecord_t *record, uint8_t id, uint8_t opt) {}
 
+#ifdef KEYMAP_COMPRESSION_ENABLE
+#    if (MATRIX_COLS <= 8)
+#        define pgm_read_matrix_row(address_short) pgm_read_byte(address_short)
+#        define matrix_row_bitpop(bits) bitpop(bits)
+#    elif (MATRIX_COLS <= 16)
+#        define pgm_read_matrix_row(address_short) pgm_read_word(address_short)
+#        define matrix_row_bitpop(bits) bitpop16(bits)
+#    else
+#        define pgm_read_matrix_row(address_short) pgm_read_dword(address_short)
+#        define matrix_row_bitpop(bits) bitpop32(bits)
+#    endif
+
+uint16_t keymap_compressed_get_keycode(uint8_t layer, uint8_t row, uint8_t col) {
+    if (layer >= keymap_compressed_layer_count) {
+        return KC_TRNS;
+    }
+
+    const keymap_compressed_layer_t *compressed = &keymap_compressed_layers[layer];
+    matrix_row_t                     presence   = pgm_read_matrix_row(&compressed->presence[row]);
+    matrix_row_t                     mask       = MATRIX_ROW_SHIFTER << col;
+    if (!(presence & mask)) {
+        return KC_TRNS;
+    }
+
+    // Entries of a row are stored in column order, so the index is the number of present keys left of this one
+    uint16_t index = pgm_read_word(&compressed->offset[row]) + matrix_row_bitpop(presence & (mask - 1));
+    return pgm_read_word(&keymap_compressed_keycodes[index]);
+}
+#endif
+
 // translates key to keycode
 __attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+#ifdef KEYMAP_COMPRESSION_ENABLE
+    return keymap_compressed_get_keycode(layer, key.row, key.col);
+#else
     // Read entire word (16bits)
     return pgm_read_word(&keymaps[(layer)][(key.row)][(key.col)]);
+#endif
 }
 
 // translates function id to action
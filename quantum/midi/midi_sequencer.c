@@ -0,0 +1,115 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "midi_sequencer.h"
+
+static uint8_t                  notes[MIDI_SEQUENCER_NOTES];
+static uint8_t                  count;
+static int8_t                   position  = -1;
+static int8_t                   direction = 1;
+static uint8_t                  sounding  = MIDI_SEQUENCER_NO_NOTE;
+static midi_sequencer_pattern_t pattern;
+
+void midi_sequencer_clear(void) {
+    count     = 0;
+    position  = -1;
+    direction = 1;
+}
+
+void midi_sequencer_set_pattern(midi_sequencer_pattern_t new_pattern) { pattern = new_pattern; }
+
+bool midi_sequencer_hold(uint8_t note) {
+    if (count == MIDI_SEQUENCER_NOTES) {
+        return false;
+    }
+
+    uint8_t i = 0;
+    while (i < count && notes[i] < note) {
+        i++;
+    }
+    if (i < count && notes[i] == note) {
+        return false;
+    }
+
+    for (uint8_t j = count; j > i; j--) {
+        notes[j] = notes[j - 1];
+    }
+    notes[i] = note;
+    count++;
+    // Stay on the note that's sounding
+    if (position >= (int8_t)i) {
+        position++;
+    }
+    return true;
+}
+
+bool midi_sequencer_release(uint8_t note) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (notes[i] == note) {
+            count--;
+            for (uint8_t j = i; j < count; j++) {
+                notes[j] = notes[j + 1];
+            }
+            // Keep going from the note that followed the released one
+            if (position >= (int8_t)i) {
+                position--;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t midi_sequencer_held(void) { return count; }
+
+static int8_t next_position(void) {
+    int8_t last = count - 1;
+
+    switch (pattern) {
+        case MIDI_SEQUENCER_DOWN:
+            return position <= 0 || position > last ? last : position - 1;
+        case MIDI_SEQUENCER_UP_DOWN:
+            if (last == 0 || position < 0) {
+                direction = 1;
+                return 0;
+            }
+            if (position > last) {
+                direction = -1;
+                return last;
+            }
+            if (position + direction > last || position + direction < 0) {
+                direction = -direction;
+            }
+            return position + direction;
+        default:
+            return position >= last ? 0 : position + 1;
+    }
+}
+
+bool midi_sequencer_step(uint8_t *note_off, uint8_t *note_on) {
+    *note_off = sounding;
+
+    if (count == 0) {
+        midi_sequencer_clear();
+        sounding = MIDI_SEQUENCER_NO_NOTE;
+        *note_on = MIDI_SEQUENCER_NO_NOTE;
+        return false;
+    }
+
+    position = next_position();
+    sounding = notes[position];
+    *note_on = sounding;
+    return true;
+}
@@ -0,0 +1,54 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Note order for the MIDI arpeggiator
+ *
+ * Keeps the held notes sorted by pitch, and walks through them one step at a
+ * time. It doesn't know about time or USB, process_midi steps it from a
+ * deadline and sends what it returns.
+ */
+
+#ifndef MIDI_SEQUENCER_NOTES
+#    define MIDI_SEQUENCER_NOTES 8
+#endif
+
+#define MIDI_SEQUENCER_NO_NOTE 0xFF
+
+typedef enum {
+    MIDI_SEQUENCER_UP,
+    MIDI_SEQUENCER_DOWN,
+    MIDI_SEQUENCER_UP_DOWN,
+} midi_sequencer_pattern_t;
+
+// Forgets every held note and starts over from the first step, the note that's sounding is left for midi_sequencer_step() to turn off
+void midi_sequencer_clear(void);
+void midi_sequencer_set_pattern(midi_sequencer_pattern_t pattern);
+
+// Returns false if the note is already held or there's no room for it
+bool midi_sequencer_hold(uint8_t note);
+// Returns false if the note wasn't held
+bool midi_sequencer_release(uint8_t note);
+uint8_t midi_sequencer_held(void);
+
+/* Moves to the next step. note_off is set to the note that was sounding and
+ * note_on to the one that sounds now, either may be MIDI_SEQUENCER_NO_NOTE.
+ * Returns false once nothing is held, the sequence is over after that step.
+ */
+bool midi_sequencer_step(uint8_t *note_off, uint8_t *note_on);
@@ -0,0 +1,114 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "midi_sequencer.h"
+}
+
+class MidiSequencer : public testing::Test {
+   protected:
+    void SetUp() override {
+        midi_sequencer_clear();
+        midi_sequencer_set_pattern(MIDI_SEQUENCER_UP);
+        uint8_t off, on;
+        midi_sequencer_step(&off, &on);
+    }
+
+    // The notes turned on by the next steps
+    std::vector<uint8_t> play(int steps) {
+        std::vector<uint8_t> played;
+        for (int i = 0; i < steps; i++) {
+            uint8_t off, on;
+            midi_sequencer_step(&off, &on);
+            played.push_back(on);
+        }
+        return played;
+    }
+};
+
+TEST_F(MidiSequencer, UpPlaysHeldNotesInPitchOrder) {
+    midi_sequencer_hold(67);
+    midi_sequencer_hold(60);
+    midi_sequencer_hold(64);
+    EXPECT_EQ(play(7), std::vector<uint8_t>({60, 64, 67, 60, 64, 67, 60}));
+}
+
+TEST_F(MidiSequencer, Down) {
+    midi_sequencer_set_pattern(MIDI_SEQUENCER_DOWN);
+    midi_sequencer_hold(60);
+    midi_sequencer_hold(64);
+    midi_sequencer_hold(67);
+    EXPECT_EQ(play(5), std::vector<uint8_t>({67, 64, 60, 67, 64}));
+}
+
+TEST_F(MidiSequencer, UpDownDoesNotRepeatTheEnds) {
+    midi_sequencer_set_pattern(MIDI_SEQUENCER_UP_DOWN);
+    midi_sequencer_hold(60);
+    midi_sequencer_hold(64);
+    midi_sequencer_hold(67);
+    EXPECT_EQ(play(7), std::vector<uint8_t>({60, 64, 67, 64, 60, 64, 67}));
+}
+
+TEST_F(MidiSequencer, EachStepTurnsThePreviousNoteOff) {
+    midi_sequencer_hold(60);
+    midi_sequencer_hold(64);
+
+    uint8_t off, on;
+    EXPECT_TRUE(midi_sequencer_step(&off, &on));
+    EXPECT_EQ(off, MIDI_SEQUENCER_NO_NOTE);
+    EXPECT_EQ(on, 60);
+    EXPECT_TRUE(midi_sequencer_step(&off, &on));
+    EXPECT_EQ(off, 60);
+    EXPECT_EQ(on, 64);
+
+    // Releasing everything ends the sequence on the next step
+    midi_sequencer_release(60);
+    midi_sequencer_release(64);
+    EXPECT_FALSE(midi_sequencer_step(&off, &on));
+    EXPECT_EQ(off, 64);
+    EXPECT_EQ(on, MIDI_SEQUENCER_NO_NOTE);
+    EXPECT_FALSE(midi_sequencer_step(&off, &on));
+    EXPECT_EQ(off, MIDI_SEQUENCER_NO_NOTE);
+}
+
+TEST_F(MidiSequencer, ReleaseKeepsThePlace) {
+    midi_sequencer_hold(60);
+    midi_sequencer_hold(64);
+    midi_sequencer_hold(67);
+    EXPECT_EQ(play(2), std::vector<uint8_t>({60, 64}));
+
+    // The note after the released one comes next
+    EXPECT_TRUE(midi_sequencer_release(64));
+    EXPECT_EQ(play(3), std::vector<uint8_t>({67, 60, 67}));
+
+    midi_sequencer_hold(62);
+    EXPECT_EQ(play(3), std::vector<uint8_t>({60, 62, 67}));
+}
+
+TEST_F(MidiSequencer, HoldRejectsDuplicatesAndOverflow) {
+    EXPECT_TRUE(midi_sequencer_hold(60));
+    EXPECT_FALSE(midi_sequencer_hold(60));
+    for (uint8_t note = 61; note < 60 + MIDI_SEQUENCER_NOTES; note++) {
+        EXPECT_TRUE(midi_sequencer_hold(note));
+    }
+    EXPECT_FALSE(midi_sequencer_hold(100));
+    EXPECT_EQ(midi_sequencer_held(), MIDI_SEQUENCER_NOTES);
+
+    EXPECT_FALSE(midi_sequencer_release(100));
+    EXPECT_TRUE(midi_sequencer_release(60));
+    EXPECT_EQ(midi_sequencer_held(), MIDI_SEQUENCER_NOTES - 1);
+}
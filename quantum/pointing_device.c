@@ -25,31 +25,89 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 static report_mouse_t mouseReport = {};
 
+// Motion that hasn't been sent yet, in 1/256 counts
+static int32_t accumulated_x;
+static int32_t accumulated_y;
+static int32_t accumulated_v;
+static int32_t accumulated_h;
+
+static uint8_t  last_buttons;
+static uint32_t next_report;
+
+void pointing_device_move(int16_t x, int16_t y) {
+    accumulated_x += (int32_t)x * POINTING_DEVICE_MOTION_SCALE;
+    accumulated_y += (int32_t)y * POINTING_DEVICE_MOTION_SCALE;
+}
+
+void pointing_device_scroll(int16_t v, int16_t h) {
+    accumulated_v += (int32_t)v * POINTING_DEVICE_SCROLL_SCALE;
+    accumulated_h += (int32_t)h * POINTING_DEVICE_SCROLL_SCALE;
+}
+
+/* Takes the whole counts out of an accumulator, as many as fit in a report.
+ * Division truncates towards zero, so the remainder keeps the sign of the motion.
+ */
+static int16_t take_counts(int32_t *accumulated, int16_t max) {
+    int32_t counts = *accumulated / 256;
+    if (counts > max) {
+        counts = max;
+    } else if (counts < -max) {
+        counts = -max;
+    }
+    *accumulated -= counts * 256;
+    return counts;
+}
+
 __attribute__((weak)) void pointing_device_init(void) {
     // initialize device, if that needs to be done.
 }
 
 __attribute__((weak)) void pointing_device_send(void) {
-    // If you need to do other things, like debugging, this is the place to do it.
-    host_mouse_send(&mouseReport);
-    // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
+    // Whatever was put in the report is added to the accumulators, then 0 it out except for buttons,
+    // so those stay until they are explicity over-ridden using update_pointing_device
+    pointing_device_move(mouseReport.x, mouseReport.y);
+    pointing_device_scroll(mouseReport.v, mouseReport.h);
     mouseReport.x = 0;
     mouseReport.y = 0;
     mouseReport.v = 0;
     mouseReport.h = 0;
+
+    // Buttons go out right away, motion waits for the next report slot
+    uint32_t now     = timer_scan_read32();
+    bool     buttons = mouseReport.buttons != last_buttons;
+    if (!buttons && !timer_expired32(now, next_report)) {
+        return;
+    }
+
+    report_mouse_t report = mouseReport;
+    report.x              = take_counts(&accumulated_x, MOUSE_REPORT_XY_MAX);
+    report.y              = take_counts(&accumulated_y, MOUSE_REPORT_XY_MAX);
+    report.v              = take_counts(&accumulated_v, MOUSE_REPORT_WHEEL_MAX);
+    report.h              = take_counts(&accumulated_h, MOUSE_REPORT_WHEEL_MAX);
+    if (!buttons && !report.x && !report.y && !report.v && !report.h) {
+        // Keep the time close, so it never looks like it is in the future after a wrap
+        next_report = now;
+        return;
+    }
+
+    // If you need to do other things, like debugging, this is the place to do it.
+    host_mouse_send(&report);
+    last_buttons = report.buttons;
+    next_report  = now + POINTING_DEVICE_REPORT_INTERVAL;
 }
 
 __attribute__((weak)) void pointing_device_task(void) {
     // gather info and put it in:
-    // mouseReport.x = 127 max -127 min
-    // mouseReport.y = 127 max -127 min
+    // mouseReport.x = MOUSE_REPORT_XY_MAX max MOUSE_REPORT_XY_MIN min
+    // mouseReport.y = MOUSE_REPORT_XY_MAX max MOUSE_REPORT_XY_MIN min
     // mouseReport.v = 127 max -127 min (scroll vertical)
     // mouseReport.h = 127 max -127 min (scroll horizontal)
     // mouseReport.buttons = 0x1F (decimal 31, binary 00011111) max (bitmask for mouse buttons 1-5, 1 is rightmost, 5 is leftmost) 0x00 min
+    // or call pointing_device_move() and pointing_device_scroll() with larger values
     // send the report
     pointing_device_send();
 }
 
 report_mouse_t pointing_device_get_report(void) { return mouseReport; }
 
-void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = newMouseReport; }
\ No newline at end of file
+void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = newMouseReport; }
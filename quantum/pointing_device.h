@@ -22,10 +22,39 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "report.h"
 
+/* Motion is collected in accumulators with 8 fractional bits, and sent
+ * at most every POINTING_DEVICE_REPORT_INTERVAL milliseconds. Whatever
+ * doesn't fit in a report, or is less than a count, stays in the
+ * accumulators for the next one, so no motion is lost.
+ */
+
+// Counts are multiplied by SCALE/256 on the way in, 256 leaves them as they are
+#ifndef POINTING_DEVICE_MOTION_SCALE
+#    define POINTING_DEVICE_MOTION_SCALE 256
+#endif
+#ifndef POINTING_DEVICE_SCROLL_SCALE
+#    define POINTING_DEVICE_SCROLL_SCALE 256
+#endif
+
+// There is no point in sending reports faster than the host reads them
+#ifndef POINTING_DEVICE_REPORT_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_REPORT_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define POINTING_DEVICE_REPORT_INTERVAL 1
+#    endif
+#endif
+
 void           pointing_device_init(void);
 void           pointing_device_task(void);
 void           pointing_device_send(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t newMouseReport);
 
+/* Adds sensor counts to the accumulators, for sensors that report more
+ * than a mouse report can carry.
+ */
+void pointing_device_move(int16_t x, int16_t y);
+void pointing_device_scroll(int16_t v, int16_t h);
+
 #endif
@@ -26,12 +26,13 @@ extern int      COMBO_LEN;
 
 __attribute__((weak)) void process_combo_event(uint16_t combo_index, bool pressed) {}
 
-static uint16_t timer               = 0;
 static uint16_t current_combo_index = 0;
 static bool     drop_buffer         = false;
 static bool     is_active           = false;
 static bool     b_combo_enable      = true;  // defaults to enabled
 
+static deadline_t combo_deadline;
+
 static uint8_t buffer_size = 0;
 #ifdef COMBO_ALLOW_ACTION_KEYS
 static keyrecord_t key_buffer[MAX_COMBO_LENGTH];
@@ -71,6 +72,16 @@ static inline void dump_key_buffer(bool emit) {
     buffer_size = 0;
 }
 
+static void combo_timeout(deadline_t *deadline) {
+    if (b_combo_enable && is_active) {
+        /* This disables the combo, meaning key events for this
+         * combo will be handled by the next processors in the chain
+         */
+        is_active = false;
+        dump_key_buffer(true);
+    }
+}
+
 #define ALL_COMBO_KEYS_ARE_DOWN (((1 << count) - 1) == combo->state)
 #define KEY_STATE_DOWN(key)         \
     do {                            \
@@ -157,7 +168,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     if (drop_buffer) {
         /* buffer is only dropped when we complete a combo, so we refresh the timer
          * here */
-        timer = timer_read();
+        deadline_set(&combo_deadline, combo_timeout, COMBO_TERM);
         dump_key_buffer(false);
     } else if (!is_combo_key) {
         /* if no combos claim the key we need to emit the keybuffer */
@@ -165,12 +176,12 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
 
         // reset state if there are no combo keys pressed at all
         if (no_combo_keys_pressed) {
-            timer     = 0;
+            deadline_cancel(&combo_deadline);
             is_active = true;
         }
     } else if (record->event.pressed && is_active) {
         /* otherwise the key is consumed and placed in the buffer */
-        timer = timer_read();
+        deadline_set(&combo_deadline, combo_timeout, COMBO_TERM);
 
         if (buffer_size < MAX_COMBO_LENGTH) {
 #ifdef COMBO_ALLOW_ACTION_KEYS
@@ -184,21 +195,11 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     return !is_combo_key;
 }
 
-void matrix_scan_combo(void) {
-    if (b_combo_enable && is_active && timer && timer_elapsed(timer) > COMBO_TERM) {
-        /* This disables the combo, meaning key events for this
-         * combo will be handled by the next processors in the chain
-         */
-        is_active = false;
-        dump_key_buffer(true);
-    }
-}
-
 void combo_enable(void) { b_combo_enable = true; }
 
 void combo_disable(void) {
     b_combo_enable = is_active = false;
-    timer                      = 0;
+    deadline_cancel(&combo_deadline);
     dump_key_buffer(true);
 }
 
@@ -23,6 +23,13 @@
 #        define LEADER_TIMEOUT 300
 #    endif
 
+#    ifdef LEADER_DICTIONARY_ENABLE
+// Trie node layout in leader_dictionary_trie[], generated by `qmk leader2c`
+#        define LEADER_NODE_CHILD_COUNT 0
+#        define LEADER_NODE_ACTION 1
+#        define LEADER_NODE_CHILDREN 2
+#    endif
+
 __attribute__((weak)) void leader_start(void) {}
 
 __attribute__((weak)) void leader_end(void) {}
@@ -31,8 +38,49 @@ __attribute__((weak)) void leader_end(void) {}
 bool     leading     = false;
 uint16_t leader_time = 0;
 
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+uint16_t leader_sequence[LEADER_SEQUENCE_LENGTH] = {0};
+uint8_t  leader_sequence_size                    = 0;
+
+#    ifdef LEADER_DICTIONARY_ENABLE
+static uint16_t   leader_node = 0;
+static deadline_t leader_deadline;
+
+static void leader_finish(void) {
+    deadline_cancel(&leader_deadline);
+    uint16_t action = pgm_read_word(&leader_dictionary_trie[leader_node + LEADER_NODE_ACTION]);
+    leading         = false;
+    if (action) {
+        leader_action_t function = (leader_action_t)pgm_read_ptr(&leader_dictionary_actions[action - 1]);
+        function();
+    }
+    leader_end();
+}
+
+/* Follows the trie edge for keycode from the current node. Fires the
+ * sequence as soon as no longer sequence can match, and aborts as soon as
+ * no sequence starts with the keys typed so far.
+ */
+static void leader_dictionary_step(uint16_t keycode) {
+    uint8_t         child_count = pgm_read_word(&leader_dictionary_trie[leader_node + LEADER_NODE_CHILD_COUNT]);
+    const uint16_t *child       = &leader_dictionary_trie[leader_node + LEADER_NODE_CHILDREN];
+
+    for (uint8_t i = 0; i < child_count; i++, child += 2) {
+        if (pgm_read_word(&child[0]) == keycode) {
+            leader_node = pgm_read_word(&child[1]);
+            if (!pgm_read_word(&leader_dictionary_trie[leader_node + LEADER_NODE_CHILD_COUNT])) {
+                leader_finish();
+            }
+            return;
+        }
+    }
+
+    deadline_cancel(&leader_deadline);
+    leading = false;
+    leader_end();
+}
+
+static void leader_timeout(deadline_t *deadline) { leader_finish(); }
+#    endif
 
 void qk_leader_start(void) {
     if (leading) {
@@ -43,6 +91,10 @@ void qk_leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+#    ifdef LEADER_DICTIONARY_ENABLE
+    leader_node = 0;
+    deadline_set(&leader_deadline, leader_timeout, LEADER_TIMEOUT);
+#    endif
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
@@ -55,6 +107,19 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                     keycode = keycode & 0xFF;
                 }
 #    endif  // LEADER_KEY_STRICT_KEY_PROCESSING
+#    ifdef LEADER_PER_KEY_TIMING
+                leader_time = timer_read();
+#        ifdef LEADER_DICTIONARY_ENABLE
+                deadline_set(&leader_deadline, leader_timeout, LEADER_TIMEOUT);
+#        endif
+#    endif
+#    ifdef LEADER_DICTIONARY_ENABLE
+                if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
+                    leader_sequence[leader_sequence_size] = keycode;
+                    leader_sequence_size++;
+                }
+                leader_dictionary_step(keycode);
+#    else
                 if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
                     leader_sequence[leader_sequence_size] = keycode;
                     leader_sequence_size++;
@@ -62,8 +127,6 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                     leading = false;
                     leader_end();
                 }
-#    ifdef LEADER_PER_KEY_TIMING
-                leader_time = timer_read();
 #    endif
                 return false;
             }
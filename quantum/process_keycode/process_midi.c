@@ -33,9 +33,22 @@ void process_midi_all_notes_off(void) { midi_send_cc(&midi_device, 0, 0x7B, 0);
 #    ifdef MIDI_ADVANCED
 
 #        include "timer.h"
+#        include "midi_sequencer.h"
+
+#        ifndef MIDI_ARPEGGIO_INTERVAL
+#            define MIDI_ARPEGGIO_INTERVAL 125
+#        endif
+
+#        ifndef MIDI_ARPEGGIO_PATTERN
+#            define MIDI_ARPEGGIO_PATTERN MIDI_SEQUENCER_UP
+#        endif
 
 static uint8_t tone_status[MIDI_TONE_COUNT];
 
+static bool       midi_arpeggio;
+static uint8_t    midi_arpeggio_channel;
+static deadline_t midi_arpeggio_deadline;
+
 static uint8_t  midi_modulation;
 static int8_t   midi_modulation_step;
 static uint16_t midi_modulation_timer;
@@ -57,8 +70,35 @@ void midi_init(void) {
     midi_modulation       = 0;
     midi_modulation_step  = 0;
     midi_modulation_timer = 0;
+
+    midi_arpeggio = false;
+    midi_sequencer_set_pattern(MIDI_ARPEGGIO_PATTERN);
+}
+
+static void midi_arpeggio_step(deadline_t *deadline);
+
+// Plays the step due at time and schedules the next one an interval after it
+static void midi_arpeggio_play(uint32_t time) {
+    uint8_t note_off, note_on;
+    bool    running = midi_sequencer_step(&note_off, &note_on);
+
+    // Both land in the same transfer, so the next note follows the last one without a gap
+    if (note_off != MIDI_SEQUENCER_NO_NOTE) {
+        midi_send_noteoff(&midi_device, midi_arpeggio_channel, note_off, 0);
+    }
+    if (note_on != MIDI_SEQUENCER_NO_NOTE) {
+        midi_arpeggio_channel = midi_config.channel;
+        midi_send_noteon(&midi_device, midi_arpeggio_channel, note_on, compute_velocity(midi_config.velocity));
+    }
+
+    // The step after the last release turns the sounding note off
+    if (running) {
+        deadline_set_at(&midi_arpeggio_deadline, midi_arpeggio_step, time + MIDI_ARPEGGIO_INTERVAL);
+    }
 }
 
+static void midi_arpeggio_step(deadline_t *deadline) { midi_arpeggio_play(deadline->expires); }
+
 uint8_t midi_compute_note(uint16_t keycode) { return 12 * midi_config.octave + (keycode - MIDI_TONE_MIN) + midi_config.transpose; }
 
 bool process_midi(uint16_t keycode, keyrecord_t *record) {
@@ -67,14 +107,24 @@ bool process_midi(uint16_t keycode, keyrecord_t *record) {
             uint8_t channel  = midi_config.channel;
             uint8_t tone     = keycode - MIDI_TONE_MIN;
             uint8_t velocity = compute_velocity(midi_config.velocity);
-            if (record->event.pressed) {
+            if (midi_arpeggio && record->event.pressed) {
+                uint8_t note = midi_compute_note(keycode);
+                if (midi_sequencer_hold(note)) {
+                    tone_status[tone] = note;
+                    // The first note starts right away, the rest join the sequence on its next step
+                    if (!deadline_is_active(&midi_arpeggio_deadline)) {
+                        midi_arpeggio_play(timer_scan_read32());
+                    }
+                }
+            } else if (record->event.pressed) {
                 uint8_t note = midi_compute_note(keycode);
                 midi_send_noteon(&midi_device, channel, note, velocity);
                 dprintf("midi noteon channel:%d note:%d velocity:%d\n", channel, note, velocity);
                 tone_status[tone] = note;
             } else {
                 uint8_t note = tone_status[tone];
-                if (note != MIDI_INVALID_NOTE) {
+                // Notes pressed before the arpeggiator was turned on are still sounding
+                if (note != MIDI_INVALID_NOTE && !midi_sequencer_release(note)) {
                     midi_send_noteoff(&midi_device, channel, note, velocity);
                     dprintf("midi noteoff channel:%d note:%d velocity:%d\n", channel, note, velocity);
                 }
@@ -199,6 +249,18 @@ bool process_midi(uint16_t keycode, keyrecord_t *record) {
                 dprintf("midi modulation interval %d\n", midi_config.modulation_interval);
             }
             return false;
+        case MI_ARP:
+            if (record->event.pressed) {
+                midi_arpeggio = !midi_arpeggio;
+                if (!midi_arpeggio) {
+                    // One last step turns the sounding note off
+                    midi_sequencer_clear();
+                    deadline_cancel(&midi_arpeggio_deadline);
+                    midi_arpeggio_play(timer_scan_read32());
+                }
+                dprintf("midi arpeggio %d\n", midi_arpeggio);
+            }
+            return false;
         case MI_BENDD:
             if (record->event.pressed) {
                 midi_send_pitchbend(&midi_device, midi_config.channel, -0x2000);
@@ -222,11 +284,7 @@ bool process_midi(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
-#    endif  // MIDI_ADVANCED
-
-void midi_task(void) {
-    midi_device_process(&midi_device);
-#    ifdef MIDI_ADVANCED
+static void midi_modulation_task(void) {
     if (timer_elapsed(midi_modulation_timer) < midi_config.modulation_interval) return;
     midi_modulation_timer = timer_read();
 
@@ -244,7 +302,17 @@ void midi_task(void) {
 
         if (midi_modulation > 127) midi_modulation = 127;
     }
+}
+
+#    endif  // MIDI_ADVANCED
+
+void midi_task(void) {
+    midi_device_process(&midi_device);
+#    ifdef MIDI_ADVANCED
+    midi_modulation_task();
 #    endif
+    // Everything this scan generated goes out in one transfer
+    midi_queue_flush();
 }
 
 #endif  // MIDI_ENABLE
@@ -18,6 +18,9 @@
 #include "eeprom.h"
 #include "keymap_steno.h"
 #include "virtser.h"
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
 #include <string.h>
 
 // TxBolt Codes
@@ -58,26 +61,30 @@
 #define GEMINI_STATE_SIZE 6
 #define MAX_STATE_SIZE GEMINI_STATE_SIZE
 
-static uint8_t      state[MAX_STATE_SIZE] = {0};
-static uint8_t      chord[MAX_STATE_SIZE] = {0};
-static int8_t       pressed               = 0;
-static steno_mode_t mode;
+static uint8_t           state[MAX_STATE_SIZE] = {0};
+static uint8_t           chord[MAX_STATE_SIZE] = {0};
+static int8_t            pressed               = 0;
+static steno_mode_t      mode;
+static steno_emit_mode_t emit_mode      = STENO_EMIT_MODE;
+static bool              chord_pending  = false;  // keys were pressed since the chord was last sent
+static bool              chord_repeated = false;
+static bool              repeat_armed   = false;
+static uint32_t          repeat_time;
 
 static const uint8_t boltmap[64] PROGMEM = {TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_S_L, TXB_S_L, TXB_T_L, TXB_K_L, TXB_P_L, TXB_W_L, TXB_H_L, TXB_R_L, TXB_A_L, TXB_O_L, TXB_STR, TXB_STR, TXB_NUL, TXB_NUL, TXB_NUL, TXB_STR, TXB_STR, TXB_E_R, TXB_U_R, TXB_F_R, TXB_R_R, TXB_P_R, TXB_B_R, TXB_L_R, TXB_G_R, TXB_T_R, TXB_S_R, TXB_D_R, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_Z_R};
 
+/* Position of each key in the Plover HID key bitmap, counted from the most
+ * significant bit of the first byte: S1- S2- T- K- P- W- H- R- A- O- *1 *2 *3
+ * *4 -E -U -F -R -P -B -L -G -T -S -D -Z #1-#C, then the keys with no steno
+ * meaning as X1-X4. All of them fit in the first MAX_STATE_SIZE bytes.
+ */
+static const uint8_t plover_hid_map[42] PROGMEM = {38, 26, 27, 28, 29, 30, 31, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 39, 40, 41, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 32, 33, 34, 35, 36, 37, 25};
+
 static void steno_clear_state(void) {
     memset(state, 0, sizeof(state));
     memset(chord, 0, sizeof(chord));
-}
-
-static void send_steno_state(uint8_t size, bool send_empty) {
-    for (uint8_t i = 0; i < size; ++i) {
-        if (chord[i] || send_empty) {
-#ifdef VIRTSER_ENABLE
-            virtser_send(chord[i]);
-#endif
-        }
-    }
+    chord_pending = false;
+    repeat_armed  = false;
 }
 
 void steno_init() {
@@ -93,6 +100,13 @@ void steno_set_mode(steno_mode_t new_mode) {
     eeprom_update_byte(EECONFIG_STENOMODE, mode);
 }
 
+void steno_set_emit_mode(steno_emit_mode_t new_emit_mode) {
+    memset(chord, 0, sizeof(chord));
+    chord_pending = false;
+    repeat_armed  = false;
+    emit_mode     = new_emit_mode;
+}
+
 /* override to intercept chords right before they get sent.
  * return zero to suppress normal sending behavior.
  */
@@ -102,22 +116,91 @@ __attribute__((weak)) bool postprocess_steno_user(uint16_t keycode, keyrecord_t
 
 __attribute__((weak)) bool process_steno_user(uint16_t keycode, keyrecord_t *record) { return true; }
 
+// The whole packet goes out in one write, instead of a USB transfer per byte
 static void send_steno_chord(void) {
+    if (mode == STENO_MODE_PLOVER_HID) {
+        // the keys were streamed as they changed
+        return;
+    }
     if (send_steno_chord_user(mode, chord)) {
+        uint8_t packet[MAX_STATE_SIZE + 1];
+        uint8_t size = 0;
         switch (mode) {
             case STENO_MODE_BOLT:
-                send_steno_state(BOLT_STATE_SIZE, false);
-#ifdef VIRTSER_ENABLE
-                virtser_send(0);  // terminating byte
-#endif
+                for (uint8_t i = 0; i < BOLT_STATE_SIZE; ++i) {
+                    if (chord[i]) {
+                        packet[size++] = chord[i];
+                    }
+                }
+                packet[size++] = 0;  // terminating byte
                 break;
             case STENO_MODE_GEMINI:
-                chord[0] |= 0x80;  // Indicate start of packet
-                send_steno_state(GEMINI_STATE_SIZE, true);
+                memcpy(packet, chord, GEMINI_STATE_SIZE);
+                packet[0] |= 0x80;  // Indicate start of packet
+                size = GEMINI_STATE_SIZE;
+                break;
+            default:
                 break;
         }
+#ifdef VIRTSER_ENABLE
+        if (size) {
+            virtser_send_buffer(packet, size);
+        }
+#endif
+    }
+}
+
+#ifdef RAW_ENABLE
+#    ifndef RAW_EPSIZE
+#        define RAW_EPSIZE 32
+#    endif
+
+// The report id and the 64 bit key bitmap of a Plover HID report, padded to a raw HID packet
+static void send_steno_plover_hid(void) {
+    uint8_t packet[RAW_EPSIZE] = {STENO_PLOVER_HID_ID};
+    memcpy(&packet[1], state, MAX_STATE_SIZE);
+    raw_hid_send(packet, RAW_EPSIZE);
+}
+#endif
+
+static void steno_release(void) {
+    bool send;
+    switch (emit_mode) {
+        case STENO_EMIT_FIRST_UP:
+        case STENO_EMIT_PARTIAL:
+            send = chord_pending;
+            break;
+        default:
+            // a chord that went out while held isn't sent once more on release
+            send = pressed == 0 && chord_pending && !chord_repeated;
+            break;
+    }
+    repeat_armed = false;
+    if (send) {
+        send_steno_chord();
+        memset(chord, 0, sizeof(chord));
+        chord_pending = false;
+    }
+    if (pressed == 0) {
+        memset(chord, 0, sizeof(chord));
+        chord_pending = false;
+    }
+}
+
+void steno_task(void) {
+    if (emit_mode != STENO_EMIT_REPEAT || !repeat_armed) {
+        return;
+    }
+    uint32_t now = timer_scan_read32();
+    if (timer_expired32(now, repeat_time)) {
+        send_steno_chord();
+        chord_repeated = true;
+        repeat_time += STENO_REPEAT_INTERVAL;
+        // don't try to catch up after a stall
+        if (timer_expired32(now, repeat_time)) {
+            repeat_time = now + STENO_REPEAT_INTERVAL;
+        }
     }
-    steno_clear_state();
 }
 
 uint8_t *steno_get_state(void) { return &state[0]; }
@@ -147,6 +230,18 @@ static bool update_state_gemini(uint8_t key, bool press) {
     return false;
 }
 
+static bool update_state_plover_hid(uint8_t key, bool press) {
+    uint8_t index = pgm_read_byte(plover_hid_map + key);
+    uint8_t bit   = 0x80 >> (index % 8);
+    if (press) {
+        state[index / 8] |= bit;
+        chord[index / 8] |= bit;
+    } else {
+        state[index / 8] &= ~bit;
+    }
+    return false;
+}
+
 bool process_steno(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
         case QK_STENO_BOLT:
@@ -167,10 +262,23 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
             }
             return false;
 
+        case QK_STENO_PLOVER_HID:
+            if (!process_steno_user(keycode, record)) {
+                return false;
+            }
+            if (IS_PRESSED(record->event)) {
+                steno_set_mode(STENO_MODE_PLOVER_HID);
+            }
+            return false;
+
         case STN__MIN ... STN__MAX:
             if (!process_steno_user(keycode, record)) {
                 return false;
             }
+            if (IS_PRESSED(record->event) && !chord_pending && emit_mode == STENO_EMIT_PARTIAL) {
+                // keys still held after the last chord went out start the next one
+                memcpy(chord, state, sizeof(chord));
+            }
             switch (mode) {
                 case STENO_MODE_BOLT:
                     update_state_bolt(keycode - QK_STENO, IS_PRESSED(record->event));
@@ -178,18 +286,31 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
                 case STENO_MODE_GEMINI:
                     update_state_gemini(keycode - QK_STENO, IS_PRESSED(record->event));
                     break;
+                case STENO_MODE_PLOVER_HID:
+                    update_state_plover_hid(keycode - QK_STENO, IS_PRESSED(record->event));
+                    break;
             }
             // allow postprocessing hooks
             if (postprocess_steno_user(keycode, record, mode, chord, pressed)) {
                 if (IS_PRESSED(record->event)) {
                     ++pressed;
+                    chord_pending  = true;
+                    chord_repeated = false;
+                    repeat_armed   = true;
+                    repeat_time    = timer_scan_read32() + STENO_REPEAT_DELAY;
                 } else {
                     --pressed;
                     if (pressed <= 0) {
                         pressed = 0;
-                        send_steno_chord();
                     }
+                    steno_release();
+                }
+#ifdef RAW_ENABLE
+                if (mode == STENO_MODE_PLOVER_HID) {
+                    // Plover does the chording, every change goes out right away
+                    send_steno_plover_hid();
                 }
+#endif
             }
             return false;
     }
@@ -18,11 +18,38 @@
 
 #include "quantum.h"
 
-typedef enum { STENO_MODE_BOLT, STENO_MODE_GEMINI } steno_mode_t;
+typedef enum { STENO_MODE_BOLT, STENO_MODE_GEMINI, STENO_MODE_PLOVER_HID } steno_mode_t;
+
+/* When a chord is sent over TX Bolt or GeminiPR.
+ * ALL_UP:    once every key is released.
+ * FIRST_UP:  as soon as the first key is released, releasing the rest sends nothing.
+ * PARTIAL:   like FIRST_UP, but keys still held carry over into the next chord.
+ * REPEAT:    like ALL_UP, but a chord held for STENO_REPEAT_DELAY is sent, then
+ *            again every STENO_REPEAT_INTERVAL until a key changes.
+ * Plover HID streams every key change instead, and leaves chording to Plover.
+ */
+typedef enum { STENO_EMIT_ALL_UP, STENO_EMIT_FIRST_UP, STENO_EMIT_PARTIAL, STENO_EMIT_REPEAT } steno_emit_mode_t;
+
+#ifndef STENO_EMIT_MODE
+#    define STENO_EMIT_MODE STENO_EMIT_ALL_UP
+#endif
+
+#ifndef STENO_REPEAT_DELAY
+#    define STENO_REPEAT_DELAY 500
+#endif
+
+#ifndef STENO_REPEAT_INTERVAL
+#    define STENO_REPEAT_INTERVAL 100
+#endif
+
+// First byte of the raw HID packets in Plover HID mode, the report id Plover HID uses
+#define STENO_PLOVER_HID_ID 0x50
 
 bool     process_steno(uint16_t keycode, keyrecord_t *record);
 void     steno_init(void);
+void     steno_task(void);
 void     steno_set_mode(steno_mode_t mode);
+void     steno_set_emit_mode(steno_emit_mode_t emit_mode);
 uint8_t *steno_get_state(void);
 uint8_t *steno_get_chord(void);
 
@@ -15,6 +15,7 @@
  */
 #include "quantum.h"
 #include "action_tapping.h"
+#include <stddef.h>
 
 #ifndef NO_ACTION_ONESHOT
 uint8_t get_oneshot_mods(void);
@@ -103,6 +104,13 @@ static inline void process_tap_dance_action_on_reset(qk_tap_dance_action_t *acti
     send_keyboard_report();
 }
 
+static void tap_dance_timeout(deadline_t *deadline) {
+    qk_tap_dance_action_t *action = (qk_tap_dance_action_t *)((uint8_t *)deadline - offsetof(qk_tap_dance_action_t, deadline));
+
+    process_tap_dance_action_on_dance_finished(action);
+    reset_tap_dance(&action->state);
+}
+
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
     qk_tap_dance_action_t *action;
 
@@ -135,7 +143,8 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
             if (record->event.pressed) {
                 action->state.keycode = keycode;
                 action->state.count++;
-                action->state.timer = timer_read();
+                action->state.timer = timer_scan_read32();
+                deadline_set(&action->deadline, tap_dance_timeout, action->custom_tapping_term > 0 ? action->custom_tapping_term : get_tapping_term(keycode, NULL));
 #ifndef NO_ACTION_ONESHOT
                 action->state.oneshot_mods = get_oneshot_mods();
 #else
@@ -158,24 +167,6 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
-void matrix_scan_tap_dance() {
-    if (highest_td == -1) return;
-    uint16_t tap_user_defined;
-
-    for (uint8_t i = 0; i <= highest_td; i++) {
-        qk_tap_dance_action_t *action = &tap_dance_actions[i];
-        if (action->custom_tapping_term > 0) {
-            tap_user_defined = action->custom_tapping_term;
-        } else {
-            tap_user_defined = get_tapping_term(action->state.keycode, NULL);
-        }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
-            process_tap_dance_action_on_dance_finished(action);
-            reset_tap_dance(&action->state);
-        }
-    }
-}
-
 void reset_tap_dance(qk_tap_dance_state_t *state) {
     qk_tap_dance_action_t *action;
 
@@ -183,6 +174,7 @@ void reset_tap_dance(qk_tap_dance_state_t *state) {
 
     action = &tap_dance_actions[state->keycode - QK_TAP_DANCE];
 
+    deadline_cancel(&action->deadline);
     process_tap_dance_action_on_reset(action);
 
     state->count                = 0;
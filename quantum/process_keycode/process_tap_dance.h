@@ -20,6 +20,7 @@
 
 #    include <stdbool.h>
 #    include <inttypes.h>
+#    include "deadline.h"
 
 typedef struct {
     uint8_t  count;
@@ -27,7 +28,7 @@ typedef struct {
     uint8_t  weak_mods;
     uint16_t keycode;
     uint16_t interrupting_keycode;
-    uint16_t timer;
+    uint32_t timer;
     bool     interrupted;
     bool     pressed;
     bool     finished;
@@ -46,6 +47,7 @@ typedef struct {
     qk_tap_dance_state_t state;
     uint16_t             custom_tapping_term;
     void *               user_data;
+    deadline_t           deadline;
 } qk_tap_dance_action_t;
 
 typedef struct {
@@ -85,7 +87,6 @@ extern qk_tap_dance_action_t tap_dance_actions[];
 
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record);
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record);
-void matrix_scan_tap_dance(void);
 void reset_tap_dance(qk_tap_dance_state_t *state);
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data);
@@ -18,6 +18,9 @@
 #include "eeprom.h"
 #include <ctype.h>
 #include <string.h>
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
 
 unicode_config_t unicode_config;
 uint8_t          unicode_saved_mods;
@@ -171,12 +174,47 @@ void register_hex32(uint32_t hex) {
     }
 }
 
+static bool unicode_in_range(uint32_t code_point) { return code_point <= 0x10FFFF && (code_point <= 0xFFFF || unicode_config.input_mode != UC_WIN); }
+
+#ifdef RAW_ENABLE
+#    ifndef RAW_EPSIZE
+#        define RAW_EPSIZE 32
+#    endif
+
+/* Packs code points into a raw HID packet: the UNICODE_RAW_HID_ID byte,
+ * the number of code points, then each one in 3 bytes, little endian.
+ * Returns how many were sent.
+ */
+static uint8_t send_raw_hid_code_points(const uint32_t *code_points, uint8_t count) {
+    uint8_t packet[RAW_EPSIZE] = {UNICODE_RAW_HID_ID};
+    uint8_t *p                 = &packet[2];
+    if (count > (RAW_EPSIZE - 2) / 3) {
+        count = (RAW_EPSIZE - 2) / 3;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        *p++ = code_points[i];
+        *p++ = code_points[i] >> 8;
+        *p++ = code_points[i] >> 16;
+    }
+    packet[1] = count;
+    raw_hid_send(packet, RAW_EPSIZE);
+    return count;
+}
+#endif
+
 void register_unicode(uint32_t code_point) {
-    if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UC_WIN)) {
+    if (!unicode_in_range(code_point)) {
         // Code point out of range, do nothing
         return;
     }
 
+    if (unicode_config.input_mode == UC_RAWHID) {
+#ifdef RAW_ENABLE
+        send_raw_hid_code_points(&code_point, 1);
+#endif
+        return;
+    }
+
     unicode_input_start();
     if (code_point > 0xFFFF && unicode_config.input_mode == UC_MAC) {
         // Convert code point to UTF-16 surrogate pair on macOS
@@ -265,6 +303,283 @@ void send_unicode_string(const char *str) {
     }
 }
 
+/* Non-blocking output
+ *
+ * Code points wait in a queue and unicode_async_task() sends one report
+ * per UNICODE_REPORT_INTERVAL. Each code point is the start sequence of
+ * the input mode, its hex digits and the finish sequence. Where the
+ * digits allow it, releasing one digit and pressing the next share a
+ * report, and on macOS Option stays down across consecutive code points,
+ * as Unicode Hex Input takes one character for every four digits.
+ */
+
+#define UC_STEP_TAP 0x0000
+#define UC_STEP_DOWN 0x2000
+#define UC_STEP_UP 0x4000
+#define UC_STEP_DELAY 0x6000
+#define UC_STEP_NONE 0xFFFF
+#define UC_STEP_OP(step) ((step)&0xE000)
+#define UC_STEP_ARG(step) ((step)&0x1FFF)
+
+#define UC_SEQUENCE_LENGTH 3
+
+_Static_assert(UNICODE_TYPE_DELAY <= UC_STEP_ARG(0xFFFF), "UNICODE_TYPE_DELAY is too long");
+_Static_assert(UNICODE_QUEUE_SIZE <= UINT8_MAX, "UNICODE_QUEUE_SIZE must fit in a byte");
+
+// Start and finish sequences of each input mode, the same as unicode_input_start() and unicode_input_finish()
+// clang-format off
+static const uint16_t PROGMEM unicode_sequences[UC__COUNT][2][UC_SEQUENCE_LENGTH] = {
+    [UC_MAC]  = {{UC_STEP_DOWN | UNICODE_KEY_MAC, UC_STEP_DELAY | UNICODE_TYPE_DELAY},
+                 {UC_STEP_UP | UNICODE_KEY_MAC}},
+    [UC_LNX]  = {{UNICODE_KEY_LNX, UC_STEP_DELAY | UNICODE_TYPE_DELAY},
+                 {KC_SPC}},
+    [UC_WIN]  = {{UC_STEP_DOWN | KC_LALT, KC_PPLS, UC_STEP_DELAY | UNICODE_TYPE_DELAY},
+                 {UC_STEP_UP | KC_LALT}},
+    [UC_WINC] = {{UNICODE_KEY_WINC, KC_U, UC_STEP_DELAY | UNICODE_TYPE_DELAY},
+                 {KC_ENTER}},
+};
+// clang-format on
+
+enum { ASYNC_IDLE, ASYNC_START, ASYNC_DIGITS, ASYNC_FINISH };
+
+static uint32_t queue[UNICODE_QUEUE_SIZE];
+static uint8_t  queue_first;
+static uint8_t  queue_count;
+
+static uint8_t  phase = ASYNC_IDLE;
+static uint8_t  phase_index;
+static uint8_t  digits[8];
+static uint8_t  digit_count;
+static bool     entry_open;  // the start sequence was sent, the finish sequence not yet
+static bool     mods_saved;
+static uint8_t  saved_mods;
+static uint8_t  held_key;
+static uint8_t  held_mods;
+static uint32_t next_report;
+
+bool unicode_async_busy(void) { return queue_count || phase != ASYNC_IDLE || held_key; }
+
+bool register_unicode_async(uint32_t code_point) {
+    if (queue_count == UNICODE_QUEUE_SIZE) {
+        return false;
+    }
+    if (unicode_in_range(code_point)) {
+        queue[(queue_first + queue_count) % UNICODE_QUEUE_SIZE] = code_point;
+        queue_count++;
+    }
+    return true;
+}
+
+bool send_unicode_string_async(const char *str) {
+    if (!str) {
+        return true;
+    }
+
+    // Stop counting as soon as the string can no longer fit
+    uint8_t room = UNICODE_QUEUE_SIZE - queue_count;
+    for (const char *p = str; *p;) {
+        int32_t code_point;
+        p = decode_utf8(p, &code_point);
+        if (code_point >= 0 && unicode_in_range(code_point)) {
+            if (!room) {
+                return false;
+            }
+            room--;
+        }
+    }
+
+    while (*str) {
+        int32_t code_point;
+        str = decode_utf8(str, &code_point);
+        if (code_point >= 0) {
+            register_unicode_async(code_point);
+        }
+    }
+    return true;
+}
+
+static void add_hex_digits(uint32_t hex) {
+    // At least four digits, like register_hex32()
+    bool started = false;
+    for (int8_t i = 7; i >= 0; i--) {
+        uint8_t digit = (hex >> (i * 4)) & 0xF;
+        if (digit || i <= 3 || started) {
+            digits[digit_count++] = digit;
+            started = true;
+        }
+    }
+}
+
+static void begin_entry(void) {
+    uint32_t code_point = queue[queue_first];
+
+    digit_count = 0;
+    if (code_point > 0xFFFF && unicode_config.input_mode == UC_MAC) {
+        // UTF-16 surrogate pair on macOS
+        code_point -= 0x10000;
+        add_hex_digits((code_point >> 10) + 0xD800);
+        add_hex_digits((code_point & 0x3FF) + 0xDC00);
+    } else {
+        add_hex_digits(code_point);
+    }
+
+    if (!mods_saved) {
+        saved_mods = get_mods();
+        clear_mods();
+        mods_saved = true;
+    }
+    phase       = entry_open ? ASYNC_DIGITS : ASYNC_START;
+    phase_index = 0;
+    entry_open  = true;
+}
+
+/* Returns the next step of the current code point, and moves past it if
+ * advance is set. UC_STEP_NONE means the code point is done.
+ */
+static uint16_t next_step(bool advance) {
+    uint8_t mode = unicode_config.input_mode;
+    while (true) {
+        switch (phase) {
+            case ASYNC_START:
+            case ASYNC_FINISH: {
+                uint16_t step = phase_index < UC_SEQUENCE_LENGTH ? pgm_read_word(&unicode_sequences[mode][phase == ASYNC_FINISH][phase_index]) : 0;
+                if (step) {
+                    if (advance) phase_index++;
+                    return step;
+                }
+                if (phase == ASYNC_FINISH) {
+                    entry_open = false;
+                    return UC_STEP_NONE;
+                }
+                phase       = ASYNC_DIGITS;
+                phase_index = 0;
+                break;
+            }
+            case ASYNC_DIGITS:
+                if (phase_index < digit_count) {
+                    uint16_t step = UC_STEP_TAP | hex_to_keycode(digits[phase_index]);
+                    if (advance) phase_index++;
+                    return step;
+                }
+                if (mode == UC_MAC && queue_count > 1) {
+                    // Option stays down for the next code point
+                    return UC_STEP_NONE;
+                }
+                phase       = ASYNC_FINISH;
+                phase_index = 0;
+                break;
+            default:
+                return UC_STEP_NONE;
+        }
+    }
+}
+
+static uint8_t keycode_mods(uint16_t keycode) {
+    uint8_t mods = (keycode >> 8) & 0xF;
+    return keycode & QK_RMODS_MIN ? mods << 4 : mods;
+}
+
+static void end_entry(void) {
+    queue_first = (queue_first + 1) % UNICODE_QUEUE_SIZE;
+    queue_count--;
+    phase = ASYNC_IDLE;
+    if (!queue_count) {
+        set_mods(saved_mods);
+        send_keyboard_report();
+        mods_saved = false;
+    }
+}
+
+void unicode_async_task(void) {
+    uint32_t now = timer_scan_read32();
+    if (!timer_expired32(now, next_report)) {
+        return;
+    }
+    if (!unicode_async_busy()) {
+        // Keep the time close, so it never looks like it is in the future after a wrap
+        next_report = now;
+        return;
+    }
+    next_report = now + UNICODE_REPORT_INTERVAL;
+
+    if (unicode_config.input_mode == UC_RAWHID) {
+#ifdef RAW_ENABLE
+        uint32_t code_points[UNICODE_QUEUE_SIZE];
+        for (uint8_t i = 0; i < queue_count; i++) {
+            code_points[i] = queue[(queue_first + i) % UNICODE_QUEUE_SIZE];
+        }
+        uint8_t count = send_raw_hid_code_points(code_points, queue_count);
+#else
+        uint8_t count = queue_count;
+#endif
+        queue_first = (queue_first + count) % UNICODE_QUEUE_SIZE;
+        queue_count -= count;
+        return;
+    }
+
+    while (true) {
+        if (phase == ASYNC_IDLE) {
+            if (!queue_count) {
+                return;
+            }
+            begin_entry();
+        }
+
+        uint16_t step = next_step(false);
+        if (step == UC_STEP_NONE && queue_count > 1) {
+            // Move on to the next code point, its first step may share a report with the last one
+            end_entry();
+            continue;
+        }
+
+        if (held_key) {
+            uint8_t keycode = step;
+            if (step != UC_STEP_NONE && UC_STEP_OP(step) == UC_STEP_TAP && keycode != held_key && keycode_mods(step) == held_mods) {
+                // Release the last digit and press the next one in the same report
+                next_step(true);
+                del_key(held_key);
+                add_key(keycode);
+                held_key = keycode;
+            } else {
+                del_key(held_key);
+                del_weak_mods(held_mods);
+                held_key = 0;
+            }
+            send_keyboard_report();
+            return;
+        }
+
+        if (step == UC_STEP_NONE) {
+            end_entry();
+            return;
+        }
+
+        next_step(true);
+        switch (UC_STEP_OP(step)) {
+            case UC_STEP_TAP:
+                held_key  = step;
+                held_mods = keycode_mods(step);
+                if (IS_MOD(held_key)) {
+                    held_mods |= MOD_BIT(held_key);
+                } else {
+                    add_key(held_key);
+                }
+                add_weak_mods(held_mods);
+                send_keyboard_report();
+                return;
+            case UC_STEP_DOWN:
+                register_code16(UC_STEP_ARG(step));
+                return;
+            case UC_STEP_UP:
+                unregister_code16(UC_STEP_ARG(step));
+                return;
+            case UC_STEP_DELAY:
+                next_report = now + UC_STEP_ARG(step);
+                return;
+        }
+    }
+}
+
 // clang-format off
 
 static void audio_helper(void) {
@@ -307,6 +622,11 @@ static void audio_helper(void) {
 // clang-format on
 
 bool process_unicode_common(uint16_t keycode, keyrecord_t *record) {
+    if (mods_saved && !record->event.pressed && IS_MOD(keycode)) {
+        // Released while typing, so don't bring it back afterwards
+        saved_mods &= ~MOD_BIT(keycode);
+    }
+
     if (record->event.pressed) {
         bool shifted = get_mods() & MOD_MASK_SHIFT;
         switch (keycode) {
@@ -49,6 +49,25 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+// Code points that can wait in the queue of the non-blocking functions
+#ifndef UNICODE_QUEUE_SIZE
+#    define UNICODE_QUEUE_SIZE 16
+#endif
+
+// Time between two reports sent by the non-blocking functions, in ms
+#ifndef UNICODE_REPORT_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define UNICODE_REPORT_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define UNICODE_REPORT_INTERVAL 10
+#    endif
+#endif
+
+// First byte of the raw HID packets sent in UC_RAWHID mode
+#ifndef UNICODE_RAW_HID_ID
+#    define UNICODE_RAW_HID_ID 0x55
+#endif
+
 // Deprecated aliases
 #if !defined(UNICODE_KEY_MAC) && defined(UNICODE_KEY_OSX)
 #    define UNICODE_KEY_MAC UNICODE_KEY_OSX
@@ -64,6 +83,7 @@ enum unicode_input_modes {
     UC_WIN,    // Windows using EnableHexNumpad
     UC_BSD,    // BSD (not implemented)
     UC_WINC,   // Windows using WinCompose (https://github.com/samhocevar/wincompose)
+    UC_RAWHID, // Any OS, code points go over raw HID to a program that types them
     UC__COUNT  // Number of available input modes (always leave at the end)
 };
 
@@ -94,6 +114,17 @@ void register_unicode(uint32_t code_point);
 void send_unicode_hex_string(const char *str);
 void send_unicode_string(const char *str);
 
+/* Non-blocking versions of register_unicode() and send_unicode_string().
+ * The code points are queued and typed from the scan loop, one report at
+ * a time. They return false, and queue nothing, if there is not enough
+ * room. unicode_input_start() and unicode_input_finish() are not used,
+ * the sequences of each input mode are built in.
+ */
+bool register_unicode_async(uint32_t code_point);
+bool send_unicode_string_async(const char *str);
+bool unicode_async_busy(void);
+void unicode_async_task(void);
+
 bool process_unicode_common(uint16_t keycode, keyrecord_t *record);
 
 #define UC_BSPC UC(0x0008)
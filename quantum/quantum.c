@@ -177,6 +177,39 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
+typedef bool (*process_record_handler_t)(uint16_t keycode, keyrecord_t *record);
+
+typedef struct {
+    process_record_handler_t handler;
+    uint16_t                 first;
+    uint16_t                 last;
+} process_record_dispatch_t;
+
+// Every handler with the keycode range it acts on, in calling order
+#define PROCESS_RECORD_ANY_KEYCODE(handler) {handler, 0x0000, 0xFFFF},
+#define PROCESS_RECORD_KEYCODE_RANGE(handler, first, last) {handler, first, last},
+static const process_record_dispatch_t PROGMEM process_record_handlers[] = {
+#include "process_record_handlers.inc"
+};
+#undef PROCESS_RECORD_ANY_KEYCODE
+#undef PROCESS_RECORD_KEYCODE_RANGE
+
+// The handlers that see basic keycodes, in calling order
+#define PROCESS_RECORD_ANY_KEYCODE(handler) handler,
+#define PROCESS_RECORD_KEYCODE_RANGE(handler, first, last)
+static const process_record_handler_t PROGMEM process_record_basic_handlers[] = {
+#include "process_record_handlers.inc"
+};
+#undef PROCESS_RECORD_ANY_KEYCODE
+#undef PROCESS_RECORD_KEYCODE_RANGE
+
+// Basic keycodes skip the ranged handlers, so none of the ranges may include them
+#define PROCESS_RECORD_ANY_KEYCODE(handler)
+#define PROCESS_RECORD_KEYCODE_RANGE(handler, first, last) _Static_assert((first) > QK_BASIC_MAX, #handler " must be registered with PROCESS_RECORD_ANY_KEYCODE");
+#include "process_record_handlers.inc"
+#undef PROCESS_RECORD_ANY_KEYCODE
+#undef PROCESS_RECORD_KEYCODE_RANGE
+
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
@@ -207,82 +240,33 @@ bool process_record_quantum(keyrecord_t *record) {
     preprocess_tap_dance(keycode, record);
 #endif
 
-    if (!(
 #if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
-#if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
-#endif
-#if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
-#endif  // AUDIO_CLICKY
-#ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
-#endif  // HAPTIC_ENABLE
-#if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
-#endif
-#if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
-#endif
-            process_record_kb(keycode, record) &&
-#if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
-#endif
-#ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
-#endif
-#ifdef BACKLIGHT_ENABLE
-            process_backlight(keycode, record) &&
-#endif
-#ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
-#endif
-#if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
-#endif
-#ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
-#endif
-#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
-#endif
-#ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
-#endif
-#ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
-#endif
-#ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
-#endif
-#ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
-#endif
-#ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
-#endif
-#ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
-#endif
-#ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
-#endif
-#ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
-#endif
-#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
-#endif
-#ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
-#endif
-            true)) {
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
         return false;
     }
+#endif
+
+    if (keycode <= QK_BASIC_MAX) {
+        // Only handlers registered for any keycode can act on basic keycodes
+        for (uint8_t i = 0; i < sizeof(process_record_basic_handlers) / sizeof(process_record_basic_handlers[0]); i++) {
+            process_record_handler_t handler = (process_record_handler_t)pgm_read_ptr(&process_record_basic_handlers[i]);
+            if (!handler(keycode, record)) {
+                return false;
+            }
+        }
+    } else {
+        for (uint8_t i = 0; i < sizeof(process_record_handlers) / sizeof(process_record_handlers[0]); i++) {
+            const process_record_dispatch_t *dispatch = &process_record_handlers[i];
+            if (keycode < pgm_read_word(&dispatch->first) || keycode > pgm_read_word(&dispatch->last)) {
+                continue;
+            }
+            process_record_handler_t handler = (process_record_handler_t)pgm_read_ptr(&dispatch->handler);
+            if (!handler(keycode, record)) {
+                return false;
+            }
+        }
+    }
 
     if (record->event.pressed) {
         switch (keycode) {
@@ -633,13 +617,7 @@ void matrix_scan_quantum() {
     matrix_scan_music();
 #endif
 
-#ifdef TAP_DANCE_ENABLE
-    matrix_scan_tap_dance();
-#endif
-
-#ifdef COMBO_ENABLE
-    matrix_scan_combo();
-#endif
+    deadline_task();
 
 #ifdef LED_MATRIX_ENABLE
     led_matrix_task();
@@ -653,6 +631,18 @@ void matrix_scan_quantum() {
     decay_wpm();
 #endif
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_task();
+#endif
+
+#ifdef STENO_ENABLE
+    steno_task();
+#endif
+
+#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
+    unicode_async_task();
+#endif
+
 #ifdef HAPTIC_ENABLE
     haptic_task();
 #endif
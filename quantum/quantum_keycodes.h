@@ -70,10 +70,11 @@ enum quantum_keycodes {
     QK_LAYER_MOD            = 0x5900,
     QK_LAYER_MOD_MAX        = 0x59FF,
 #ifdef STENO_ENABLE
-    QK_STENO        = 0x5A00,
-    QK_STENO_BOLT   = 0x5A30,
-    QK_STENO_GEMINI = 0x5A31,
-    QK_STENO_MAX    = 0x5A3F,
+    QK_STENO            = 0x5A00,
+    QK_STENO_BOLT       = 0x5A30,
+    QK_STENO_GEMINI     = 0x5A31,
+    QK_STENO_PLOVER_HID = 0x5A32,
+    QK_STENO_MAX        = 0x5A3F,
 #endif
 #ifdef SWAP_HANDS_ENABLE
     QK_SWAP_HANDS     = 0x5B00,
@@ -390,6 +391,8 @@ enum quantum_keycodes {
     MI_MODSD,  // decrease modulation speed
     MI_MODSU,  // increase modulation speed
 
+    MI_ARP,  // toggle the arpeggiator
+
     MI_BENDD,  // Bend down
     MI_BENDU,  // Bend up
 #endif         // MIDI_ADVANCED
@@ -0,0 +1,232 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include "quantum.h"
+#include "send_string_async.h"
+
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+extern float bell_song[][2];
+#endif
+
+_Static_assert(SEND_STRING_ASYNC_QUEUE_SIZE <= UINT8_MAX, "SEND_STRING_ASYNC_QUEUE_SIZE must fit in a byte");
+_Static_assert(SEND_STRING_ASYNC_BUFFER_SIZE <= UINT8_MAX, "SEND_STRING_ASYNC_BUFFER_SIZE must fit in a byte");
+
+typedef struct {
+    const char *str;  // position in a PROGMEM string, NULL if the string is in the buffer
+    uint8_t     interval;
+} send_string_job_t;
+
+static send_string_job_t jobs[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t           job_first;
+static uint8_t           job_count;
+
+// Copies of RAM strings, in the order of their jobs
+static char    buffer[SEND_STRING_ASYNC_BUFFER_SIZE];
+static uint8_t buffer_first;
+static uint8_t buffer_used;
+
+static uint32_t next_report;
+
+// What the next report has to release, a tapped keycode or a character
+static uint8_t release_keycode;
+static uint8_t release_mods;
+static bool    release_pending;
+static bool    release_tap;
+
+static bool queue_job(const char *str, uint8_t interval) {
+    if (job_count == SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+    send_string_job_t *job = &jobs[(job_first + job_count) % SEND_STRING_ASYNC_QUEUE_SIZE];
+    job->str               = str;
+    job->interval          = interval;
+    job_count++;
+    return true;
+}
+
+bool send_string_async_with_delay(const char *str, uint8_t interval) {
+    size_t length = strlen(str) + 1;
+    if (length > SEND_STRING_ASYNC_BUFFER_SIZE - buffer_used || job_count == SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        buffer[(buffer_first + buffer_used + i) % SEND_STRING_ASYNC_BUFFER_SIZE] = str[i];
+    }
+    buffer_used += length;
+    return queue_job(NULL, interval);
+}
+
+bool send_string_async_with_delay_P(const char *str, uint8_t interval) { return queue_job(str, interval); }
+
+bool send_string_async(const char *str) { return send_string_async_with_delay(str, 0); }
+
+bool send_string_async_P(const char *str) { return send_string_async_with_delay_P(str, 0); }
+
+bool send_string_async_busy(void) { return job_count || release_pending; }
+
+/* Reads the next byte of the current job. Once it returned the terminator
+ * the job is finished and must not be read any further.
+ */
+static uint8_t next_byte(void) {
+    send_string_job_t *job = &jobs[job_first];
+    uint8_t            c;
+    if (job->str) {
+        c = pgm_read_byte(job->str++);
+    } else {
+        c            = buffer[buffer_first];
+        buffer_first = (buffer_first + 1) % SEND_STRING_ASYNC_BUFFER_SIZE;
+        buffer_used--;
+    }
+    if (!c) {
+        job_first = (job_first + 1) % SEND_STRING_ASYNC_QUEUE_SIZE;
+        job_count--;
+    }
+    return c;
+}
+
+static void release(void) {
+    if (release_tap) {
+        unregister_code(release_keycode);
+    } else {
+        del_key(release_keycode);
+        del_weak_mods(release_mods);
+        send_keyboard_report();
+    }
+    release_pending = false;
+}
+
+static void press_char(uint8_t ascii_code) {
+    uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[ascii_code]);
+    uint8_t mods    = 0;
+    if ((pgm_read_byte(&ascii_to_shift_lut[ascii_code / 8]) >> (ascii_code % 8)) & 1) {
+        mods |= MOD_BIT(KC_LSFT);
+    }
+    if ((pgm_read_byte(&ascii_to_altgr_lut[ascii_code / 8]) >> (ascii_code % 8)) & 1) {
+        mods |= MOD_BIT(KC_RALT);
+    }
+
+    // The modifiers go out with the key, a HID host applies them together
+    add_weak_mods(mods);
+    add_key(keycode);
+    send_keyboard_report();
+
+    release_keycode = keycode;
+    release_mods    = mods;
+    release_tap     = false;
+    release_pending = true;
+}
+
+/* Sends at most one report, or starts a delay. Returns false if it did
+ * neither, because the job ended or the character has no key.
+ */
+static bool play_next(void) {
+    uint8_t c = next_byte();
+    if (!c) {
+        return false;
+    }
+
+    if (c != SS_QMK_PREFIX) {
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+        if (c == '\a') {
+            PLAY_SONG(bell_song);
+            return false;
+        }
+#endif
+        if (c >= 128 || pgm_read_byte(&ascii_to_keycode_lut[c]) == KC_NO) {
+            return false;
+        }
+        press_char(c);
+        return true;
+    }
+
+    uint8_t code = next_byte();
+    if (!code) {
+        return false;
+    }
+    if (code == SS_DELAY_CODE) {
+        uint16_t ms = 0;
+        uint8_t  digit;
+        while (isdigit(digit = next_byte())) {
+            ms = ms * 10 + digit - '0';
+        }
+        if (!digit) {
+            return false;
+        }
+        next_report = timer_scan_read32() + ms;
+        return true;
+    }
+
+    uint8_t keycode = next_byte();
+    if (!keycode) {
+        return false;
+    }
+    switch (code) {
+        case SS_TAP_CODE:
+            register_code(keycode);
+            release_keycode = keycode;
+            release_tap     = true;
+            release_pending = true;
+            break;
+        case SS_DOWN_CODE:
+            register_code(keycode);
+            break;
+        case SS_UP_CODE:
+            unregister_code(keycode);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void send_string_async_task(void) {
+    uint32_t now = timer_scan_read32();
+    if (!timer_expired32(now, next_report)) {
+        return;
+    }
+    if (!send_string_async_busy()) {
+        // Keep the time close, so it never looks like it is in the future after a wrap
+        next_report = now;
+        return;
+    }
+
+    next_report = now + SEND_STRING_ASYNC_REPORT_INTERVAL;
+    if (release_pending) {
+        uint8_t interval = job_count ? jobs[job_first].interval : 0;
+        release();
+        next_report += interval;
+        return;
+    }
+    while (job_count) {
+        uint8_t interval = jobs[job_first].interval;
+        if (play_next()) {
+            if (!release_pending) {
+                next_report += interval;
+            }
+            return;
+        }
+    }
+}
+
+void send_string_async_cancel(void) {
+    if (release_pending) {
+        release();
+    }
+    job_first = job_count = 0;
+    buffer_first = buffer_used = 0;
+}
@@ -0,0 +1,68 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Non-blocking send_string.
+ *
+ * Strings are queued and played back from the scan loop, one report at a
+ * time, so scanning, LEDs and everything else keep running while a long
+ * macro types. A character is sent as a press report carrying its
+ * modifiers and a release report, instead of separate modifier and key
+ * reports. The same SS_TAP(), SS_DOWN(), SS_UP() and SS_DELAY() codes as
+ * send_string() are understood.
+ *
+ * PROGMEM strings are played from flash, strings in RAM are copied into
+ * the queue's buffer, so the caller's buffer can be reused right away.
+ */
+
+// Time between two reports, there is no point in going faster than the host reads them
+#ifndef SEND_STRING_ASYNC_REPORT_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define SEND_STRING_ASYNC_REPORT_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define SEND_STRING_ASYNC_REPORT_INTERVAL 10
+#    endif
+#endif
+
+// Number of strings that can wait to be sent
+#ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#    define SEND_STRING_ASYNC_QUEUE_SIZE 4
+#endif
+
+// Bytes available for copies of strings in RAM, terminators included
+#ifndef SEND_STRING_ASYNC_BUFFER_SIZE
+#    define SEND_STRING_ASYNC_BUFFER_SIZE 64
+#endif
+
+#define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string))
+#define SEND_STRING_ASYNC_DELAY(string, interval) send_string_async_with_delay_P(PSTR(string), interval)
+
+/* These return false, and queue nothing, if the queue or the buffer is full. */
+bool send_string_async(const char *str);
+bool send_string_async_with_delay(const char *str, uint8_t interval);
+bool send_string_async_P(const char *str);
+bool send_string_async_with_delay_P(const char *str, uint8_t interval);
+
+bool send_string_async_busy(void);
+
+/* Drops everything that is queued and releases a key that is still down. */
+void send_string_async_cancel(void);
+
+void send_string_async_task(void);
@@ -0,0 +1,56 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "matrix_codec.h"
+
+void split_matrix_pack(uint8_t *packed, const matrix_row_t *matrix, uint8_t rows, uint8_t cols) {
+    uint8_t byte = 0;
+    uint8_t bit  = 0;
+
+    for (uint8_t row = 0; row < rows; row++) {
+        matrix_row_t data = matrix[row];
+        for (uint8_t col = 0; col < cols; col++, data >>= 1) {
+            byte |= (uint8_t)((data & 1) << bit);
+            if (++bit == 8) {
+                *packed++ = byte;
+                byte      = 0;
+                bit       = 0;
+            }
+        }
+    }
+
+    if (bit) {
+        *packed = byte;
+    }
+}
+
+void split_matrix_unpack(matrix_row_t *matrix, const uint8_t *packed, uint8_t rows, uint8_t cols) {
+    uint8_t byte = 0;
+    uint8_t bit  = 8;
+
+    for (uint8_t row = 0; row < rows; row++) {
+        matrix_row_t data = 0;
+        for (uint8_t col = 0; col < cols; col++, bit++) {
+            if (bit == 8) {
+                byte = *packed++;
+                bit  = 0;
+            }
+            data |= (matrix_row_t)((byte >> bit) & 1) << col;
+        }
+        matrix[row] = data;
+    }
+}
@@ -0,0 +1,32 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include "matrix.h"
+
+/* Bit-packed encoding of one half's matrix for the split transport
+ *
+ * Key (row, col) is stored in bit (row * cols + col), LSB first, so a half
+ * with rows x cols keys needs exactly SPLIT_MATRIX_PACKED_SIZE(rows, cols)
+ * bytes no matter how wide matrix_row_t is.
+ */
+#define SPLIT_MATRIX_PACKED_SIZE(rows, cols) (((rows) * (cols) + 7) / 8)
+
+void split_matrix_pack(uint8_t *packed, const matrix_row_t *matrix, uint8_t rows, uint8_t cols);
+void split_matrix_unpack(matrix_row_t *matrix, const uint8_t *packed, uint8_t rows, uint8_t cols);
@@ -16,4 +16,8 @@
 // When using serial and RGBLIGHT_SPLIT need separate transaction
 #        define SERIAL_USE_MULTI_TRANSACTION
 #    endif
+#    if defined(SPLIT_TRANSPORT_CHANGED_ONLY) && !defined(SERIAL_USE_MULTI_TRANSACTION)
+// Polling for changes and fetching the matrix are separate transactions
+#        define SERIAL_USE_MULTI_TRANSACTION
+#    endif
 #endif
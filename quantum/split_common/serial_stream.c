@@ -0,0 +1,117 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "serial_stream.h"
+#include <string.h>
+
+enum serial_stream_state {
+    STREAM_SYNC,
+    STREAM_ID,
+    STREAM_SIZE,
+    STREAM_PAYLOAD,
+    STREAM_CRC,
+};
+
+// CRC-8, polynomial 0x07
+static uint8_t crc8_update(uint8_t crc, uint8_t data) {
+    crc ^= data;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+void serial_stream_init(serial_stream_t *stream, uint8_t (*read)(uint8_t *data, uint8_t size), bool (*write)(const uint8_t *data, uint8_t size), serial_stream_handler_t handler) {
+    memset(stream, 0, sizeof(serial_stream_t));
+    stream->read    = read;
+    stream->write   = write;
+    stream->handler = handler;
+}
+
+bool serial_stream_send(serial_stream_t *stream, uint8_t id, const void *payload, uint8_t size) {
+    uint8_t frame[SERIAL_STREAM_FRAME_SIZE(SERIAL_STREAM_MAX_PAYLOAD)];
+    uint8_t crc = 0;
+
+    if (size > SERIAL_STREAM_MAX_PAYLOAD) {
+        return false;
+    }
+
+    frame[0] = SERIAL_STREAM_SYNC;
+    frame[1] = id;
+    frame[2] = size;
+    memcpy(&frame[3], payload, size);
+    for (uint8_t i = 1; i < size + 3; i++) {
+        crc = crc8_update(crc, frame[i]);
+    }
+    frame[size + 3] = crc;
+
+    return stream->write(frame, SERIAL_STREAM_FRAME_SIZE(size));
+}
+
+static bool serial_stream_receive(serial_stream_t *stream, uint8_t data) {
+    switch (stream->state) {
+        case STREAM_SYNC:
+            if (data == SERIAL_STREAM_SYNC) {
+                stream->crc   = 0;
+                stream->state = STREAM_ID;
+            }
+            break;
+        case STREAM_ID:
+            stream->id    = data;
+            stream->crc   = crc8_update(stream->crc, data);
+            stream->state = STREAM_SIZE;
+            break;
+        case STREAM_SIZE:
+            if (data > SERIAL_STREAM_MAX_PAYLOAD) {
+                stream->state = STREAM_SYNC;
+                break;
+            }
+            stream->size     = data;
+            stream->received = 0;
+            stream->crc      = crc8_update(stream->crc, data);
+            stream->state    = data ? STREAM_PAYLOAD : STREAM_CRC;
+            break;
+        case STREAM_PAYLOAD:
+            stream->payload[stream->received++] = data;
+            stream->crc                         = crc8_update(stream->crc, data);
+            if (stream->received == stream->size) {
+                stream->state = STREAM_CRC;
+            }
+            break;
+        case STREAM_CRC:
+            stream->state = STREAM_SYNC;
+            if (data == stream->crc) {
+                stream->handler(stream, stream->id, stream->payload, stream->size);
+                return true;
+            }
+            break;
+    }
+    return false;
+}
+
+uint8_t serial_stream_poll(serial_stream_t *stream) {
+    uint8_t buffer[16];
+    uint8_t frames = 0;
+    uint8_t count;
+
+    while ((count = stream->read(buffer, sizeof(buffer))) > 0) {
+        for (uint8_t i = 0; i < count; i++) {
+            frames += serial_stream_receive(stream, buffer[i]);
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,70 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Framed byte stream for full-duplex split transports
+ *
+ * Each frame is SYNC, id, size, payload[size], crc8. Both directions are
+ * independent: either side sends frames whenever it has fresh state and
+ * polls for incoming frames without ever waiting for the other half.
+ * Corrupted or truncated frames are dropped and the parser resynchronises
+ * on the next sync byte, so the receiver always ends up with the latest
+ * intact copy of each payload.
+ */
+
+#ifndef SERIAL_STREAM_MAX_PAYLOAD
+#    define SERIAL_STREAM_MAX_PAYLOAD 32
+#endif
+
+#define SERIAL_STREAM_SYNC 0x5A
+#define SERIAL_STREAM_OVERHEAD 4
+#define SERIAL_STREAM_FRAME_SIZE(payload_size) ((payload_size) + SERIAL_STREAM_OVERHEAD)
+
+typedef struct serial_stream_t serial_stream_t;
+
+typedef void (*serial_stream_handler_t)(serial_stream_t *stream, uint8_t id, const uint8_t *payload, uint8_t size);
+
+struct serial_stream_t {
+    // Backend: both must return immediately
+    uint8_t (*read)(uint8_t *data, uint8_t size);
+    bool (*write)(const uint8_t *data, uint8_t size);  // all or nothing
+    serial_stream_handler_t handler;
+
+    // Receive state
+    uint8_t state;
+    uint8_t id;
+    uint8_t size;
+    uint8_t received;
+    uint8_t crc;
+    uint8_t payload[SERIAL_STREAM_MAX_PAYLOAD];
+};
+
+void serial_stream_init(serial_stream_t *stream, uint8_t (*read)(uint8_t *data, uint8_t size), bool (*write)(const uint8_t *data, uint8_t size), serial_stream_handler_t handler);
+
+/* Queues one frame. Returns false without sending anything if the backend
+ * has no room for the whole frame right now.
+ */
+bool serial_stream_send(serial_stream_t *stream, uint8_t id, const void *payload, uint8_t size);
+
+/* Consumes every byte the backend has buffered and calls the handler for
+ * each intact frame. Returns the number of frames delivered.
+ */
+uint8_t serial_stream_poll(serial_stream_t *stream);
@@ -0,0 +1,178 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "split_events.h"
+#include "timer.h"
+
+#define SPLIT_EVENTS_MASK (SPLIT_EVENTS_BUFFER_SIZE - 1)
+
+_Static_assert((SPLIT_EVENTS_BUFFER_SIZE & SPLIT_EVENTS_MASK) == 0 && SPLIT_EVENTS_BUFFER_SIZE <= 128, "SPLIT_EVENTS_BUFFER_SIZE must be a power of two no larger than 128");
+
+static uint8_t packet_checksum(const split_event_packet_t *packet) {
+    const uint8_t *data = (const uint8_t *)packet;
+    uint8_t        sum  = 0x5A;
+
+    for (uint8_t i = 0; i < sizeof(split_event_packet_t) - sizeof(packet->checksum); i++) {
+        sum = (uint8_t)((sum << 1) | (sum >> 7)) + data[i];
+    }
+    return sum;
+}
+
+/* Slave */
+
+typedef struct {
+    uint8_t  row;
+    uint8_t  col;
+    uint32_t time;
+} recorded_event_t;
+
+static recorded_event_t recorded[SPLIT_EVENTS_BUFFER_SIZE];
+static uint8_t          recorded_sequence = 0;  // sequence number of the oldest recorded event
+static uint8_t          recorded_count    = 0;
+static bool             recorded_overflow = false;
+
+void split_events_record(const matrix_row_t *previous, const matrix_row_t *current, uint8_t rows, uint32_t now) {
+    if (recorded_overflow) {
+        if (recorded_count) {
+            return;
+        }
+        recorded_overflow = false;
+    }
+
+    for (uint8_t row = 0; row < rows; row++) {
+        matrix_row_t changes = previous[row] ^ current[row];
+        for (uint8_t col = 0; changes; col++, changes >>= 1) {
+            if (!(changes & 1)) {
+                continue;
+            }
+            if (recorded_count == SPLIT_EVENTS_BUFFER_SIZE) {
+                recorded_overflow = true;
+                return;
+            }
+
+            recorded_event_t *event = &recorded[(uint8_t)(recorded_sequence + recorded_count) & SPLIT_EVENTS_MASK];
+            event->row              = row | ((current[row] & (MATRIX_ROW_SHIFTER << col)) ? SPLIT_EVENT_PRESSED : 0);
+            event->col              = col;
+            event->time             = now;
+            recorded_count++;
+        }
+    }
+}
+
+void split_events_fill(split_event_packet_t *packet, uint8_t ack, uint32_t now) {
+    uint8_t acked = ack - recorded_sequence;
+
+    // Anything else is a stale ack from before the slave (re)started
+    if (acked <= recorded_count) {
+        recorded_sequence += acked;
+        recorded_count -= acked;
+    }
+
+    packet->sequence = recorded_sequence;
+    packet->count    = recorded_count < SPLIT_EVENTS_PER_PACKET ? recorded_count : SPLIT_EVENTS_PER_PACKET;
+    for (uint8_t i = 0; i < packet->count; i++) {
+        recorded_event_t *event = &recorded[(uint8_t)(recorded_sequence + i) & SPLIT_EVENTS_MASK];
+        uint32_t          age   = TIMER_DIFF_32(now, event->time);
+
+        packet->events[i].row = event->row;
+        packet->events[i].col = event->col;
+        packet->events[i].age = age > UINT8_MAX ? UINT8_MAX : age;
+    }
+    packet->checksum = packet_checksum(packet);
+}
+
+/* Master */
+
+static keyevent_t queued[SPLIT_EVENTS_BUFFER_SIZE];
+static uint8_t    queued_head   = 0;
+static uint8_t    queued_count  = 0;
+static uint8_t    expected      = 0;
+static uint32_t   earliest_time = 0;
+
+static void queue_event(matrix_row_t *matrix, uint8_t row, uint8_t row_offset, uint8_t col, bool pressed, uint32_t time) {
+    if (pressed) {
+        matrix[row] |= MATRIX_ROW_SHIFTER << col;
+    } else {
+        matrix[row] &= ~(MATRIX_ROW_SHIFTER << col);
+    }
+
+    // Never hand out an event older than one already processed
+    if ((int32_t)(time - earliest_time) < 0) {
+        time = earliest_time;
+    }
+    earliest_time = time;
+
+    // If the queue is full, keyboard_task() picks the change up from the matrix instead
+    if (queued_count == SPLIT_EVENTS_BUFFER_SIZE) {
+        return;
+    }
+    queued[(uint8_t)(queued_head + queued_count) & SPLIT_EVENTS_MASK] = (keyevent_t){
+        .key = (keypos_t){.row = row + row_offset, .col = col}, .pressed = pressed, .time = time | 1 /* time should not be 0 */
+    };
+    queued_count++;
+}
+
+bool split_events_receive(const split_event_packet_t *packet, const matrix_row_t *snapshot, matrix_row_t *matrix, uint8_t rows, uint8_t row_offset, uint32_t now, uint8_t *ack) {
+    if (packet->count > SPLIT_EVENTS_PER_PACKET || packet->checksum != packet_checksum(packet)) {
+        *ack = expected;
+        return false;
+    }
+
+    uint8_t skip = expected - packet->sequence;
+    if (skip <= packet->count) {
+        // Events before expected were delivered by an earlier packet
+        for (uint8_t i = skip; i < packet->count; i++) {
+            const split_event_t *event = &packet->events[i];
+            uint8_t              row   = event->row & ~SPLIT_EVENT_PRESSED;
+
+            if (row < rows && event->col < MATRIX_COLS) {
+                queue_event(matrix, row, row_offset, event->col, event->row & SPLIT_EVENT_PRESSED, now - event->age);
+            }
+        }
+    }
+    expected = packet->sequence + packet->count;
+
+    // Either side restarted or the slave's buffer overflowed: once every
+    // event has been sent, make up for the lost ones from the snapshot
+    if (skip > packet->count || packet->count < SPLIT_EVENTS_PER_PACKET) {
+        for (uint8_t row = 0; row < rows; row++) {
+            matrix_row_t changes = matrix[row] ^ snapshot[row];
+            for (uint8_t col = 0; changes; col++, changes >>= 1) {
+                if (changes & 1) {
+                    queue_event(matrix, row, row_offset, col, snapshot[row] & (MATRIX_ROW_SHIFTER << col), now);
+                }
+            }
+        }
+    }
+
+    if ((int32_t)(now - earliest_time) > 0) {
+        earliest_time = now;
+    }
+    *ack = expected;
+    return true;
+}
+
+bool split_events_next(keyevent_t *event) {
+    if (!queued_count) {
+        return false;
+    }
+
+    *event      = queued[queued_head];
+    queued_head = (queued_head + 1) & SPLIT_EVENTS_MASK;
+    queued_count--;
+    return true;
+}
@@ -0,0 +1,78 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "keyboard.h"
+
+/* Split key event stream
+ *
+ * Instead of mirroring the slave's matrix, the slave records every key
+ * change with its own timestamp and a sequence number. Each transport
+ * packet carries the oldest events the master has not acknowledged yet,
+ * so a lost or corrupted packet is simply replayed by the next one. The
+ * master turns the events back into keyevent_t with the time the key
+ * actually changed on the slave, and keyboard_task() feeds them to
+ * action_exec() before anything it scans locally.
+ */
+
+#ifndef SPLIT_EVENTS_PER_PACKET
+#    define SPLIT_EVENTS_PER_PACKET 3
+#endif
+
+#ifndef SPLIT_EVENTS_BUFFER_SIZE
+#    define SPLIT_EVENTS_BUFFER_SIZE 16
+#endif
+
+#define SPLIT_EVENT_PRESSED 0x80
+
+typedef struct {
+    uint8_t row;  // row within the slave's half, SPLIT_EVENT_PRESSED set on press
+    uint8_t col;
+    uint8_t age;  // ms between the change and the packet being filled, saturates at 255
+} split_event_t;
+
+typedef struct {
+    uint8_t       sequence;  // sequence number of events[0]
+    uint8_t       count;
+    split_event_t events[SPLIT_EVENTS_PER_PACKET];
+    uint8_t       checksum;  // written last, so a packet torn by the transport is rejected
+} split_event_packet_t;
+
+// Slave side
+
+/* Records an event for every key that differs between previous and current.
+ * If the buffer overflows, recording stops until the master has caught up;
+ * the master then resynchronises from the matrix snapshot.
+ */
+void split_events_record(const matrix_row_t *previous, const matrix_row_t *current, uint8_t rows, uint32_t now);
+/* Drops the events before ack and fills packet with the oldest remaining ones. */
+void split_events_fill(split_event_packet_t *packet, uint8_t ack, uint32_t now);
+
+// Master side
+
+/* Applies the new events in packet to the slave's rows of matrix and queues
+ * them for split_events_next(). Once the slave has nothing left to send, any
+ * difference to snapshot (after an overflow or reconnect) is queued as
+ * events too. Returns false if the packet is corrupt. *ack is set to the next
+ * sequence number expected from the slave.
+ */
+bool split_events_receive(const split_event_packet_t *packet, const matrix_row_t *snapshot, matrix_row_t *matrix, uint8_t rows, uint8_t row_offset, uint32_t now, uint8_t *ack);
+bool split_events_next(keyevent_t *event);
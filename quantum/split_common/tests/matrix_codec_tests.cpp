@@ -0,0 +1,91 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <random>
+#include <tuple>
+#include <vector>
+extern "C" {
+#include "split_common/matrix_codec.h"
+}
+
+// Built with MATRIX_COLS 32, so matrix_row_t holds every width under test
+class MatrixCodec : public testing::TestWithParam<std::tuple<uint8_t, uint8_t>> {
+   public:
+    uint8_t rows() { return std::get<0>(GetParam()); }
+    uint8_t cols() { return std::get<1>(GetParam()); }
+
+    matrix_row_t col_mask() { return cols() == 32 ? ~(matrix_row_t)0 : (((matrix_row_t)1 << cols()) - 1); }
+
+    void round_trip(const std::vector<matrix_row_t>& matrix) {
+        size_t               size = SPLIT_MATRIX_PACKED_SIZE(rows(), cols());
+        std::vector<uint8_t> packed(size + 1, 0xA5);
+        std::vector<matrix_row_t> unpacked(rows() + 1, 0x5A5A5A5A);
+
+        split_matrix_pack(packed.data(), matrix.data(), rows(), cols());
+        EXPECT_EQ(packed[size], 0xA5) << "pack wrote past the packed size";
+        split_matrix_unpack(unpacked.data(), packed.data(), rows(), cols());
+        EXPECT_EQ(unpacked[rows()], 0x5A5A5A5A) << "unpack wrote past the last row";
+        for (uint8_t row = 0; row < rows(); row++) {
+            EXPECT_EQ(unpacked[row], matrix[row]) << "row " << (int)row;
+        }
+    }
+};
+
+TEST_P(MatrixCodec, packed_size_is_exact) {
+    EXPECT_EQ(SPLIT_MATRIX_PACKED_SIZE(rows(), cols()), (rows() * cols() + 7) / 8);
+}
+
+TEST_P(MatrixCodec, round_trips_empty_and_full_matrix) {
+    round_trip(std::vector<matrix_row_t>(rows(), 0));
+    round_trip(std::vector<matrix_row_t>(rows(), col_mask()));
+}
+
+TEST_P(MatrixCodec, round_trips_every_single_key) {
+    for (uint8_t row = 0; row < rows(); row++) {
+        for (uint8_t col = 0; col < cols(); col++) {
+            std::vector<matrix_row_t> matrix(rows(), 0);
+            matrix[row] = (matrix_row_t)1 << col;
+            round_trip(matrix);
+        }
+    }
+}
+
+TEST_P(MatrixCodec, round_trips_random_matrices) {
+    std::mt19937 random(rows() * 100 + cols());
+    for (int i = 0; i < 100; i++) {
+        std::vector<matrix_row_t> matrix(rows());
+        for (auto& row : matrix) {
+            row = random() & col_mask();
+        }
+        round_trip(matrix);
+    }
+}
+
+TEST_P(MatrixCodec, ignores_columns_outside_the_matrix) {
+    std::vector<matrix_row_t> matrix(rows(), ~(matrix_row_t)0);
+    std::vector<uint8_t>      packed(SPLIT_MATRIX_PACKED_SIZE(rows(), cols()));
+    std::vector<matrix_row_t> unpacked(rows());
+
+    split_matrix_pack(packed.data(), matrix.data(), rows(), cols());
+    split_matrix_unpack(unpacked.data(), packed.data(), rows(), cols());
+    for (uint8_t row = 0; row < rows(); row++) {
+        EXPECT_EQ(unpacked[row], col_mask());
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(Shapes, MatrixCodec, testing::Combine(testing::Values(1, 2, 3, 4, 5, 6, 8), testing::Values(1, 3, 6, 7, 8, 9, 12, 15, 16, 17, 24, 31, 32)));
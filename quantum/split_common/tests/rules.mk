@@ -0,0 +1,28 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+split_common_serial_stream_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/serial_stream_tests.cpp \
+	$(QUANTUM_PATH)/split_common/serial_stream.c
+
+split_common_matrix_codec_DEFS := -DMATRIX_ROWS=16 -DMATRIX_COLS=32
+split_common_matrix_codec_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/matrix_codec_tests.cpp \
+	$(QUANTUM_PATH)/split_common/matrix_codec.c
+
+split_common_split_events_DEFS := -DMATRIX_ROWS=8 -DMATRIX_COLS=8
+split_common_split_events_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_events_tests.cpp \
+	$(QUANTUM_PATH)/split_common/split_events.c
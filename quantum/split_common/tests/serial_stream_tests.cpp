@@ -0,0 +1,184 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <deque>
+#include <vector>
+extern "C" {
+#include "split_common/serial_stream.h"
+}
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+// Host loopback backend: one byte pipe per direction
+struct Pipe {
+    std::deque<uint8_t> bytes;
+    size_t              capacity = 256;
+
+    uint8_t read(uint8_t* data, uint8_t size) {
+        uint8_t count = 0;
+        while (count < size && !bytes.empty()) {
+            data[count++] = bytes.front();
+            bytes.pop_front();
+        }
+        return count;
+    }
+
+    bool write(const uint8_t* data, uint8_t size) {
+        if (bytes.size() + size > capacity) {
+            return false;
+        }
+        bytes.insert(bytes.end(), data, data + size);
+        return true;
+    }
+};
+
+struct Frame {
+    serial_stream_t*     stream;
+    uint8_t              id;
+    std::vector<uint8_t> payload;
+};
+
+static Pipe               master_to_slave;
+static Pipe               slave_to_master;
+static std::vector<Frame> frames;
+
+extern "C" {
+static uint8_t master_read(uint8_t* data, uint8_t size) { return slave_to_master.read(data, size); }
+static bool    master_write(const uint8_t* data, uint8_t size) { return master_to_slave.write(data, size); }
+static uint8_t slave_read(uint8_t* data, uint8_t size) { return master_to_slave.read(data, size); }
+static bool    slave_write(const uint8_t* data, uint8_t size) { return slave_to_master.write(data, size); }
+static void    record_frame(serial_stream_t* stream, uint8_t id, const uint8_t* payload, uint8_t size) { frames.push_back({stream, id, std::vector<uint8_t>(payload, payload + size)}); }
+}
+
+class SerialStream : public testing::Test {
+   public:
+    SerialStream() {
+        master_to_slave = Pipe();
+        slave_to_master = Pipe();
+        frames.clear();
+        serial_stream_init(&master, master_read, master_write, record_frame);
+        serial_stream_init(&slave, slave_read, slave_write, record_frame);
+    }
+
+    serial_stream_t master;
+    serial_stream_t slave;
+};
+
+TEST_F(SerialStream, delivers_a_frame) {
+    uint8_t payload[] = {1, 2, 3};
+    EXPECT_TRUE(serial_stream_send(&master, 2, payload, sizeof(payload)));
+    EXPECT_EQ(master_to_slave.bytes.size(), SERIAL_STREAM_FRAME_SIZE(sizeof(payload)));
+    EXPECT_EQ(serial_stream_poll(&slave), 1);
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames[0].stream, &slave);
+    EXPECT_EQ(frames[0].id, 2);
+    EXPECT_THAT(frames[0].payload, ElementsAreArray(payload));
+}
+
+TEST_F(SerialStream, delivers_an_empty_frame) {
+    EXPECT_TRUE(serial_stream_send(&master, 1, NULL, 0));
+    EXPECT_EQ(serial_stream_poll(&slave), 1);
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames[0].id, 1);
+    EXPECT_TRUE(frames[0].payload.empty());
+}
+
+TEST_F(SerialStream, both_directions_are_independent) {
+    uint8_t matrix[] = {0x81, 0x00, 0x10, 0xFF};
+    uint8_t wpm      = 72;
+    EXPECT_TRUE(serial_stream_send(&slave, 0, matrix, sizeof(matrix)));
+    EXPECT_TRUE(serial_stream_send(&master, 0, &wpm, sizeof(wpm)));
+    EXPECT_EQ(serial_stream_poll(&master), 1);
+    EXPECT_EQ(serial_stream_poll(&slave), 1);
+    ASSERT_EQ(frames.size(), 2);
+    EXPECT_EQ(frames[0].stream, &master);
+    EXPECT_THAT(frames[0].payload, ElementsAreArray(matrix));
+    EXPECT_EQ(frames[1].stream, &slave);
+    EXPECT_THAT(frames[1].payload, ElementsAre(72));
+}
+
+TEST_F(SerialStream, poll_without_data_returns_immediately) {
+    EXPECT_EQ(serial_stream_poll(&master), 0);
+    EXPECT_TRUE(frames.empty());
+}
+
+TEST_F(SerialStream, every_queued_frame_is_delivered_in_order) {
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_TRUE(serial_stream_send(&slave, 0, &i, 1));
+    }
+    EXPECT_EQ(serial_stream_poll(&master), 3);
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_THAT(frames.back().payload, ElementsAre(2));
+}
+
+TEST_F(SerialStream, partial_frame_is_kept_until_complete) {
+    uint8_t payload[] = {0xAA, 0x55};
+    Pipe    staging;
+    EXPECT_TRUE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    staging.bytes.swap(master_to_slave.bytes);
+
+    while (staging.bytes.size() > 1) {
+        master_to_slave.bytes.push_back(staging.bytes.front());
+        staging.bytes.pop_front();
+        EXPECT_EQ(serial_stream_poll(&slave), 0);
+    }
+    master_to_slave.bytes.push_back(staging.bytes.front());
+    EXPECT_EQ(serial_stream_poll(&slave), 1);
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_THAT(frames[0].payload, ElementsAreArray(payload));
+}
+
+TEST_F(SerialStream, corrupted_frame_is_dropped) {
+    uint8_t payload[] = {1, 2, 3};
+    EXPECT_TRUE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    master_to_slave.bytes[4] ^= 0x04;
+    EXPECT_TRUE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    EXPECT_EQ(serial_stream_poll(&slave), 1);
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_THAT(frames[0].payload, ElementsAreArray(payload));
+}
+
+TEST_F(SerialStream, resynchronises_after_line_noise) {
+    uint8_t noise[]   = {0x00, SERIAL_STREAM_SYNC, 0x01, 0x40, SERIAL_STREAM_SYNC, 0x13, SERIAL_STREAM_SYNC};
+    uint8_t payload[] = {9, 8, 7, 6};
+    master_to_slave.write(noise, sizeof(noise));
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_TRUE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    }
+    EXPECT_GE(serial_stream_poll(&slave), 1);
+    ASSERT_FALSE(frames.empty());
+    for (auto& frame : frames) {
+        EXPECT_EQ(frame.id, 0);
+        EXPECT_THAT(frame.payload, ElementsAreArray(payload));
+    }
+}
+
+TEST_F(SerialStream, send_is_all_or_nothing) {
+    uint8_t payload[8] = {};
+    master_to_slave.capacity = SERIAL_STREAM_FRAME_SIZE(sizeof(payload)) - 1;
+    EXPECT_FALSE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    EXPECT_TRUE(master_to_slave.bytes.empty());
+}
+
+TEST_F(SerialStream, rejects_oversized_payloads) {
+    uint8_t payload[SERIAL_STREAM_MAX_PAYLOAD + 1] = {};
+    EXPECT_FALSE(serial_stream_send(&master, 0, payload, sizeof(payload)));
+    EXPECT_TRUE(master_to_slave.bytes.empty());
+}
@@ -0,0 +1,302 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "split_common/split_events.h"
+}
+
+#define ROWS 4
+#define ROW_OFFSET 4
+
+// The event buffers are module state, so every test starts from a link
+// that has settled with all keys released.
+class SplitEvents : public testing::Test {
+   public:
+    SplitEvents() {
+        std::memset(slave, 0, sizeof(slave));
+        scan();
+        for (int i = 0; i < 2 * SPLIT_EVENTS_BUFFER_SIZE; i++) {
+            exchange();
+        }
+        drain();
+        std::memset(master, 0, sizeof(master));
+    }
+
+    static matrix_row_t slave[ROWS];
+    static matrix_row_t slave_previous[ROWS];
+    static matrix_row_t master[ROWS];
+    static uint8_t      ack;
+    static uint32_t     now;
+
+    void scan() {
+        split_events_record(slave_previous, slave, ROWS, now);
+        std::memcpy(slave_previous, slave, sizeof(slave));
+    }
+    void press(uint8_t row, uint8_t col) {
+        slave[row] |= MATRIX_ROW_SHIFTER << col;
+        scan();
+    }
+    void release(uint8_t row, uint8_t col) {
+        slave[row] &= ~(MATRIX_ROW_SHIFTER << col);
+        scan();
+    }
+
+    split_event_packet_t fill() {
+        split_event_packet_t packet;
+        split_events_fill(&packet, ack, now);
+        return packet;
+    }
+    bool receive(const split_event_packet_t& packet) { return split_events_receive(&packet, slave, master, ROWS, ROW_OFFSET, now, &ack); }
+    bool exchange() { return receive(fill()); }
+
+    std::vector<keyevent_t> drain() {
+        std::vector<keyevent_t> events;
+        keyevent_t              event;
+        while (split_events_next(&event)) {
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    void expect_event(const keyevent_t& event, uint8_t row, uint8_t col, bool pressed, uint32_t time) {
+        EXPECT_EQ(event.key.row, row + ROW_OFFSET);
+        EXPECT_EQ(event.key.col, col);
+        EXPECT_EQ(event.pressed, pressed);
+        EXPECT_EQ(event.time, time | 1);
+    }
+};
+
+matrix_row_t SplitEvents::slave[ROWS];
+matrix_row_t SplitEvents::slave_previous[ROWS];
+matrix_row_t SplitEvents::master[ROWS];
+uint8_t      SplitEvents::ack = 0;
+uint32_t     SplitEvents::now = 1000;
+
+TEST_F(SplitEvents, EventsKeepTheSlaveTimestampsAndOrder) {
+    now += 100;
+    uint32_t start = now;
+    press(1, 2);
+    now += 4;
+    press(3, 0);
+    now += 3;
+    release(1, 2);
+    now += 5;
+
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 3);
+    expect_event(events[0], 1, 2, true, start);
+    expect_event(events[1], 3, 0, true, start + 4);
+    expect_event(events[2], 1, 2, false, start + 7);
+    EXPECT_EQ(master[1], 0);
+    EXPECT_EQ(master[3], 1);
+}
+
+TEST_F(SplitEvents, MoreEventsThanFitInAPacketAreSentOverSeveralTransfers) {
+    for (uint8_t col = 0; col < SPLIT_EVENTS_PER_PACKET * 2 + 1; col++) {
+        now += 2;
+        press(0, col);
+    }
+    now += 10;
+
+    EXPECT_TRUE(exchange());
+    EXPECT_EQ(drain().size(), SPLIT_EVENTS_PER_PACKET);
+    now += 1;
+    EXPECT_TRUE(exchange());
+    EXPECT_EQ(drain().size(), SPLIT_EVENTS_PER_PACKET);
+    now += 1;
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].key.col, SPLIT_EVENTS_PER_PACKET * 2);
+    EXPECT_EQ(master[0], slave[0]);
+}
+
+TEST_F(SplitEvents, LostPacketIsReplayed) {
+    now += 50;
+    press(2, 5);
+    now += 1;
+    fill();  // never reaches the master
+
+    now += 1;
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    expect_event(events[0], 2, 5, true, now - 2);
+}
+
+TEST_F(SplitEvents, DuplicatedPacketIsDeliveredOnce) {
+    press(0, 1);
+    split_event_packet_t packet = fill();
+
+    EXPECT_TRUE(receive(packet));
+    EXPECT_TRUE(receive(packet));
+    EXPECT_EQ(drain().size(), 1);
+
+    // A replay that only partly overlaps delivers just the new events
+    press(0, 2);
+    packet = fill();
+    EXPECT_EQ(packet.count, 1);
+    press(0, 3);
+    split_event_packet_t replay;
+    split_events_fill(&replay, ack - 1, now);  // a stale ack changes nothing on the slave
+    EXPECT_TRUE(receive(replay));
+    auto events = drain();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].key.col, 2);
+    EXPECT_EQ(events[1].key.col, 3);
+}
+
+TEST_F(SplitEvents, AcknowledgedEventsAreDropped) {
+    press(1, 1);
+    press(1, 2);
+    EXPECT_TRUE(exchange());
+    EXPECT_EQ(drain().size(), 2);
+
+    split_event_packet_t packet = fill();
+    EXPECT_EQ(packet.count, 0);
+    EXPECT_EQ(packet.sequence, ack);
+}
+
+TEST_F(SplitEvents, SequenceNumbersWrap) {
+    for (int i = 0; i < 300; i++) {
+        now += 1;
+        if (i % 2) {
+            release(3, 7);
+        } else {
+            press(3, 7);
+        }
+        EXPECT_TRUE(exchange());
+        auto events = drain();
+        ASSERT_EQ(events.size(), 1);
+        EXPECT_EQ(events[0].pressed, !(i % 2));
+    }
+    EXPECT_EQ(master[3], 0);
+}
+
+TEST_F(SplitEvents, AgeSaturates) {
+    now += 50;
+    uint32_t start = now;
+    press(0, 0);
+    now += 1000;
+
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].time, (now - 255) | 1);
+    EXPECT_GT(events[0].time, start);
+}
+
+TEST_F(SplitEvents, TimesNeverGoBackwards) {
+    now += 20;
+    press(0, 0);
+    now += 10;
+    EXPECT_TRUE(exchange());
+    drain();
+
+    // Lost long enough for the age to saturate; the replay cannot be
+    // timestamped before what the master already processed
+    now += 300;
+    press(0, 1);
+    now += 2;
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].time, (now - 2) | 1);
+
+    // A slave clock running ahead makes events look older than they are
+    press(0, 2);
+    split_event_packet_t packet;
+    split_events_fill(&packet, ack, now + 200);
+    EXPECT_TRUE(receive(packet));
+    events = drain();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].time, now | 1);
+}
+
+TEST_F(SplitEvents, OverflowResynchronisesFromTheSnapshot) {
+    for (uint8_t row = 0; row < ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            now += 1;
+            press(row, col);
+        }
+    }
+    ASSERT_GT(ROWS * MATRIX_COLS, SPLIT_EVENTS_BUFFER_SIZE);
+
+    size_t delivered = 0;
+    for (int i = 0; i < SPLIT_EVENTS_BUFFER_SIZE; i++) {
+        now += 1;
+        EXPECT_TRUE(exchange());
+        delivered += drain().size();
+    }
+    // Changes that don't fit the master's queue are left in the matrix for keyboard_task() to find
+    EXPECT_GE(delivered, SPLIT_EVENTS_BUFFER_SIZE);
+    EXPECT_LE(delivered, ROWS * MATRIX_COLS);
+    EXPECT_EQ(0, std::memcmp(master, slave, sizeof(master)));
+
+    // Recording resumes once the slave has caught up
+    now += 1;
+    release(2, 2);
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    expect_event(events[0], 2, 2, false, now);
+}
+
+TEST_F(SplitEvents, SlaveRestartResynchronises) {
+    press(1, 3);
+    EXPECT_TRUE(exchange());
+    drain();
+
+    // The restarted slave starts over from sequence 0 and knows nothing
+    // of the acknowledged events; whatever it sends, the master ends up
+    // with its matrix
+    ack += 100;
+    press(1, 4);
+    now += 1;
+    EXPECT_TRUE(exchange());
+    drain();
+    for (int i = 0; i < 2; i++) {
+        now += 1;
+        EXPECT_TRUE(exchange());
+        drain();
+    }
+    EXPECT_EQ(master[1], slave[1]);
+}
+
+TEST_F(SplitEvents, CorruptPacketIsRejected) {
+    press(2, 6);
+    split_event_packet_t packet = fill();
+    packet.events[0].col ^= 1;
+
+    uint8_t before = ack;
+    EXPECT_FALSE(receive(packet));
+    EXPECT_EQ(ack, before);
+    EXPECT_EQ(drain().size(), 0);
+    EXPECT_EQ(master[2], 0);
+
+    packet.count = SPLIT_EVENTS_PER_PACKET + 1;
+    EXPECT_FALSE(receive(packet));
+
+    EXPECT_TRUE(exchange());
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].key.col, 6);
+}
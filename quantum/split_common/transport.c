@@ -127,10 +127,36 @@ void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
 #else  // USE_SERIAL
 
 #    include "serial.h"
+#    include "matrix_codec.h"
+#    ifdef SPLIT_TRANSPORT_EVENTS
+#        include "split_events.h"
+#        ifdef SPLIT_TRANSPORT_CHANGED_ONLY
+#            error "SPLIT_TRANSPORT_EVENTS and SPLIT_TRANSPORT_CHANGED_ONLY can not be used together"
+#        endif
+#    endif
+
+#    if (MATRIX_COLS <= 8)
+#        define MATRIX_ROW_BYTES 1
+#    elif (MATRIX_COLS <= 16)
+#        define MATRIX_ROW_BYTES 2
+#    else
+#        define MATRIX_ROW_BYTES 4
+#    endif
+
+// Only pay for packing when the matrix rows don't fill matrix_row_t
+#    if SPLIT_MATRIX_PACKED_SIZE(ROWS_PER_HAND, MATRIX_COLS) < ROWS_PER_HAND * MATRIX_ROW_BYTES
+#        define SPLIT_MATRIX_PACKED
+#    endif
 
 typedef struct _Serial_s2m_buffer_t {
-    // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
+#    ifdef SPLIT_MATRIX_PACKED
+    uint8_t packed_matrix[SPLIT_MATRIX_PACKED_SIZE(ROWS_PER_HAND, MATRIX_COLS)];
+#    else
     matrix_row_t smatrix[ROWS_PER_HAND];
+#    endif
+#    ifdef SPLIT_TRANSPORT_EVENTS
+    split_event_packet_t events;
+#    endif
 
 #    ifdef ENCODER_ENABLE
     uint8_t      encoder_state[NUMBER_OF_ENCODERS];
@@ -145,6 +171,9 @@ typedef struct _Serial_m2s_buffer_t {
 #    ifdef WPM_ENABLE
     uint8_t current_wpm;
 #    endif
+#    ifdef SPLIT_TRANSPORT_EVENTS
+    uint8_t events_ack;
+#    endif
 } Serial_m2s_buffer_t;
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -164,18 +193,40 @@ volatile Serial_rgblight_t serial_rgblight = {};
 uint8_t volatile status_rgblight           = 0;
 #    endif
 
+#    ifdef SERIAL_DRIVER_USART_DUPLEX
+#        include "serial_stream.h"
+
+// Every transaction buffer goes out as a single stream frame, a bigger one could never be sent
+_Static_assert(sizeof(Serial_s2m_buffer_t) <= SERIAL_STREAM_MAX_PAYLOAD, "Serial_s2m_buffer_t does not fit in SERIAL_STREAM_MAX_PAYLOAD");
+_Static_assert(sizeof(Serial_m2s_buffer_t) <= SERIAL_STREAM_MAX_PAYLOAD, "Serial_m2s_buffer_t does not fit in SERIAL_STREAM_MAX_PAYLOAD");
+#        if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+_Static_assert(sizeof(Serial_rgblight_t) <= SERIAL_STREAM_MAX_PAYLOAD, "Serial_rgblight_t does not fit in SERIAL_STREAM_MAX_PAYLOAD");
+#        endif
+#    endif
+
 volatile Serial_s2m_buffer_t serial_s2m_buffer = {};
 volatile Serial_m2s_buffer_t serial_m2s_buffer = {};
 uint8_t volatile status0                       = 0;
 
+#    ifdef SPLIT_TRANSPORT_CHANGED_ONLY
+// Bumped by the slave whenever serial_s2m_buffer changes; the master only
+// fetches the buffer when this differs from the last value it acknowledged.
+uint8_t volatile serial_s2m_sequence = 0;
+uint8_t volatile status_changes      = 0;
+#    endif
+
 enum serial_transaction_id {
     GET_SLAVE_MATRIX = 0,
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     PUT_RGBLIGHT,
 #    endif
+#    ifdef SPLIT_TRANSPORT_CHANGED_ONLY
+    GET_SLAVE_CHANGES,
+#    endif
 };
 
 SSTD_t transactions[] = {
+#    ifndef SPLIT_TRANSPORT_CHANGED_ONLY
     [GET_SLAVE_MATRIX] =
         {
             (uint8_t *)&status0,
@@ -184,6 +235,20 @@ SSTD_t transactions[] = {
             sizeof(serial_s2m_buffer),
             (uint8_t *)&serial_s2m_buffer,
         },
+#    else
+    [GET_SLAVE_MATRIX] =
+        {
+            (uint8_t *)&status0, 0, NULL, sizeof(serial_s2m_buffer), (uint8_t *)&serial_s2m_buffer,  // master to slave data goes with GET_SLAVE_CHANGES
+        },
+    [GET_SLAVE_CHANGES] =
+        {
+            (uint8_t *)&status_changes,
+            sizeof(serial_m2s_buffer),
+            (uint8_t *)&serial_m2s_buffer,
+            sizeof(serial_s2m_sequence),
+            (uint8_t *)&serial_s2m_sequence,
+        },
+#    endif
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     [PUT_RGBLIGHT] =
         {
@@ -226,6 +291,25 @@ bool transport_master(matrix_row_t matrix[]) {
     if (soft_serial_transaction() != TRANSACTION_END) {
         return false;
     }
+#    elif defined(SPLIT_TRANSPORT_CHANGED_ONLY)
+    static uint8_t acked_sequence = 0;
+    static bool    acked          = false;
+
+    transport_rgblight_master();
+    if (soft_serial_transaction(GET_SLAVE_CHANGES) != TRANSACTION_END) {
+        // The slave may have restarted, fetch everything once it is back
+        acked = false;
+        return false;
+    }
+    uint8_t sequence = serial_s2m_sequence;
+    if (!acked || sequence != acked_sequence) {
+        if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+            acked = false;
+            return false;
+        }
+        acked_sequence = sequence;
+        acked          = true;
+    }
 #    else
     transport_rgblight_master();
     if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
@@ -233,10 +317,29 @@ bool transport_master(matrix_row_t matrix[]) {
     }
 #    endif
 
-    // TODO:  if MATRIX_COLS > 8 change to unpack()
+#    ifdef SPLIT_TRANSPORT_EVENTS
+    // The matrix only serves as a snapshot, the events carry the changes
+    matrix_row_t snapshot[ROWS_PER_HAND];
+    matrix_row_t *slave_matrix = snapshot;
+#    else
+    matrix_row_t *slave_matrix = matrix;
+#    endif
+#    ifdef SPLIT_MATRIX_PACKED
+    split_matrix_unpack(slave_matrix, (const uint8_t *)serial_s2m_buffer.packed_matrix, ROWS_PER_HAND, MATRIX_COLS);
+#    else
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        matrix[i] = serial_s2m_buffer.smatrix[i];
+        slave_matrix[i] = serial_s2m_buffer.smatrix[i];
+    }
+#    endif
+#    ifdef SPLIT_TRANSPORT_EVENTS
+    extern uint8_t thatHand;
+    uint8_t        ack;
+    bool           valid = split_events_receive((const split_event_packet_t *)&serial_s2m_buffer.events, snapshot, matrix, ROWS_PER_HAND, thatHand, timer_scan_read32(), &ack);
+    serial_m2s_buffer.events_ack = ack;
+    if (!valid) {
+        return false;
     }
+#    endif
 
 #    ifdef BACKLIGHT_ENABLE
     // Write backlight level for slave to read
@@ -256,16 +359,42 @@ bool transport_master(matrix_row_t matrix[]) {
 
 void transport_slave(matrix_row_t matrix[]) {
     transport_rgblight_slave();
-    // TODO: if MATRIX_COLS > 8 change to pack()
+#    ifdef SPLIT_TRANSPORT_CHANGED_ONLY
+    // Build the new state aside so the master only sees a new sequence number once it is complete
+    Serial_s2m_buffer_t  next_s2m_buffer = {};
+    Serial_s2m_buffer_t *s2m_buffer      = &next_s2m_buffer;
+#    else
+    Serial_s2m_buffer_t *s2m_buffer = (Serial_s2m_buffer_t *)&serial_s2m_buffer;
+#    endif
+
+#    ifdef SPLIT_MATRIX_PACKED
+    split_matrix_pack(s2m_buffer->packed_matrix, matrix, ROWS_PER_HAND, MATRIX_COLS);
+#    else
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        serial_s2m_buffer.smatrix[i] = matrix[i];
+        s2m_buffer->smatrix[i] = matrix[i];
     }
+#    endif
 #    ifdef BACKLIGHT_ENABLE
     backlight_set(serial_m2s_buffer.backlight_level);
 #    endif
 
 #    ifdef ENCODER_ENABLE
-    encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+    encoder_state_raw(s2m_buffer->encoder_state);
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_EVENTS
+    static matrix_row_t previous[ROWS_PER_HAND];
+
+    split_events_record(previous, matrix, ROWS_PER_HAND, timer_scan_read32());
+    memcpy(previous, matrix, sizeof(previous));
+    split_events_fill(&s2m_buffer->events, serial_m2s_buffer.events_ack, timer_scan_read32());
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_CHANGED_ONLY
+    if (memcmp(s2m_buffer, (const void *)&serial_s2m_buffer, sizeof(Serial_s2m_buffer_t)) != 0) {
+        memcpy((void *)&serial_s2m_buffer, s2m_buffer, sizeof(Serial_s2m_buffer_t));
+        serial_s2m_sequence++;
+    }
 #    endif
 
 #    ifdef WPM_ENABLE
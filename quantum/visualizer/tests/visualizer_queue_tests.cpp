@@ -0,0 +1,151 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+#include <pthread.h>
+extern "C" {
+#include "visualizer_queue.h"
+}
+
+typedef struct {
+    uint32_t sequence;
+    uint32_t check;  // a torn copy would not match the sequence
+    uint8_t  padding[8];
+} element_t;
+
+static element_t make_element(uint32_t sequence) {
+    element_t element;
+    element.sequence = sequence;
+    element.check    = ~sequence * 2654435761u;
+    memset(element.padding, sequence & 0xFF, sizeof(element.padding));
+    return element;
+}
+
+static bool valid_element(const element_t &element) {
+    if (element.check != ~element.sequence * 2654435761u) {
+        return false;
+    }
+    for (uint8_t byte : element.padding) {
+        if (byte != (element.sequence & 0xFF)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class VisualizerQueue : public testing::Test {
+   public:
+    VisualizerQueue() : queue(VISUALIZER_QUEUE_INIT(storage)) {}
+
+   protected:
+    element_t          storage[16];
+    visualizer_queue_t queue;
+};
+
+TEST_F(VisualizerQueue, StartsEmpty) {
+    element_t element;
+    EXPECT_EQ(visualizer_queue_count(&queue), 0);
+    EXPECT_FALSE(visualizer_queue_pop(&queue, &element));
+}
+
+TEST_F(VisualizerQueue, KeepsOrder) {
+    for (uint32_t i = 0; i < 5; i++) {
+        element_t element = make_element(i);
+        EXPECT_TRUE(visualizer_queue_push(&queue, &element));
+    }
+    EXPECT_EQ(visualizer_queue_count(&queue), 5);
+    for (uint32_t i = 0; i < 5; i++) {
+        element_t element;
+        ASSERT_TRUE(visualizer_queue_pop(&queue, &element));
+        EXPECT_EQ(element.sequence, i);
+        EXPECT_TRUE(valid_element(element));
+    }
+    element_t element;
+    EXPECT_FALSE(visualizer_queue_pop(&queue, &element));
+}
+
+TEST_F(VisualizerQueue, RejectsWhenFull) {
+    for (uint32_t i = 0; i < 16; i++) {
+        element_t element = make_element(i);
+        EXPECT_TRUE(visualizer_queue_push(&queue, &element));
+    }
+    element_t extra = make_element(100);
+    EXPECT_FALSE(visualizer_queue_push(&queue, &extra));
+    EXPECT_EQ(visualizer_queue_count(&queue), 16);
+
+    // the rejected element must not have overwritten the oldest one
+    element_t element;
+    ASSERT_TRUE(visualizer_queue_pop(&queue, &element));
+    EXPECT_EQ(element.sequence, 0u);
+    EXPECT_TRUE(visualizer_queue_push(&queue, &extra));
+}
+
+TEST_F(VisualizerQueue, WrapsIndexes) {
+    // run the 8-bit indexes around several times
+    for (uint32_t i = 0; i < 1000; i++) {
+        element_t element = make_element(i);
+        ASSERT_TRUE(visualizer_queue_push(&queue, &element));
+        if (i % 3 == 0) {
+            ASSERT_TRUE(visualizer_queue_push(&queue, &element));
+            ASSERT_TRUE(visualizer_queue_pop(&queue, &element));
+        }
+        ASSERT_TRUE(visualizer_queue_pop(&queue, &element));
+        EXPECT_TRUE(valid_element(element));
+    }
+    EXPECT_EQ(visualizer_queue_count(&queue), 0);
+}
+
+#define STRESS_ELEMENTS 2000000
+
+static void *stress_producer(void *arg) {
+    visualizer_queue_t *queue = (visualizer_queue_t *)arg;
+    for (uint32_t i = 0; i < STRESS_ELEMENTS;) {
+        element_t element = make_element(i);
+        if (visualizer_queue_push(queue, &element)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// The main loop and the visualizer thread hammering the queue from two threads,
+// every element has to arrive exactly once, in order and intact
+TEST_F(VisualizerQueue, StressTwoThreads) {
+    pthread_t producer;
+    ASSERT_EQ(pthread_create(&producer, NULL, stress_producer, &queue), 0);
+
+    uint32_t expected = 0;
+    uint32_t failures = 0;
+    while (expected < STRESS_ELEMENTS) {
+        element_t element;
+        if (!visualizer_queue_pop(&queue, &element)) {
+            sched_yield();
+            continue;
+        }
+        if (element.sequence != expected || !valid_element(element)) {
+            failures++;
+        }
+        expected = element.sequence + 1;
+    }
+    pthread_join(producer, NULL);
+
+    EXPECT_EQ(failures, 0u);
+    element_t element;
+    EXPECT_FALSE(visualizer_queue_pop(&queue, &element));
+}
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "config.h"
 #include "visualizer.h"
+#include "visualizer_queue.h"
 #include <string.h>
 #ifdef PROTOCOL_CHIBIOS
 #    include "ch.h"
@@ -56,6 +57,13 @@ SOFTWARE.
 #    define VISUALIZER_THREAD_PRIORITY (NORMAL_PRIORITY - 2)
 #endif
 
+// Status changes and key events that can wait for the visualizer thread, a power of two
+#ifndef VISUALIZER_EVENT_QUEUE_SIZE
+#    define VISUALIZER_EVENT_QUEUE_SIZE 16
+#endif
+// visualizer_queue_t indexes with uint8_t counters masked by capacity - 1
+_Static_assert(VISUALIZER_EVENT_QUEUE_SIZE > 0 && (VISUALIZER_EVENT_QUEUE_SIZE & (VISUALIZER_EVENT_QUEUE_SIZE - 1)) == 0 && VISUALIZER_EVENT_QUEUE_SIZE <= 128, "VISUALIZER_EVENT_QUEUE_SIZE must be a power of two no larger than 128");
+
 static visualizer_keyboard_status_t current_status = {.layer         = 0xFFFFFFFF,
                                                       .default_layer = 0xFFFFFFFF,
                                                       .leds          = 0xFFFFFFFF,
@@ -82,6 +90,11 @@ static bool same_status(visualizer_keyboard_status_t* status1, visualizer_keyboa
 
 static bool visualizer_enabled = false;
 
+static visualizer_event_t event_storage[VISUALIZER_EVENT_QUEUE_SIZE];
+static visualizer_queue_t event_queue = VISUALIZER_QUEUE_INIT(event_storage);
+// The last status change did not fit in the queue and has to be sent again
+static bool status_pending = false;
+
 #ifdef VISUALIZER_USER_DATA_SIZE
 static uint8_t user_data[VISUALIZER_USER_DATA_SIZE];
 #endif
@@ -235,7 +248,7 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
 
     GListener event_listener;
     geventListenerInit(&event_listener);
-    geventAttachSource(&event_listener, (GSourceHandle)&current_status, 0);
+    geventAttachSource(&event_listener, (GSourceHandle)&event_queue, 0);
 
     visualizer_keyboard_status_t initial_status = {
         .default_layer = 0xFFFFFFFF,
@@ -265,6 +278,9 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
     lcd_backlight_color(LCD_HUE(state.current_lcd_color), LCD_SAT(state.current_lcd_color), LCD_INT(state.current_lcd_color));
 #endif
 
+    // The newest status taken off the queue, the main loop keeps its own copy
+    visualizer_keyboard_status_t latest_status = initial_status;
+
     systemticks_t sleep_time   = TIME_INFINITE;
     systemticks_t current_time = gfxSystemTicks();
     bool          force_update = true;
@@ -274,35 +290,52 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
         systemticks_t delta    = new_time - current_time;
         current_time           = new_time;
         bool enabled           = visualizer_enabled;
-        if (force_update || !same_status(&state.status, &current_status)) {
-            force_update = false;
-#if BACKLIGHT_ENABLE
-            if (current_status.backlight_level != state.status.backlight_level) {
-                if (current_status.backlight_level != 0) {
-                    gdispGSetPowerMode(LED_DISPLAY, powerOn);
-                    uint16_t percent = (uint16_t)current_status.backlight_level * 100 / BACKLIGHT_LEVELS;
-                    gdispGSetBacklight(LED_DISPLAY, percent);
-                } else {
-                    gdispGSetPowerMode(LED_DISPLAY, powerOff);
+
+        // Handle every queued change in order, so no layer or mod change is skipped
+        visualizer_event_t event;
+        bool               have_event;
+        do {
+            have_event = visualizer_queue_pop(&event_queue, &event);
+            if (have_event && event.type == VISUALIZER_EVENT_KEY) {
+                if (visualizer_enabled) {
+                    user_visualizer_key_event(&state, event.key);
                 }
-                state.status.backlight_level = current_status.backlight_level;
+                continue;
+            }
+            if (have_event) {
+                latest_status = event.status;
             }
+            if (force_update || (have_event && !same_status(&state.status, &latest_status))) {
+                force_update = false;
+#if BACKLIGHT_ENABLE
+                if (latest_status.backlight_level != state.status.backlight_level) {
+                    if (latest_status.backlight_level != 0) {
+                        gdispGSetPowerMode(LED_DISPLAY, powerOn);
+                        uint16_t percent = (uint16_t)latest_status.backlight_level * 100 / BACKLIGHT_LEVELS;
+                        gdispGSetBacklight(LED_DISPLAY, percent);
+                    } else {
+                        gdispGSetPowerMode(LED_DISPLAY, powerOff);
+                    }
+                    state.status.backlight_level = latest_status.backlight_level;
+                }
 #endif
-            if (visualizer_enabled) {
-                if (current_status.suspended) {
-                    stop_all_keyframe_animations();
-                    visualizer_enabled = false;
-                    state.status       = current_status;
-                    user_visualizer_suspend(&state);
-                } else {
-                    visualizer_keyboard_status_t prev_status = state.status;
-                    state.status                             = current_status;
-                    update_user_visualizer_state(&state, &prev_status);
+                if (visualizer_enabled) {
+                    if (latest_status.suspended) {
+                        stop_all_keyframe_animations();
+                        visualizer_enabled = false;
+                        state.status       = latest_status;
+                        user_visualizer_suspend(&state);
+                    } else {
+                        visualizer_keyboard_status_t prev_status = state.status;
+                        state.status                             = latest_status;
+                        update_user_visualizer_state(&state, &prev_status);
+                    }
+                    state.prev_lcd_color = state.current_lcd_color;
                 }
-                state.prev_lcd_color = state.current_lcd_color;
             }
-        }
-        if (!enabled && state.status.suspended && current_status.suspended == false) {
+        } while (have_event);
+
+        if (!enabled && state.status.suspended && latest_status.suspended == false) {
             // Setting the status to the initial status will force an update
             // when the visualizer is enabled again
             state.status           = initial_status;
@@ -389,12 +422,21 @@ void visualizer_init(void) {
     gfxThreadCreate(visualizerThreadStack, sizeof(visualizerThreadStack), VISUALIZER_THREAD_PRIORITY, visualizerThread, NULL);
 }
 
+__attribute__((weak)) void user_visualizer_key_event(visualizer_state_t* state, keyevent_t event) {}
+
+static void wake_visualizer(void) {
+    GSourceListener* listener = geventGetSourceListener((GSourceHandle)&event_queue, NULL);
+    if (listener) {
+        geventSendEvent(listener);
+    }
+}
+
 void update_status(bool changed) {
-    if (changed) {
-        GSourceListener* listener = geventGetSourceListener((GSourceHandle)&current_status, NULL);
-        if (listener) {
-            geventSendEvent(listener);
-        }
+    if (changed || status_pending) {
+        visualizer_event_t event = {.type = VISUALIZER_EVENT_STATUS, .status = current_status};
+        // When the thread is behind, the newest status is sent once there is room again
+        status_pending = !visualizer_queue_push(&event_queue, &event);
+        wake_visualizer();
     }
 #ifdef SERIAL_LINK_ENABLE
     static systime_t last_update    = 0;
@@ -425,11 +467,7 @@ void visualizer_set_user_data(void* u) { memcpy(user_data, u, VISUALIZER_USER_DA
 #endif
 
 void visualizer_update(layer_state_t default_state, layer_state_t state, uint8_t mods, uint32_t leds) {
-    // Note that there's a small race condition here, the thread could read
-    // a state where one of these are set but not the other. But this should
-    // not really matter as it will be fixed during the next loop step.
-    // Alternatively a mutex could be used instead of the volatile variables
-
+    // current_status belongs to the main loop, the thread only gets copies through the queue
     bool changed = false;
 #ifdef SERIAL_LINK_ENABLE
     if (is_serial_link_connected()) {
@@ -465,6 +503,14 @@ void visualizer_update(layer_state_t default_state, layer_state_t state, uint8_t
     update_status(changed);
 }
 
+void visualizer_key_event(keyevent_t key) {
+    // A key event is dropped when the queue is full, there is no later state to catch up to
+    visualizer_event_t event = {.type = VISUALIZER_EVENT_KEY, .key = key};
+    if (visualizer_queue_push(&event_queue, &event)) {
+        wake_visualizer();
+    }
+}
+
 void visualizer_suspend(void) {
     current_status.suspended = true;
     update_status(true);
@@ -48,6 +48,9 @@ void visualizer_init(void);
 // This should be called at every matrix scan
 void visualizer_update(layer_state_t default_state, layer_state_t state, uint8_t mods, uint32_t leds);
 
+// This is called by action_exec for every key press and release
+void visualizer_key_event(keyevent_t event);
+
 // This should be called when the keyboard goes to suspend state
 void visualizer_suspend(void);
 // This should be called when the keyboard wakes up from suspend state
@@ -82,6 +85,21 @@ typedef struct {
 #endif
 } visualizer_keyboard_status_t;
 
+// Everything the main loop hands over to the visualizer thread goes through
+// a lock-free queue of these, so each change and key press is seen exactly once
+typedef enum {
+    VISUALIZER_EVENT_STATUS,
+    VISUALIZER_EVENT_KEY,
+} visualizer_event_type_t;
+
+typedef struct {
+    uint8_t type;
+    union {
+        visualizer_keyboard_status_t status;
+        keyevent_t                   key;
+    };
+} visualizer_event_t;
+
 // The state struct is used by the various keyframe functions
 // It's also used for setting the LCD color and layer text
 // from the user customized code
@@ -152,5 +170,7 @@ void user_visualizer_suspend(visualizer_state_t* state);
 void initialize_user_visualizer(visualizer_state_t* state);
 // Called when the computer resumes from a suspend
 void user_visualizer_resume(visualizer_state_t* state);
+// Optional, called once for every key press and release while the visualizer is enabled
+void user_visualizer_key_event(visualizer_state_t* state, keyevent_t event);
 
 #endif /* VISUALIZER_H */
@@ -0,0 +1,46 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include "visualizer_queue.h"
+
+bool visualizer_queue_push(visualizer_queue_t* queue, const void* element) {
+    uint8_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    uint8_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    if ((uint8_t)(head - tail) >= queue->capacity) {
+        return false;
+    }
+
+    memcpy(&queue->buffer[(head & (queue->capacity - 1)) * queue->element_size], element, queue->element_size);
+    __atomic_store_n(&queue->head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool visualizer_queue_pop(visualizer_queue_t* queue, void* element) {
+    uint8_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    uint8_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return false;
+    }
+
+    memcpy(element, &queue->buffer[(tail & (queue->capacity - 1)) * queue->element_size], queue->element_size);
+    // the slot can only be reused once the copy above has finished
+    __atomic_store_n(&queue->tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t visualizer_queue_count(visualizer_queue_t* queue) { return __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE); }
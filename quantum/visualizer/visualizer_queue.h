@@ -0,0 +1,51 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QUANTUM_VISUALIZER_VISUALIZER_QUEUE_H_
+#define QUANTUM_VISUALIZER_VISUALIZER_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Single producer, single consumer ring of fixed size elements.
+ *
+ * The main loop pushes and the visualizer thread pops, without any locking.
+ * Each side only writes its own index, and an element is copied in before
+ * head is published with release ordering, so the consumer never sees a
+ * half written element. The capacity has to be a power of two up to 128.
+ */
+typedef struct {
+    uint8_t* buffer;
+    uint16_t element_size;
+    uint8_t  capacity;
+    uint8_t  head;  // written by the producer only
+    uint8_t  tail;  // written by the consumer only
+} visualizer_queue_t;
+
+#define VISUALIZER_QUEUE_INIT(storage) \
+    { .buffer = (uint8_t*)(storage), .element_size = sizeof((storage)[0]), .capacity = sizeof(storage) / sizeof((storage)[0]), .head = 0, .tail = 0 }
+
+// Producer side, returns false and leaves the queue alone when it is full
+bool visualizer_queue_push(visualizer_queue_t* queue, const void* element);
+
+// Consumer side, returns false when there is nothing to read
+bool visualizer_queue_pop(visualizer_queue_t* queue, void* element);
+
+// Either side, the answer can be stale by the time it is used
+uint8_t visualizer_queue_count(visualizer_queue_t* queue);
+
+#endif /* QUANTUM_VISUALIZER_VISUALIZER_QUEUE_H_ */
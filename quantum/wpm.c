@@ -20,7 +20,7 @@
 // WPM Stuff
 static uint8_t  current_wpm = 0;
 static uint8_t  latest_wpm  = 0;
-static uint16_t wpm_timer   = 0;
+static uint32_t wpm_timer   = 0;
 
 // This smoothing is 40 keystrokes
 static const float wpm_smoothing = 0.0487;
@@ -48,17 +48,19 @@ __attribute__((weak)) bool wpm_keycode_user(uint16_t keycode) {
 
 void update_wpm(uint16_t keycode) {
     if (wpm_keycode(keycode)) {
-        if (wpm_timer > 0) {
-            latest_wpm  = 60000 / timer_elapsed(wpm_timer) / 5;
+        uint32_t elapsed = timer_scan_elapsed32(wpm_timer);
+        // Keys processed within the same scan share a timestamp
+        if (wpm_timer > 0 && elapsed > 0) {
+            latest_wpm  = 60000 / elapsed / 5;
             current_wpm = (latest_wpm - current_wpm) * wpm_smoothing + current_wpm;
         }
-        wpm_timer = timer_read();
+        wpm_timer = timer_scan_read32();
     }
 }
 
 void decay_wpm(void) {
-    if (timer_elapsed(wpm_timer) > 1000) {
+    if (timer_scan_elapsed32(wpm_timer) > 1000) {
         current_wpm = (0 - current_wpm) * wpm_smoothing + current_wpm;
-        wpm_timer   = timer_read();
+        wpm_timer   = timer_scan_read32();
     }
 }
@@ -0,0 +1,48 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "quantum.h"
+
+// Don't rearrange keys as the tests rely on the order
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            {TD(0), TD(1), KC_X, KC_Y, KC_A, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
+
+const uint16_t PROGMEM test_combo[] = {KC_X, KC_Y, COMBO_END};
+combo_t                key_combos[COMBO_COUNT] = {COMBO(test_combo, KC_Z)};
+
+uint8_t  td_finished_count = 0;
+uint16_t td_finished_time  = 0;
+uint16_t td_pressed_time   = 0;
+
+void td_finished(qk_tap_dance_state_t *state, void *user_data) {
+    td_finished_count++;
+    td_finished_time = timer_read();
+    td_pressed_time  = state->timer;
+}
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_C, KC_D),
+    [1] = ACTION_TAP_DANCE_FN_ADVANCED_TIME(NULL, td_finished, NULL, 100),
+};
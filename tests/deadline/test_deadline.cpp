@@ -0,0 +1,200 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtLeast;
+using testing::Mock;
+
+extern "C" {
+extern uint8_t  td_finished_count;
+extern uint16_t td_finished_time;
+extern uint16_t td_pressed_time;
+void            set_time(uint32_t t);
+void            advance_time(uint32_t ms);
+}
+
+static deadline_t  a, b, c;
+static uint8_t     fired_count;
+static deadline_t *fired[3];
+
+static void record_deadline(deadline_t *deadline) { fired[fired_count++] = deadline; }
+
+static uint32_t repeat_times[3];
+
+static void repeat_deadline(deadline_t *deadline) {
+    repeat_times[fired_count++] = timer_scan_read32();
+    if (fired_count < 3) {
+        deadline_set_at(deadline, repeat_deadline, deadline->expires + 10);
+    }
+}
+
+class Deadline : public TestFixture {
+   public:
+    Deadline() {
+        deadline_cancel(&a);
+        deadline_cancel(&b);
+        deadline_cancel(&c);
+        td_finished_count = fired_count = 0;
+    }
+
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(Deadline, FiresInExpiryOrder) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    deadline_set(&a, record_deadline, 30);
+    deadline_set(&b, record_deadline, 10);
+    deadline_set(&c, record_deadline, 20);
+    EXPECT_TRUE(deadline_is_active(&a));
+    idle_for(11);
+    EXPECT_EQ(fired_count, 0);
+    idle_for(1);
+    EXPECT_EQ(fired_count, 1);
+    EXPECT_FALSE(deadline_is_active(&b));
+    idle_for(20);
+    ASSERT_EQ(fired_count, 3);
+    EXPECT_EQ(fired[0], &b);
+    EXPECT_EQ(fired[1], &c);
+    EXPECT_EQ(fired[2], &a);
+}
+
+TEST_F(Deadline, CancelAndRearm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    deadline_set(&a, record_deadline, 10);
+    deadline_set(&b, record_deadline, 10);
+    deadline_cancel(&a);
+    EXPECT_FALSE(deadline_is_active(&a));
+    idle_for(5);
+    // Re-arming restarts the countdown, from the scan it happens in
+    timer_scan_update();
+    deadline_set(&b, record_deadline, 10);
+    idle_for(11);
+    EXPECT_EQ(fired_count, 0);
+    idle_for(1);
+    ASSERT_EQ(fired_count, 1);
+    EXPECT_EQ(fired[0], &b);
+}
+
+TEST_F(Deadline, RepeatsWithoutDrift) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    timer_scan_update();
+    uint32_t start = timer_scan_read32();
+    deadline_set_at(&a, repeat_deadline, start + 10);
+    // A slow scan runs the first repeat late
+    advance_time(14);
+    idle_for(17);
+    ASSERT_EQ(fired_count, 3);
+    EXPECT_EQ(repeat_times[0], start + 14);
+    EXPECT_EQ(repeat_times[1], start + 20);
+    EXPECT_EQ(repeat_times[2], start + 30);
+}
+
+TEST_F(Deadline, SurvivesTimerWraparound) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    set_time(0xFFF0);
+    timer_scan_update();
+    deadline_set(&a, record_deadline, 0x20);
+    deadline_set(&b, record_deadline, 0x08);
+    idle_for(0x21);
+    ASSERT_EQ(fired_count, 1);
+    EXPECT_EQ(fired[0], &b);
+    idle_for(1);
+    ASSERT_EQ(fired_count, 2);
+    EXPECT_EQ(fired[1], &a);
+}
+
+TEST_F(Deadline, TapDanceFinishesOnceTermHasElapsed) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap(1);
+    idle_for(99);
+    EXPECT_EQ(td_finished_count, 0);
+    idle_for(1);
+    EXPECT_EQ(td_finished_count, 1);
+    // Same point in time as the old polled "timer_elapsed(timer) > term" check
+    EXPECT_EQ((uint16_t)(td_finished_time - td_pressed_time), 101);
+    idle_for(200);
+    EXPECT_EQ(td_finished_count, 1);
+}
+
+TEST_F(Deadline, InterruptedTapDanceIsNotFinishedAgain) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap(1);
+    tap(4);
+    EXPECT_EQ(td_finished_count, 1);
+    idle_for(200);
+    EXPECT_EQ(td_finished_count, 1);
+}
+
+TEST_F(Deadline, TapDanceRegistersAfterTappingTerm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C))).Times(0);
+    tap(0);
+    idle_for(TAPPING_TERM - 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    idle_for(1);
+}
+
+TEST_F(Deadline, ComboTimeoutReleasesBufferedKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(2, 0);
+    run_one_scan_loop();
+    idle_for(COMBO_TERM);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X))).Times(AtLeast(1));
+    idle_for(1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(2, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(Deadline, ComboPressedWithinTerm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    press_key(2, 0);
+    run_one_scan_loop();
+    idle_for(COMBO_TERM - 1);
+    press_key(3, 0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    release_key(2, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+}
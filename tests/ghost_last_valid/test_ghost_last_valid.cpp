@@ -0,0 +1,121 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class GhostLastValid : public TestFixture {};
+
+TEST_F(GhostLastValid, GhostRectangleKeepsItsLastValidState) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // C goes down and D reads as down with it, neither can be trusted
+    press_key(0, 1);
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The rest of the row still works
+    press_key(5, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_E)));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // C and D were never reported, so their release isn't either
+    release_key(0, 1);
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(5, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(GhostLastValid, KeysHeldThroughAGhostAreReleased) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // D really is pressed, and turns the other three into corners of a rectangle
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Releasing A breaks the rectangle, and D shows up
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C, KC_D)));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    release_key(0, 1);
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(GhostLastValid, KeysSharingOneColumnAreNotGhosts) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(1, 2);
+    press_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_F, KC_G)));
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(1, 2);
+    release_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
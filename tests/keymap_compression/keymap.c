@@ -0,0 +1,83 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// Generated with `qmk json2c --compress`, lib/python/qmk/tests/test_qmk_keymap.py checks it against keymaps_reference below.
+// Don't rearrange keys as the tests rely on the order
+
+const uint16_t PROGMEM keymap_compressed_keycodes[] = {
+    // Layer 0
+    KC_A, KC_B, KC_NO, KC_LSFT, KC_RSFT, KC_LCTL, MO(1), SFT_T(KC_P), TG(2), KC_NO, KC_EQL, KC_PLUS, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_Q, KC_W, KC_E, KC_R, KC_T, KC_Y, KC_U, KC_I, KC_O, KC_P, KC_C, KC_D, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_SPC,
+    // Layer 1
+    KC_1, KC_F1, KC_F10, LT(3, KC_ENT),
+    // Layer 2
+    // Layer 3
+    KC_X, KC_NO, KC_Z,
+};
+
+const keymap_compressed_layer_t PROGMEM keymap_compressed_layers[] = {
+    [0] = {
+        .presence = {0x03ff, 0x03ff, 0x03ff, 0x03ff},
+        .offset   = {0, 10, 20, 30},
+    },
+    [1] = {
+        .presence = {0x0002, 0x0000, 0x0201, 0x0200},
+        .offset   = {40, 41, 41, 43},
+    },
+    [2] = {
+        .presence = {0x0000, 0x0000, 0x0000, 0x0000},
+        .offset   = {44, 44, 44, 44},
+    },
+    [3] = {
+        .presence = {0x0001, 0x0000, 0x0010, 0x0200},
+        .offset   = {44, 45, 45, 46},
+    },
+};
+
+const uint8_t keymap_compressed_layer_count = sizeof(keymap_compressed_layers) / sizeof(keymap_compressed_layers[0]);
+
+/* Uncompressed copy of the keymap above, used as the reference by the tests */
+const uint16_t keymaps_reference[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            {KC_A, KC_B, KC_NO, KC_LSFT, KC_RSFT, KC_LCTL, MO(1), SFT_T(KC_P), TG(2), KC_NO},
+            {KC_EQL, KC_PLUS, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_Q, KC_W, KC_E, KC_R, KC_T, KC_Y, KC_U, KC_I, KC_O, KC_P},
+            {KC_C, KC_D, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_SPC},
+        },
+    [1] =
+        {
+            {_______, KC_1, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {KC_F1, _______, _______, _______, _______, _______, _______, _______, _______, KC_F10},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, LT(3, KC_ENT)},
+        },
+    [2] =
+        {
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+        },
+    [3] =
+        {
+            {KC_X, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, KC_NO, _______, _______, _______, _______, _______},
+            {_______, _______, _______, _______, _______, _______, _______, _______, _______, KC_Z},
+        },
+};
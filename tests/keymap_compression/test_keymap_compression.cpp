@@ -0,0 +1,64 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+
+extern "C" {
+extern const uint16_t keymaps_reference[][MATRIX_ROWS][MATRIX_COLS];
+}
+
+class KeymapCompression : public TestFixture {};
+
+TEST_F(KeymapCompression, EveryKeyMatchesTheUncompressedKeymap) {
+    for (uint8_t layer = 0; layer < keymap_compressed_layer_count; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                EXPECT_EQ(keymap_key_to_keycode(layer, key), keymaps_reference[layer][row][col]) << "layer " << (int)layer << " row " << (int)row << " col " << (int)col;
+            }
+        }
+    }
+}
+
+TEST_F(KeymapCompression, LayersPastTheEndAreTransparent) {
+    keypos_t key = {.col = 0, .row = 0};
+    EXPECT_EQ(keymap_key_to_keycode(keymap_compressed_layer_count, key), KC_TRNS);
+}
+
+TEST_F(KeymapCompression, TransparentKeysFallThroughToLowerLayers) {
+    TestDriver driver;
+    press_key(6, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    keyboard_task();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    keyboard_task();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    release_key(6, 0);
+    // Nothing changed for the host
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+}
@@ -0,0 +1,25 @@
+#include "quantum.h"
+
+/* THIS FILE WAS GENERATED!
+ *
+ * This file was generated by qmk leader2c. You may or may not want to
+ * edit it directly.
+ */
+
+void leader_a(void);
+void leader_ba(void);
+void leader_bac(void);
+
+const uint16_t PROGMEM leader_dictionary_trie[] = {
+	2, 0, KC_A, 6, KC_B, 8,
+	0, 1,
+	1, 0, KC_A, 12,
+	1, 2, KC_C, 16,
+	0, 3,
+};
+
+const leader_action_t PROGMEM leader_dictionary_actions[] = {
+	leader_a,
+	leader_ba,
+	leader_bac,
+};
@@ -0,0 +1,113 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::AnyNumber;
+
+extern "C" {
+extern uint8_t leader_a_count;
+extern uint8_t leader_ba_count;
+extern uint8_t leader_bac_count;
+extern uint8_t leader_end_count;
+LEADER_EXTERNS();
+}
+
+class LeaderDictionary : public TestFixture {
+   public:
+    LeaderDictionary() { leader_a_count = leader_ba_count = leader_bac_count = leader_end_count = 0; }
+
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(LeaderDictionary, UnambiguousSequenceFiresWithoutTimeout) {
+    TestDriver driver;
+    // Key releases are still reported, but no key is ever pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap(0);
+    tap(1);
+    EXPECT_EQ(leader_a_count, 1);
+    EXPECT_EQ(leader_end_count, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(LeaderDictionary, PrefixOfLongerSequenceFiresAfterTimeout) {
+    TestDriver driver;
+    // Key releases are still reported, but no key is ever pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap(0);
+    tap(2);
+    tap(1);
+    EXPECT_EQ(leader_ba_count, 0);
+    EXPECT_TRUE(leading);
+    idle_for(LEADER_TIMEOUT);
+    EXPECT_EQ(leader_ba_count, 1);
+    EXPECT_EQ(leader_a_count, 0);
+    EXPECT_EQ(leader_end_count, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(LeaderDictionary, LongestSequenceFiresImmediately) {
+    TestDriver driver;
+    // Key releases are still reported, but no key is ever pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap(0);
+    tap(2);
+    tap(1);
+    tap(3);
+    EXPECT_EQ(leader_bac_count, 1);
+    EXPECT_EQ(leader_ba_count, 0);
+    EXPECT_EQ(leader_end_count, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(LeaderDictionary, InvalidPrefixAbortsImmediately) {
+    TestDriver driver;
+    // Key releases are still reported, but no key is ever pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap(0);
+    tap(3);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(leader_end_count, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The next key is typed normally
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_EQ(leader_a_count, 0);
+}
+
+TEST_F(LeaderDictionary, SequenceIsRecorded) {
+    TestDriver driver;
+    // Key releases are still reported, but no key is ever pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap(0);
+    tap(2);
+    tap(1);
+    EXPECT_EQ(leader_sequence_size, 2);
+    EXPECT_EQ(leader_sequence[0], KC_B);
+    EXPECT_EQ(leader_sequence[1], KC_A);
+    idle_for(LEADER_TIMEOUT);
+}
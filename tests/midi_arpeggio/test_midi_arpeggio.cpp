@@ -0,0 +1,92 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "qmk_midi.h"
+#include "bytequeue/interrupt_setting.h"
+}
+
+using testing::_;
+
+typedef std::vector<uint8_t> packet_t;
+
+static std::vector<packet_t> note_ons;
+
+MidiDevice midi_device;
+
+extern "C" void send_midi_packets(const uint8_t *data, uint8_t length) {
+    for (uint8_t i = 0; i < length; i += MIDI_EVENT_PACKET_SIZE) {
+        if ((data[i + 1] & 0xF0) == 0x90) {
+            note_ons.push_back(packet_t(data + i, data + i + MIDI_EVENT_PACKET_SIZE));
+        }
+    }
+}
+
+// The host has no interrupts to mask around the MIDI input queue
+interrupt_setting_t store_and_clear_interrupt(void) { return 0; }
+void                restore_interrupt_setting(interrupt_setting_t setting) {}
+
+static void queue_send(MidiDevice *device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) { midi_queue_add(cnt, byte0, byte1, byte2); }
+
+enum { ARP, C, E };
+
+class MidiArpeggio : public TestFixture {
+   public:
+    void SetUp() override {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+        midi_device.send_func = queue_send;
+        note_ons.clear();
+    }
+
+    TestDriver driver;
+
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    void press_both(void) {
+        press_key(C, 0);
+        run_one_scan_loop();
+        press_key(E, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(MidiArpeggio, TonesPlayTogetherByDefault) {
+    press_both();
+    EXPECT_EQ(note_ons.size(), 2);
+}
+
+TEST_F(MidiArpeggio, ArpKeycodeTurnsTheArpeggiatorOn) {
+    tap(ARP);
+    press_both();
+    // The first tone sounds right away, the second waits for the next step
+    ASSERT_EQ(note_ons.size(), 1);
+    idle_for(MIDI_ARPEGGIO_INTERVAL);
+    ASSERT_EQ(note_ons.size(), 2);
+    EXPECT_NE(note_ons[0][2], note_ons[1][2]);
+
+    release_key(C, 0);
+    release_key(E, 0);
+    run_one_scan_loop();
+    tap(ARP);
+}
@@ -0,0 +1,170 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "keyboard.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::Invoke;
+
+class MousekeyKinematic : public TestFixture {
+   public:
+    void record(TestDriver &driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t &report) {
+            if (report.x || report.y || report.v || report.h) {
+                moves.push_back(report);
+            }
+            last_buttons = report.buttons;
+            total_x += report.x;
+            total_y += report.y;
+            total_v += report.v;
+        }));
+    }
+
+    std::vector<report_mouse_t> moves;
+    uint8_t                     last_buttons = 0;
+    int32_t                     total_x      = 0;
+    int32_t                     total_y      = 0;
+    int32_t                     total_v      = 0;
+};
+
+TEST_F(MousekeyKinematic, HeldKeyAcceleratesToTheBaseSpeed) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    idle_for(1000);
+    release_key(0, 0);
+    run_one_scan_loop();
+
+    // 0.6s from 100 to 1000 pixels/s, then 0.4s at 1000 pixels/s
+    EXPECT_NEAR(total_x, 330 + 400, 1);
+    EXPECT_EQ(total_y, 0);
+    // Smooth: no frame moves less than the one before while accelerating
+    for (size_t i = 1; i < moves.size(); i++) {
+        EXPECT_GE(moves[i].x, moves[i - 1].x - 1);
+    }
+}
+
+TEST_F(MousekeyKinematic, MotionDoesNotDependOnTheScanRate) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    // A slow scan, 3ms apart, up to 1000ms after the press
+    for (int i = 0; i < 334; i++) {
+        keyboard_task();
+        advance_time(3);
+    }
+    release_key(0, 0);
+    run_one_scan_loop();
+
+    EXPECT_NEAR(total_x, 330 + 400, 2);
+}
+
+TEST_F(MousekeyKinematic, AccelerationKeyMovesAtAConstantSpeed) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(3, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    idle_for(1000);
+    release_key(0, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+
+    EXPECT_EQ(total_x, 500);
+    ASSERT_EQ(moves.size(), 1000 / 8);
+    for (auto &report : moves) {
+        EXPECT_EQ(report.x, 4);
+    }
+}
+
+TEST_F(MousekeyKinematic, DiagonalsAreNormalized) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(3, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    press_key(1, 0);
+    run_one_scan_loop();
+    idle_for(1000);
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+
+    // 500 pixels/s along the diagonal, fractions of a pixel included
+    EXPECT_NEAR(total_x, 354, 1);
+    EXPECT_NEAR(total_y, 354, 1);
+}
+
+TEST_F(MousekeyKinematic, WheelAccelerates) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(4, 0);
+    run_one_scan_loop();
+    idle_for(1000);
+    release_key(4, 0);
+    run_one_scan_loop();
+
+    // 0.8s from 8 to 40 steps/s, then 0.2s at 40 steps/s
+    EXPECT_NEAR(total_v, -(19 + 8), 1);
+    EXPECT_EQ(total_x, 0);
+}
+
+TEST_F(MousekeyKinematic, StopsWhenReleasedOrOpposed) {
+    TestDriver driver;
+    record(driver);
+
+    press_key(1, 0);
+    run_one_scan_loop();
+    idle_for(100);
+    EXPECT_GT(total_y, 0);
+
+    // Up and down together cancel out
+    press_key(2, 0);
+    run_one_scan_loop();
+    int32_t y = total_y;
+    idle_for(100);
+    EXPECT_LE(total_y - y, 1);
+
+    release_key(1, 0);
+    release_key(2, 0);
+    run_one_scan_loop();
+    size_t count = moves.size();
+    idle_for(100);
+    EXPECT_EQ(moves.size(), count);
+
+    // Buttons still go out right away
+    press_key(5, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(last_buttons, MOUSE_BTN1);
+    release_key(5, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(last_buttons, 0);
+}
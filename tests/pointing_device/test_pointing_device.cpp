@@ -0,0 +1,162 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+}
+
+using testing::_;
+using testing::Invoke;
+
+// What the sensor reports on the next scan
+static int16_t sensor_x;
+static int16_t sensor_y;
+static int16_t sensor_v;
+static bool    legacy_sensor;
+
+extern "C" void pointing_device_task(void) {
+    if (legacy_sensor) {
+        // The way boards fill in the report themselves
+        report_mouse_t report = pointing_device_get_report();
+        report.x              = sensor_x;
+        report.y              = sensor_y;
+        pointing_device_set_report(report);
+    } else {
+        pointing_device_move(sensor_x, sensor_y);
+        pointing_device_scroll(sensor_v, 0);
+    }
+    pointing_device_send();
+}
+
+class PointingDevice : public TestFixture {
+   public:
+    void SetUp() override {
+        sensor_x = sensor_y = sensor_v = 0;
+        legacy_sensor                  = false;
+    }
+
+    void TearDown() override {
+        // Drain the accumulators, so every test starts from nothing
+        TestDriver driver;
+        sensor_x = sensor_y = sensor_v = 0;
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(testing::AnyNumber());
+        report_mouse_t report = pointing_device_get_report();
+        report.buttons        = 0;
+        pointing_device_set_report(report);
+        idle_for(2000);
+    }
+
+    void record(TestDriver &driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t &report) {
+            reports.push_back(report);
+            total_x += report.x;
+            total_y += report.y;
+            total_v += report.v;
+        }));
+    }
+
+    std::vector<report_mouse_t> reports;
+    int32_t                     total_x = 0;
+    int32_t                     total_y = 0;
+    int32_t                     total_v = 0;
+};
+
+TEST_F(PointingDevice, HighSpeedMotionIsPreserved) {
+    TestDriver driver;
+    record(driver);
+
+    // Far more than 8 bits per report, and more than 16 bits per report interval
+    sensor_x = 3000;
+    sensor_y = -1234;
+    idle_for(100);
+    sensor_x = sensor_y = 0;
+    idle_for(500);
+
+    EXPECT_EQ(total_x, 100 * 3000 * 3 / 2);
+    EXPECT_EQ(total_y, 100 * -1234 * 3 / 2);
+    for (auto &report : reports) {
+        EXPECT_GE(report.x, MOUSE_REPORT_XY_MIN);
+        EXPECT_LE(report.x, MOUSE_REPORT_XY_MAX);
+    }
+    // The first report goes out right away, the next one is clamped and carries the rest over
+    EXPECT_EQ(reports[0].x, 4500);
+    EXPECT_EQ(reports[1].x, MOUSE_REPORT_XY_MAX);
+}
+
+TEST_F(PointingDevice, FractionsCarryOver) {
+    TestDriver driver;
+    record(driver);
+
+    // 1.5 counts per scan, scrolling isn't scaled
+    sensor_x = 1;
+    sensor_v = -1;
+    idle_for(64);
+    sensor_x = sensor_v = 0;
+    idle_for(100);
+
+    EXPECT_EQ(total_x, 96);
+    EXPECT_EQ(total_v, -64);
+    EXPECT_EQ(total_y, 0);
+}
+
+TEST_F(PointingDevice, ReportsArePacedIndependentlyOfScans) {
+    TestDriver driver;
+    record(driver);
+
+    sensor_x = 10;
+    idle_for(80);
+    sensor_x = 0;
+
+    // One report every 8 scans instead of one per scan
+    EXPECT_EQ(reports.size(), 10);
+    idle_for(100);
+    EXPECT_EQ(total_x, 80 * 15);
+}
+
+TEST_F(PointingDevice, ButtonsAreNotDelayed) {
+    TestDriver driver;
+    record(driver);
+
+    sensor_x = 2;
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 1);
+
+    report_mouse_t report = pointing_device_get_report();
+    report.buttons        = MOUSE_BTN1;
+    pointing_device_set_report(report);
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 2);
+    EXPECT_EQ(reports[1].buttons, MOUSE_BTN1);
+    EXPECT_EQ(reports[1].x, 3);
+}
+
+TEST_F(PointingDevice, ReportsFilledInByTheBoardArePreserved) {
+    TestDriver driver;
+    record(driver);
+
+    legacy_sensor = true;
+    sensor_x      = 100;
+    sensor_y      = -7;
+    idle_for(40);
+    sensor_x = sensor_y = 0;
+    idle_for(100);
+
+    EXPECT_EQ(total_x, 40 * 150);
+    EXPECT_EQ(total_y, 40 * -7 * 3 / 2);
+}
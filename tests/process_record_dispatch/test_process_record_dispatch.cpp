@@ -0,0 +1,71 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+
+extern "C" {
+extern uint32_t process_record_user_calls;
+}
+
+class ProcessRecordDispatch : public TestFixture {};
+
+static keyrecord_t make_record(uint8_t col, uint8_t row, bool pressed) {
+    keyrecord_t record = {};
+    record.event.key     = (keypos_t){.col = col, .row = row};
+    record.event.pressed = pressed;
+    record.event.time    = timer_read() | 1;
+    return record;
+}
+
+TEST_F(ProcessRecordDispatch, BasicKeycodesReachHandlersForAnyKeycode) {
+    TestDriver driver;
+    uint32_t   calls = process_record_user_calls;
+    keyrecord_t press   = make_record(5, 0, true);
+    keyrecord_t release = make_record(5, 0, false);
+    EXPECT_TRUE(process_record_quantum(&press));
+    EXPECT_TRUE(process_record_quantum(&release));
+    EXPECT_EQ(process_record_user_calls, calls + 2);
+}
+
+TEST_F(ProcessRecordDispatch, RangedHandlersStillRunAfterHandlersForAnyKeycode) {
+    TestDriver driver;
+    uint32_t   calls = process_record_user_calls;
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_EQ(process_record_user_calls, calls + 2);
+}
+
+TEST_F(ProcessRecordDispatch, RangedHandlerSeesModifiersOfEarlierKeys) {
+    TestDriver driver;
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_GRV)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,162 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::InSequence;
+
+class ReportDedup : public TestFixture {
+   public:
+    void SetUp() override { host_clear_suppressed_reports(); }
+};
+
+TEST_F(ReportDedup, RepeatedKeyboardReportsAreNotSent) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    send_keyboard_report();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_KEYBOARD), 2);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(ReportDedup, EveryChangeIsSent) {
+    TestDriver driver;
+    InSequence s;
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_KEYBOARD), 4);
+
+    // Modifiers are part of the state, so are modifiers added by a key
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    press_key(6, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_1)));
+    run_one_scan_loop();
+    release_key(6, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(ReportDedup, NewDriverGetsTheFirstReport) {
+    {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        clear_keyboard();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    clear_keyboard();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_KEYBOARD), 0);
+}
+
+TEST_F(ReportDedup, OnlyMouseReportsWithoutMovementAreDropped) {
+    TestDriver     driver;
+    report_mouse_t report = {};
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(1);
+    host_mouse_send(&report);
+    host_mouse_send(&report);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_MOUSE), 1);
+
+    report.x = 5;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(2);
+    host_mouse_send(&report);
+    host_mouse_send(&report);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The report after movement stops still goes out once
+    report.x = 0;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(1);
+    host_mouse_send(&report);
+    host_mouse_send(&report);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_MOUSE), 2);
+}
+
+TEST_F(ReportDedup, ExtrakeyCountsSuppressedReports) {
+    TestDriver driver;
+    InSequence s;
+    press_key(8, 0);
+    EXPECT_CALL(driver, send_consumer_mock(AUDIO_VOL_UP));
+    run_one_scan_loop();
+    host_consumer_send(AUDIO_VOL_UP);
+    release_key(8, 0);
+    EXPECT_CALL(driver, send_consumer_mock(0));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(host_suppressed_reports(HOST_REPORT_CONSUMER), 1);
+}
+
+/* Mashes random keys, including layers, macros and keys with modifiers,
+ * and checks after every scan that the host was told exactly the state
+ * the firmware has, without ever being sent the same report twice.
+ */
+TEST_F(ReportDedup, HostAlwaysSeesTheCurrentState) {
+    TestDriver                     driver;
+    std::vector<report_keyboard_t> sent;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&sent](report_keyboard_t& report) { sent.push_back(report); }));
+    EXPECT_CALL(driver, send_consumer_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+
+    clear_keyboard();
+    bool     pressed[MATRIX_COLS] = {};
+    uint32_t seed                 = 12345;
+    for (int i = 0; i < 5000; i++) {
+        seed      = seed * 1103515245 + 12345;
+        uint8_t k = (seed >> 16) % MATRIX_COLS;
+        pressed[k] = !pressed[k];
+        if (pressed[k]) {
+            press_key(k, 0);
+        } else {
+            release_key(k, 0);
+        }
+        run_one_scan_loop();
+
+        ASSERT_FALSE(sent.empty());
+        EXPECT_EQ(memcmp(sent.back().raw, keyboard_report->raw, KEYBOARD_REPORT_SIZE), 0) << "after step " << i;
+    }
+    for (size_t i = 1; i < sent.size(); i++) {
+        EXPECT_NE(memcmp(sent[i - 1].raw, sent[i].raw, KEYBOARD_REPORT_SIZE), 0) << "report " << i;
+    }
+    EXPECT_GT(host_suppressed_reports(HOST_REPORT_KEYBOARD), 0);
+    clear_all_keys();
+    idle_for(10);
+}
@@ -0,0 +1,137 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+class SendStringAsync : public TestFixture {
+   public:
+    ~SendStringAsync() { send_string_async_cancel(); }
+};
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([start]() { EXPECT_EQ(timer_elapsed32(start), t); }))
+
+TEST_F(SendStringAsync, SendsModifiersWithTheKey) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_B))).AT_TIME(20);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(30);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_1))).AT_TIME(40);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(50);
+    EXPECT_TRUE(SEND_STRING_ASYNC("aB!"));
+    EXPECT_TRUE(send_string_async_busy());
+    idle_for(100);
+    EXPECT_FALSE(send_string_async_busy());
+}
+
+TEST_F(SendStringAsync, PlaysTapDownUpAndDelay) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_A))).AT_TIME(10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL))).AT_TIME(20);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(30);
+    // The delay starts at the next report slot, 40 ms
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_HOME))).AT_TIME(140);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(150);
+    SEND_STRING_ASYNC(SS_DOWN(X_LCTL) "a" SS_UP(X_LCTL) SS_DELAY(100) SS_TAP(X_HOME));
+    idle_for(200);
+}
+
+TEST_F(SendStringAsync, AddsTheInterval) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(45);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(55);
+    SEND_STRING_ASYNC_DELAY("ab", 25);
+    idle_for(100);
+}
+
+TEST_F(SendStringAsync, KeepsScanningWhilePlaying) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   start = timer_read32();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_X))).AT_TIME(5);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X))).AT_TIME(11);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X, KC_B))).AT_TIME(21);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(25);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(31);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C))).AT_TIME(41);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(51);
+    idle_for(4);
+    press_key(1, 0);
+    idle_for(20);
+    release_key(1, 0);
+    idle_for(80);
+}
+
+TEST_F(SendStringAsync, CopiesStringsInRam) {
+    TestDriver driver;
+    InSequence s;
+    char       str[] = "ab";
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_TRUE(send_string_async(str));
+    str[0] = 'x';
+    str[1] = 'y';
+    idle_for(100);
+}
+
+TEST_F(SendStringAsync, RejectsWhatDoesNotFit) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_FALSE(send_string_async("abcdefgh"));
+    EXPECT_TRUE(send_string_async("abc"));
+    EXPECT_TRUE(send_string_async("de"));
+    EXPECT_FALSE(send_string_async("f"));
+    for (uint8_t key : {KC_A, KC_B, KC_C, KC_D, KC_E}) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    idle_for(200);
+    // Everything was played, so the whole buffer is free again
+    EXPECT_TRUE(send_string_async("abcdefg"));
+    send_string_async_cancel();
+}
+
+TEST_F(SendStringAsync, CancelReleasesTheKey) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    SEND_STRING_ASYNC("abc");
+    run_one_scan_loop();
+    send_string_async_cancel();
+    EXPECT_FALSE(send_string_async_busy());
+    idle_for(100);
+}
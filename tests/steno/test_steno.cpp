@@ -0,0 +1,181 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "process_steno.h"
+}
+
+using testing::_;
+
+typedef std::vector<uint8_t> packet_t;
+
+static std::vector<packet_t> serial_writes;
+static std::vector<packet_t> raw_packets;
+
+extern "C" void virtser_send_buffer(const uint8_t *data, uint8_t length) { serial_writes.push_back(packet_t(data, data + length)); }
+
+extern "C" void virtser_send(const uint8_t byte) { virtser_send_buffer(&byte, 1); }
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) { raw_packets.push_back(packet_t(data, data + length)); }
+
+enum { S1, TL, A, E, FR, ZR, N1, ST1 };
+
+class Steno : public TestFixture {
+   public:
+    void SetUp() override {
+        // Steno keys never type anything
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+        steno_set_mode(STENO_MODE_GEMINI);
+        steno_set_emit_mode(STENO_EMIT_ALL_UP);
+        serial_writes.clear();
+        raw_packets.clear();
+    }
+
+    TestDriver driver;
+
+    void press(std::vector<uint8_t> keys) {
+        for (auto key : keys) {
+            press_key(key, 0);
+            run_one_scan_loop();
+        }
+    }
+
+    void release(std::vector<uint8_t> keys) {
+        for (auto key : keys) {
+            release_key(key, 0);
+            run_one_scan_loop();
+        }
+    }
+};
+
+TEST_F(Steno, GeminiChordIsOneWriteOnRelease) {
+    press({S1, TL, A});
+    release({S1, TL});
+    EXPECT_TRUE(serial_writes.empty());
+    release({A});
+
+    ASSERT_EQ(serial_writes.size(), 1);
+    EXPECT_EQ(serial_writes[0], packet_t({0x80, 0x50, 0x20, 0x00, 0x00, 0x00}));
+}
+
+TEST_F(Steno, GeminiKeyLayout) {
+    press({N1, S1, A, E, ST1, FR, ZR});
+    release({N1, S1, A, E, ST1, FR, ZR});
+
+    ASSERT_EQ(serial_writes.size(), 1);
+    EXPECT_EQ(serial_writes[0], packet_t({0x80 | 0x20, 0x40, 0x20 | 0x08, 0x08 | 0x02, 0x00, 0x01}));
+}
+
+TEST_F(Steno, TxBoltSkipsEmptyGroups) {
+    steno_set_mode(STENO_MODE_BOLT);
+
+    press({S1, TL, A, E, FR, ZR});
+    release({S1, TL, A, E, FR, ZR});
+    press({A});
+    release({A});
+
+    ASSERT_EQ(serial_writes.size(), 2);
+    EXPECT_EQ(serial_writes[0], packet_t({0x03, 0x52, 0x81, 0xC8, 0x00}));
+    EXPECT_EQ(serial_writes[1], packet_t({0x42, 0x00}));
+}
+
+TEST_F(Steno, FirstUpSendsOnTheFirstRelease) {
+    steno_set_emit_mode(STENO_EMIT_FIRST_UP);
+
+    press({S1, A});
+    release({A});
+    ASSERT_EQ(serial_writes.size(), 1);
+    EXPECT_EQ(serial_writes[0], packet_t({0x80, 0x40, 0x20, 0x00, 0x00, 0x00}));
+
+    // Letting go of the rest doesn't send it again
+    release({S1});
+    EXPECT_EQ(serial_writes.size(), 1);
+
+    // Keys already sent don't carry over into the next chord
+    press({S1, A});
+    release({A});
+    press({E});
+    release({E});
+    ASSERT_EQ(serial_writes.size(), 3);
+    EXPECT_EQ(serial_writes[2], packet_t({0x80, 0x00, 0x00, 0x08, 0x00, 0x00}));
+    release({S1});
+    EXPECT_EQ(serial_writes.size(), 3);
+}
+
+TEST_F(Steno, PartialChordsKeepHeldKeys) {
+    steno_set_emit_mode(STENO_EMIT_PARTIAL);
+
+    press({S1, A});
+    release({A});
+    press({E});
+    release({E});
+    release({S1});
+
+    ASSERT_EQ(serial_writes.size(), 2);
+    EXPECT_EQ(serial_writes[0], packet_t({0x80, 0x40, 0x20, 0x00, 0x00, 0x00}));
+    EXPECT_EQ(serial_writes[1], packet_t({0x80, 0x40, 0x00, 0x08, 0x00, 0x00}));
+}
+
+TEST_F(Steno, HeldChordRepeats) {
+    steno_set_emit_mode(STENO_EMIT_REPEAT);
+
+    press({S1, A});
+    idle_for(STENO_REPEAT_DELAY - 10);
+    EXPECT_TRUE(serial_writes.empty());
+    idle_for(10 + 3 * STENO_REPEAT_INTERVAL);
+    ASSERT_EQ(serial_writes.size(), 4);
+    for (auto &write : serial_writes) {
+        EXPECT_EQ(write, packet_t({0x80, 0x40, 0x20, 0x00, 0x00, 0x00}));
+    }
+
+    // Already sent, releasing doesn't add one more
+    release({S1, A});
+    idle_for(STENO_REPEAT_DELAY);
+    EXPECT_EQ(serial_writes.size(), 4);
+
+    // A quick chord goes out once, on release
+    press({TL});
+    release({TL});
+    ASSERT_EQ(serial_writes.size(), 5);
+    EXPECT_EQ(serial_writes[4], packet_t({0x80, 0x10, 0x00, 0x00, 0x00, 0x00}));
+}
+
+TEST_F(Steno, PloverHidStreamsEveryChange) {
+    // Switching modes with the keycode
+    press_key(2, 1);
+    run_one_scan_loop();
+    release_key(2, 1);
+    run_one_scan_loop();
+
+    press({S1, ZR});
+    release({S1, ZR});
+
+    EXPECT_TRUE(serial_writes.empty());
+    ASSERT_EQ(raw_packets.size(), 4);
+    packet_t packet(32, 0);  // RAW_EPSIZE
+    packet[0] = STENO_PLOVER_HID_ID;
+    packet[1] = 0x80;
+    EXPECT_EQ(raw_packets[0], packet);
+    packet[4] = 0x40;
+    EXPECT_EQ(raw_packets[1], packet);
+    packet[1] = 0x00;
+    EXPECT_EQ(raw_packets[2], packet);
+    packet[4] = 0x00;
+    EXPECT_EQ(raw_packets[3], packet);
+}
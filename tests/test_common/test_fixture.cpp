@@ -23,6 +23,7 @@ using testing::Return;
 void TestFixture::SetUpTestCase() {
     TestDriver driver;
     EXPECT_CALL(driver, send_keyboard_mock(_));
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
     keyboard_init();
 }
 
@@ -34,6 +35,7 @@ TestFixture::~TestFixture() {
     TestDriver driver;
     // Run for a while to make sure all keys are completely released
     EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
     layer_clear();
     clear_all_keys();
     idle_for(TAPPING_TERM + 10);
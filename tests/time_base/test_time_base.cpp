@@ -0,0 +1,143 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+extern "C" {
+extern uint8_t  event_count;
+extern uint32_t event_times[2];
+void            set_time(uint32_t t);
+}
+
+class TimeBase : public TestFixture {
+   public:
+    TimeBase() { event_count = 0; }
+};
+
+TEST_F(TimeBase, EventsOfOneScanShareTheScanTime) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_time(1000);
+    press_key(1, 0);
+    press_key(3, 0);
+    run_one_scan_loop();
+    ASSERT_EQ(event_count, 2);
+    EXPECT_EQ(event_times[0], 1000 | 1);
+    EXPECT_EQ(event_times[1], 1000 | 1);
+    EXPECT_EQ(timer_scan_read32(), 1000);
+    release_key(1, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, EventAtTimeZeroIsNotDropped) {
+    TestDriver driver;
+    set_time(UINT32_MAX);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    press_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, TapAcross32BitWrap) {
+    TestDriver driver;
+    InSequence s;
+    set_time(0xFFFFFFC0);
+    press_key(0, 0);
+    idle_for(100);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, HoldAcross32BitWrap) {
+    TestDriver driver;
+    InSequence s;
+    set_time(0xFFFFFFC0);
+    press_key(0, 0);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, HoldAfterLongUptime) {
+    TestDriver driver;
+    InSequence s;
+    // More than 16 bits worth of milliseconds since the key went down
+    set_time(0x12340000);
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    set_time(0x12350000);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, OneshotTimesOutAcross32BitWrap) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    set_time(UINT32_MAX - 100);
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+    idle_for(ONESHOT_TIMEOUT + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    press_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TimeBase, OneshotAppliesWithinTimeoutAcross32BitWrap) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    set_time(UINT32_MAX - 100);
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+    idle_for(ONESHOT_TIMEOUT / 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+}
@@ -0,0 +1,229 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>
+#include <vector>
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Invoke;
+
+static std::vector<std::vector<uint8_t>> raw_packets;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) { raw_packets.push_back(std::vector<uint8_t>(data, data + length)); }
+
+class UnicodeAsync : public TestFixture {
+   public:
+    void SetUp() override { raw_packets.clear(); }
+
+    void run_until_done() {
+        for (int i = 0; i < 1000 && unicode_async_busy(); i++) {
+            run_one_scan_loop();
+        }
+        EXPECT_FALSE(unicode_async_busy());
+    }
+};
+
+TEST_F(UnicodeAsync, LinuxSequence) {
+    TestDriver driver;
+    InSequence s;
+    set_unicode_input_mode(UC_LNX);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_LSFT, KC_U)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_9)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_SPC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_TRUE(register_unicode_async(0x00E9));
+    run_until_done();
+}
+
+TEST_F(UnicodeAsync, MacKeepsOptionDownBetweenCodePoints) {
+    TestDriver driver;
+    InSequence s;
+    set_unicode_input_mode(UC_MAC);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_9)));
+    // ü follows é without releasing Option
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_TRUE(send_unicode_string_async("éü"));
+    run_until_done();
+}
+
+TEST_F(UnicodeAsync, MacSendsSurrogatePairs) {
+    TestDriver                     driver;
+    std::vector<report_keyboard_t> sent;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&sent](report_keyboard_t &report) { sent.push_back(report); }));
+    set_unicode_input_mode(UC_MAC);
+    // U+1F600 is D83D DE00
+    register_unicode_async(0x1F600);
+    run_until_done();
+
+    // Every digit press is a report with a new key, a repeated digit is released in between
+    std::vector<uint8_t> expected = {KC_D, KC_8, KC_3, KC_D, KC_D, KC_E, KC_0, KC_0};
+    std::vector<uint8_t> pressed;
+    uint8_t              last = KC_NO;
+    for (auto &report : sent) {
+        if (report.keys[0] != last && report.keys[0] != KC_NO) {
+            pressed.push_back(report.keys[0]);
+        }
+        last = report.keys[0];
+    }
+    EXPECT_EQ(pressed, expected);
+}
+
+TEST_F(UnicodeAsync, WindowsHoldsAltForTheDigits) {
+    TestDriver driver;
+    InSequence s;
+    set_unicode_input_mode(UC_WIN);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_PPLS)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_2)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_6)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_3)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    register_unicode_async(0x263A);
+    // Out of range for this mode, and dropped
+    register_unicode_async(0x1F600);
+    run_until_done();
+}
+
+TEST_F(UnicodeAsync, RestoresModsThatAreStillHeld) {
+    TestDriver driver;
+    InSequence s;
+    set_unicode_input_mode(UC_WINC);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+
+    // Shift is not part of the sequence, and comes back at the end
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_RALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_U)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_0)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENTER)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    register_unicode_async(0x0AB2);
+    run_until_done();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Released while typing, so it stays released
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    register_unicode_async(0x0AB2);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_until_done();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(get_mods(), 0);
+}
+
+TEST_F(UnicodeAsync, RawHidPacksCodePoints) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    set_unicode_input_mode(UC_RAWHID);
+    EXPECT_TRUE(send_unicode_string_async("héllo wörld ✓"));
+    run_one_scan_loop();
+    ASSERT_EQ(raw_packets.size(), 1);
+    run_until_done();
+    ASSERT_EQ(raw_packets.size(), 2);
+
+    std::vector<uint8_t> first = {UNICODE_RAW_HID_ID, 10, 'h', 0, 0, 0xE9, 0, 0, 'l', 0, 0, 'l', 0, 0, 'o', 0, 0, ' ', 0, 0, 'w', 0, 0, 0xF6, 0, 0, 'r', 0, 0, 'l', 0, 0};
+    EXPECT_EQ(raw_packets[0], first);
+    EXPECT_EQ(raw_packets[1][1], 3);
+    EXPECT_EQ(raw_packets[1][8], 0x13);
+    EXPECT_EQ(raw_packets[1][9], 0x27);
+
+    // The blocking function sends its own packet
+    register_unicode(0x1F600);
+    ASSERT_EQ(raw_packets.size(), 3);
+    EXPECT_EQ(raw_packets[2][1], 1);
+    EXPECT_EQ(raw_packets[2][4], 0x01);
+}
+
+TEST_F(UnicodeAsync, RejectsStringsThatDoNotFit) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    set_unicode_input_mode(UC_RAWHID);
+    EXPECT_FALSE(send_unicode_string_async("ééééééééééééééééé"));
+    EXPECT_FALSE(unicode_async_busy());
+    EXPECT_TRUE(send_unicode_string_async("éééééééééééééééé"));
+    EXPECT_FALSE(register_unicode_async(0xE9));
+    run_until_done();
+}
+
+TEST_F(UnicodeAsync, RejectsStringsLongerThanACounterByte) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    set_unicode_input_mode(UC_RAWHID);
+    // 257 code points, which an 8-bit count would see as one
+    std::string text(257, 'a');
+    EXPECT_FALSE(send_unicode_string_async(text.c_str()));
+    EXPECT_FALSE(unicode_async_busy());
+}
+
+// The non-blocking output needs fewer reports per character than register_unicode()
+TEST_F(UnicodeAsync, FewerReportsThanBlocking) {
+    static const char *text = "Ça fait déjà très longtemps, señor";
+    for (uint8_t mode : {UC_MAC, UC_LNX, UC_WIN, UC_WINC}) {
+        TestDriver driver;
+        int        reports = 0;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&reports](report_keyboard_t &) { reports++; }));
+        set_unicode_input_mode(mode);
+
+        send_unicode_string(text);
+        int blocking_reports = reports;
+        reports              = 0;
+
+        for (const char *p = text; *p;) {
+            char one[5] = {};
+            int  n      = 1;
+            while ((p[n] & 0xC0) == 0x80) n++;
+            memcpy(one, p, n);
+            if (send_unicode_string_async(one)) {
+                p += n;
+            }
+            run_one_scan_loop();
+        }
+        run_until_done();
+
+        EXPECT_LT(reports, blocking_reports);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+}
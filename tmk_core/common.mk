@@ -5,6 +5,7 @@ PLATFORM_COMMON_DIR = $(COMMON_DIR)/$(PLATFORM_KEY)
 
 TMK_COMMON_SRC +=	$(COMMON_DIR)/host.c \
 	$(COMMON_DIR)/keyboard.c \
+	$(COMMON_DIR)/matrix_ghost.c \
 	$(COMMON_DIR)/action.c \
 	$(COMMON_DIR)/action_tapping.c \
 	$(COMMON_DIR)/action_macro.c \
@@ -16,6 +17,7 @@ TMK_COMMON_SRC +=	$(COMMON_DIR)/host.c \
 	$(COMMON_DIR)/util.c \
 	$(COMMON_DIR)/eeconfig.c \
 	$(COMMON_DIR)/report.c \
+	$(COMMON_DIR)/timer.c \
 	$(PLATFORM_COMMON_DIR)/suspend.c \
 	$(PLATFORM_COMMON_DIR)/timer.c \
 	$(PLATFORM_COMMON_DIR)/bootloader.c \
@@ -86,8 +88,21 @@ ifeq ($(strip $(RAW_ENABLE)), yes)
     TMK_COMMON_DEFS += -DRAW_ENABLE
 endif
 
+VALID_CONSOLE_LOG_TYPES := text binary
+
+CONSOLE_LOG ?= text
 ifeq ($(strip $(CONSOLE_ENABLE)), yes)
     TMK_COMMON_DEFS += -DCONSOLE_ENABLE
+    ifeq ($(filter $(CONSOLE_LOG),$(VALID_CONSOLE_LOG_TYPES)),)
+        $(error CONSOLE_LOG="$(CONSOLE_LOG)" is not a valid console log type)
+    endif
+    ifeq ($(strip $(CONSOLE_LOG)), binary)
+        ifneq ($(filter ARM_ATSAM VUSB,$(strip $(PLATFORM)) $(strip $(PROTOCOL))),)
+            $(error CONSOLE_LOG = binary is only supported on LUFA and ChibiOS)
+        endif
+        TMK_COMMON_DEFS += -DCONSOLE_BINARY_LOG
+        TMK_COMMON_SRC += $(COMMON_DIR)/debug_log.c
+    endif
 else
     TMK_COMMON_DEFS += -DNO_PRINT
     TMK_COMMON_DEFS += -DNO_DEBUG
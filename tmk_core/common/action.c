@@ -47,6 +47,10 @@ int retro_tapping_counter = 0;
 #    include <fauxclicky.h>
 #endif
 
+#ifdef VISUALIZER_ENABLE
+#    include "visualizer/visualizer.h"
+#endif
+
 #ifdef IGNORE_MOD_TAP_INTERRUPT_PER_KEY
 __attribute__((weak)) bool get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record) { return false; }
 #endif
@@ -82,6 +86,12 @@ void action_exec(keyevent_t event) {
     fauxclicky_check();
 #endif
 
+#ifdef VISUALIZER_ENABLE
+    if (!IS_NOEVENT(event)) {
+        visualizer_key_event(event);
+    }
+#endif
+
 #ifdef SWAP_HANDS_ENABLE
     if (!IS_NOEVENT(event)) {
         process_hand_swap(&event);
@@ -1037,7 +1047,7 @@ bool is_tap_action(action_t action) {
  *
  * FIXME: Needs documentation.
  */
-void debug_event(keyevent_t event) { dprintf("%04X%c(%u)", (event.key.row << 8 | event.key.col), (event.pressed ? 'd' : 'u'), event.time); }
+void debug_event(keyevent_t event) { dprintf("%04X%c(%lu)", (event.key.row << 8 | event.key.col), (event.pressed ? 'd' : 'u'), (unsigned long)event.time); }
 /** \brief Debug print (FIXME: Needs better description)
  *
  * FIXME: Needs documentation.
@@ -63,8 +63,8 @@ void clear_oneshot_locked_mods(void) {
     }
 }
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-static uint16_t oneshot_time = 0;
-bool            has_oneshot_mods_timed_out(void) { return TIMER_DIFF_16(timer_read(), oneshot_time) >= ONESHOT_TIMEOUT; }
+static uint32_t oneshot_time = 0;
+bool            has_oneshot_mods_timed_out(void) { return TIMER_DIFF_32(timer_scan_read32(), oneshot_time) >= ONESHOT_TIMEOUT; }
 #    else
 bool has_oneshot_mods_timed_out(void) { return false; }
 #    endif
@@ -93,11 +93,11 @@ enum {
 #    endif
 
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-static uint16_t oneshot_layer_time = 0;
-inline bool     has_oneshot_layer_timed_out() { return TIMER_DIFF_16(timer_read(), oneshot_layer_time) >= ONESHOT_TIMEOUT && !(get_oneshot_layer_state() & ONESHOT_TOGGLED); }
+static uint32_t oneshot_layer_time = 0;
+inline bool     has_oneshot_layer_timed_out() { return TIMER_DIFF_32(timer_scan_read32(), oneshot_layer_time) >= ONESHOT_TIMEOUT && !(get_oneshot_layer_state() & ONESHOT_TOGGLED); }
 #        ifdef SWAP_HANDS_ENABLE
-static uint16_t oneshot_swaphands_time = 0;
-inline bool     has_oneshot_swaphands_timed_out() { return TIMER_DIFF_16(timer_read(), oneshot_swaphands_time) >= ONESHOT_TIMEOUT && (swap_hands_oneshot == SHO_ACTIVE); }
+static uint32_t oneshot_swaphands_time = 0;
+inline bool     has_oneshot_swaphands_timed_out() { return TIMER_DIFF_32(timer_scan_read32(), oneshot_swaphands_time) >= ONESHOT_TIMEOUT && (swap_hands_oneshot == SHO_ACTIVE); }
 #        endif
 #    endif
 
@@ -107,7 +107,7 @@ void set_oneshot_swaphands(void) {
     swap_hands_oneshot = SHO_PRESSED;
     swap_hands         = true;
 #        if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-    oneshot_swaphands_time = timer_read();
+    oneshot_swaphands_time = timer_scan_read32();
     if (oneshot_layer_time != 0) {
         oneshot_layer_time = oneshot_swaphands_time;
     }
@@ -150,7 +150,7 @@ void set_oneshot_layer(uint8_t layer, uint8_t state) {
     oneshot_layer_data = layer << 3 | state;
     layer_on(layer);
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-    oneshot_layer_time = timer_read();
+    oneshot_layer_time = timer_scan_read32();
 #    endif
     oneshot_layer_changed_kb(get_oneshot_layer());
 }
@@ -297,7 +297,7 @@ void clear_macro_mods(void) { macro_mods = 0; }
 void set_oneshot_mods(uint8_t mods) {
     if (oneshot_mods != mods) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-        oneshot_time = timer_read();
+        oneshot_time = timer_scan_read32();
 #    endif
         oneshot_mods = mods;
         oneshot_mods_changed_kb(mods);
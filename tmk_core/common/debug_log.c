@@ -0,0 +1,166 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "debug_log.h"
+
+#include <string.h>
+
+#define DEBUG_LOG_BUFFER_MASK (DEBUG_LOG_BUFFER_SIZE - 1)
+
+// Keeps the compiler from publishing an index before the bytes it covers
+#define debug_log_barrier() __asm__ volatile("" ::: "memory")
+
+static uint8_t                    buffer[DEBUG_LOG_BUFFER_SIZE];
+static volatile debug_log_index_t head;  // only written when adding records
+static volatile debug_log_index_t tail;  // only written when draining
+static uint16_t                   dropped;
+
+static debug_log_record_t text = {.length = 1, .data = {DEBUG_LOG_TEXT}};
+
+static debug_log_index_t debug_log_free(void) { return DEBUG_LOG_BUFFER_SIZE - (debug_log_index_t)(head - tail); }
+
+static void debug_log_write(const uint8_t *data, uint8_t length) {
+    debug_log_index_t index = head;
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[(debug_log_index_t)(index + i) & DEBUG_LOG_BUFFER_MASK] = data[i];
+    }
+    debug_log_barrier();
+    head = index + length;
+}
+
+static void debug_log_store(debug_log_record_t *record) {
+    record->data[0] |= record->length - 1;
+
+    if (dropped) {
+        // The count goes out first, once there's room for it and the record
+        uint8_t report[1 + sizeof(const char *) + 1 + sizeof(dropped)] = {DEBUG_LOG_FORMAT | (sizeof(report) - 1)};
+        report[1 + sizeof(const char *)]     = sizeof(dropped);
+        report[2 + sizeof(const char *)]     = dropped & 0xFF;
+        report[2 + sizeof(const char *) + 1] = dropped >> 8;
+        if (debug_log_free() < sizeof(report) + record->length) {
+            if (dropped < UINT16_MAX) dropped++;
+            return;
+        }
+        debug_log_write(report, sizeof(report));
+        dropped = 0;
+    }
+
+    if (debug_log_free() < record->length) {
+        dropped++;
+        return;
+    }
+    debug_log_write(record->data, record->length);
+}
+
+static void debug_log_flush_text(void) {
+    if (text.length > 1) {
+        debug_log_store(&text);
+        text.length  = 1;
+        text.data[0] = DEBUG_LOG_TEXT;
+    }
+}
+
+void debug_log_begin(debug_log_record_t *record, const char *format) {
+    uintptr_t address = (uintptr_t)format;
+
+    record->data[0] = DEBUG_LOG_FORMAT;
+    for (uint8_t i = 0; i < sizeof(const char *); i++) {
+        record->data[1 + i] = address >> (8 * i);
+    }
+    record->length = 1 + sizeof(const char *);
+    record->full   = false;
+}
+
+void debug_log_arg(debug_log_record_t *record, const void *value, uint8_t tag) {
+    uint8_t room   = sizeof(record->data) - record->length;
+    uint8_t length = tag;
+
+    if (tag == DEBUG_LOG_STRING) {
+        const char *string = *(const char *const *)value;
+        uint8_t     max    = room > 1 + sizeof(const char *) ? room - 1 - sizeof(const char *) : 0;
+        if (max > DEBUG_LOG_STRING_MAX) max = DEBUG_LOG_STRING_MAX;
+        length = 0;
+        while (length < max && string[length]) {
+            length++;
+        }
+        tag = DEBUG_LOG_STRING | length;
+        length += sizeof(const char *);
+    }
+
+    // Once one argument doesn't fit, the later ones are left out too
+    if (record->full || room < 1 + length) {
+        record->full = true;
+        return;
+    }
+
+    record->data[record->length++] = tag;
+    if (tag & DEBUG_LOG_STRING) {
+        memcpy(&record->data[record->length], value, sizeof(const char *));
+        memcpy(&record->data[record->length + sizeof(const char *)], *(const char *const *)value, length - sizeof(const char *));
+    } else {
+        memcpy(&record->data[record->length], value, length);
+    }
+    record->length += length;
+}
+
+void debug_log_commit(debug_log_record_t *record) {
+    debug_log_flush_text();
+    debug_log_store(record);
+}
+
+void debug_log_literal(const char *string) {
+    debug_log_record_t record;
+    debug_log_begin(&record, string);
+    record.data[0] = DEBUG_LOG_LITERAL;
+    debug_log_commit(&record);
+}
+
+void debug_log_putchar(uint8_t c) {
+    text.data[text.length++] = c;
+    if (c == '\n' || text.length == sizeof(text.data)) {
+        debug_log_flush_text();
+    }
+}
+
+debug_log_index_t debug_log_peek(const uint8_t **data) {
+    debug_log_index_t used  = head - tail;
+    debug_log_index_t start = tail & DEBUG_LOG_BUFFER_MASK;
+
+    *data = &buffer[start];
+    return used < DEBUG_LOG_BUFFER_SIZE - start ? used : DEBUG_LOG_BUFFER_SIZE - start;
+}
+
+debug_log_index_t debug_log_copy(uint8_t *data, debug_log_index_t size) {
+    debug_log_index_t used = head - tail;
+    if (size > used) size = used;
+
+    for (debug_log_index_t i = 0; i < size; i++) {
+        data[i] = buffer[(debug_log_index_t)(tail + i) & DEBUG_LOG_BUFFER_MASK];
+    }
+    return size;
+}
+
+void debug_log_consume(debug_log_index_t length) {
+    debug_log_barrier();
+    tail += length;
+}
+
+void debug_log_clear(void) {
+    head         = 0;
+    tail         = 0;
+    dropped      = 0;
+    text.length  = 1;
+    text.data[0] = DEBUG_LOG_TEXT;
+}
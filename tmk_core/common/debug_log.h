@@ -0,0 +1,131 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Binary console log
+ *
+ * With CONSOLE_LOG = binary, print() and xprintf() don't format anything on
+ * the keyboard. A record holding the address of the format string and the raw
+ * arguments goes into a ring buffer, and the console endpoint drains it
+ * between scans without ever waiting for the host. `qmk log-decode` finds the
+ * format strings in the firmware's ELF and formats the messages on the host.
+ *
+ * Every record starts with a header byte, the kind in the top two bits and the
+ * length of the rest in the low six. A zero byte is padding:
+ *
+ *   DEBUG_LOG_FORMAT   format address, then one tag and value per argument
+ *   DEBUG_LOG_LITERAL  format address, printed as is
+ *   DEBUG_LOG_TEXT     raw characters, from anything that calls sendchar()
+ *
+ * An argument tag is the size of the value that follows, or DEBUG_LOG_STRING
+ * plus a length for a string, which is sent as its address followed by its
+ * first characters. Format address 0 reports how many records were dropped
+ * because the buffer was full.
+ *
+ * Writing and draining both happen from the main loop, the indices are single
+ * bytes on AVR so neither side needs to lock.
+ */
+
+#ifndef DEBUG_LOG_BUFFER_SIZE
+#    if defined(__AVR__)
+#        define DEBUG_LOG_BUFFER_SIZE 128
+#    else
+#        define DEBUG_LOG_BUFFER_SIZE 512
+#    endif
+#endif
+
+#if (DEBUG_LOG_BUFFER_SIZE & (DEBUG_LOG_BUFFER_SIZE - 1)) != 0
+#    error DEBUG_LOG_BUFFER_SIZE must be a power of two
+#endif
+
+// The longest part of a string argument that's sent
+#ifndef DEBUG_LOG_STRING_MAX
+#    define DEBUG_LOG_STRING_MAX 16
+#endif
+
+#define DEBUG_LOG_FORMAT 0x00
+#define DEBUG_LOG_LITERAL 0x40
+#define DEBUG_LOG_TEXT 0x80
+#define DEBUG_LOG_KIND_MASK 0xC0
+#define DEBUG_LOG_RECORD_MAX 0x3F
+
+#define DEBUG_LOG_STRING 0x80
+
+#if DEBUG_LOG_BUFFER_SIZE > 128
+typedef uint16_t debug_log_index_t;
+#else
+typedef uint8_t debug_log_index_t;
+#endif
+
+typedef struct {
+    uint8_t length;
+    bool    full;
+    uint8_t data[1 + DEBUG_LOG_RECORD_MAX];
+} debug_log_record_t;
+
+void debug_log_begin(debug_log_record_t *record, const char *format);
+// Arguments that don't fit in the record are left out, the decoder shows them as '?'
+void debug_log_arg(debug_log_record_t *record, const void *value, uint8_t tag);
+void debug_log_commit(debug_log_record_t *record);
+
+void debug_log_literal(const char *string);
+// Characters are collected until a newline or a format record, then sent as one text record
+void debug_log_putchar(uint8_t c);
+
+// How many bytes can be read from *data in one go, the rest follows after the wrap
+debug_log_index_t debug_log_peek(const uint8_t **data);
+// Copies up to size bytes across the wrap, they stay in the log until consumed
+debug_log_index_t debug_log_copy(uint8_t *data, debug_log_index_t size);
+void              debug_log_consume(debug_log_index_t length);
+void              debug_log_clear(void);
+
+/* Variable arguments are promoted the way printf() would see them, and the
+ * tag records the size each one ended up with.
+ */
+#define DEBUG_LOG_TAG(value) _Generic((value), char * : DEBUG_LOG_STRING, const char * : DEBUG_LOG_STRING, default : sizeof(value))
+
+#define DEBUG_LOG_ARG(record, x)                                                 \
+    do {                                                                         \
+        __typeof__((x) + 0) debug_log_value = (x);                               \
+        debug_log_arg(record, &debug_log_value, DEBUG_LOG_TAG(debug_log_value)); \
+    } while (0);
+
+#define DEBUG_LOG_ARGS_0(r)
+#define DEBUG_LOG_ARGS_1(r, a) DEBUG_LOG_ARG(r, a)
+#define DEBUG_LOG_ARGS_2(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_1(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_3(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_2(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_4(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_3(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_5(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_4(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_6(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_5(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_7(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_6(r, __VA_ARGS__)
+#define DEBUG_LOG_ARGS_8(r, a, ...) DEBUG_LOG_ARG(r, a) DEBUG_LOG_ARGS_7(r, __VA_ARGS__)
+#define DEBUG_LOG_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define DEBUG_LOG_COUNT(...) DEBUG_LOG_COUNT_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DEBUG_LOG_CAT_(a, b) a##b
+#define DEBUG_LOG_CAT(a, b) DEBUG_LOG_CAT_(a, b)
+#define DEBUG_LOG_ARGS(record, ...) DEBUG_LOG_CAT(DEBUG_LOG_ARGS_, DEBUG_LOG_COUNT(__VA_ARGS__))(record, ##__VA_ARGS__)
+
+// Up to 8 arguments
+#define debug_log_printf(format, ...)                     \
+    do {                                                  \
+        debug_log_record_t debug_log_record;              \
+        debug_log_begin(&debug_log_record, PSTR(format)); \
+        DEBUG_LOG_ARGS(&debug_log_record, ##__VA_ARGS__)  \
+        debug_log_commit(&debug_log_record);              \
+    } while (0)
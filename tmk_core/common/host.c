@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
@@ -31,7 +32,30 @@ static host_driver_t *driver;
 static uint16_t       last_system_report   = 0;
 static uint16_t       last_consumer_report = 0;
 
-void host_set_driver(host_driver_t *d) { driver = d; }
+/* Copies of the last report sent on each endpoint. A report that matches
+ * is not sent again, so callers can send the current state as often as
+ * they like. The copies are only valid once something was sent through
+ * the current driver, so the first report always goes out.
+ */
+static uint8_t last_keyboard_report[KEYBOARD_REPORT_SIZE];
+static bool    last_keyboard_valid = false;
+#ifdef NKRO_ENABLE
+static struct nkro_report last_nkro_report;
+static bool               last_nkro_valid = false;
+#endif
+static report_mouse_t last_mouse_report;
+static bool           last_mouse_valid = false;
+
+static uint32_t suppressed_reports[HOST_REPORT_TYPES];
+
+void host_set_driver(host_driver_t *d) {
+    driver              = d;
+    last_keyboard_valid = false;
+#ifdef NKRO_ENABLE
+    last_nkro_valid = false;
+#endif
+    last_mouse_valid = false;
+}
 
 host_driver_t *host_get_driver(void) { return driver; }
 
@@ -62,6 +86,26 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
+
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        if (last_nkro_valid && memcmp(&last_nkro_report, &report->nkro, sizeof(last_nkro_report)) == 0) {
+            suppressed_reports[HOST_REPORT_NKRO]++;
+            return;
+        }
+        memcpy(&last_nkro_report, &report->nkro, sizeof(last_nkro_report));
+        last_nkro_valid = true;
+    } else
+#endif
+    {
+        if (last_keyboard_valid && memcmp(last_keyboard_report, report->raw, KEYBOARD_REPORT_SIZE) == 0) {
+            suppressed_reports[HOST_REPORT_KEYBOARD]++;
+            return;
+        }
+        memcpy(last_keyboard_report, report->raw, KEYBOARD_REPORT_SIZE);
+        last_keyboard_valid = true;
+    }
+
     (*driver->send_keyboard)(report);
 
     if (debug_keyboard) {
@@ -78,11 +122,24 @@ void host_mouse_send(report_mouse_t *report) {
 #ifdef MOUSE_SHARED_EP
     report->report_id = REPORT_ID_MOUSE;
 #endif
+
+    // Movement is relative, only a report without any is safe to drop
+    bool moves = report->x || report->y || report->v || report->h;
+    if (!moves && last_mouse_valid && memcmp(&last_mouse_report, report, sizeof(report_mouse_t)) == 0) {
+        suppressed_reports[HOST_REPORT_MOUSE]++;
+        return;
+    }
+    last_mouse_report = *report;
+    last_mouse_valid  = true;
+
     (*driver->send_mouse)(report);
 }
 
 void host_system_send(uint16_t report) {
-    if (report == last_system_report) return;
+    if (report == last_system_report) {
+        suppressed_reports[HOST_REPORT_SYSTEM]++;
+        return;
+    }
     last_system_report = report;
 
     if (!driver) return;
@@ -90,7 +147,10 @@ void host_system_send(uint16_t report) {
 }
 
 void host_consumer_send(uint16_t report) {
-    if (report == last_consumer_report) return;
+    if (report == last_consumer_report) {
+        suppressed_reports[HOST_REPORT_CONSUMER]++;
+        return;
+    }
     last_consumer_report = report;
 
     if (!driver) return;
@@ -100,3 +160,7 @@ void host_consumer_send(uint16_t report) {
 uint16_t host_last_system_report(void) { return last_system_report; }
 
 uint16_t host_last_consumer_report(void) { return last_consumer_report; }
+
+uint32_t host_suppressed_reports(host_report_type_t type) { return type < HOST_REPORT_TYPES ? suppressed_reports[type] : 0; }
+
+void host_clear_suppressed_reports(void) { memset(suppressed_reports, 0, sizeof(suppressed_reports)); }
@@ -36,6 +36,15 @@ extern "C" {
 extern uint8_t keyboard_idle;
 extern uint8_t keyboard_protocol;
 
+typedef enum {
+    HOST_REPORT_KEYBOARD,
+    HOST_REPORT_NKRO,
+    HOST_REPORT_MOUSE,
+    HOST_REPORT_SYSTEM,
+    HOST_REPORT_CONSUMER,
+    HOST_REPORT_TYPES,
+} host_report_type_t;
+
 /* host driver */
 void           host_set_driver(host_driver_t *driver);
 host_driver_t *host_get_driver(void);
@@ -51,6 +60,10 @@ void    host_consumer_send(uint16_t data);
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
+/* Reports that were not sent because they repeated the previous one */
+uint32_t host_suppressed_reports(host_report_type_t type);
+void     host_clear_suppressed_reports(void);
+
 #ifdef __cplusplus
 }
 #endif
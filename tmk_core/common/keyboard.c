@@ -95,6 +95,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSPORT_EVENTS)
+#    include "split_events.h"
+#endif
+#ifdef MATRIX_HAS_GHOST
+#    include "matrix_ghost.h"
+#endif
 
 // Only enable this if console is enabled to print to
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
@@ -104,7 +110,7 @@ static uint32_t matrix_scan_count = 0;
 void matrix_scan_perf_task(void) {
     matrix_scan_count++;
 
-    uint32_t timer_now = timer_read32();
+    uint32_t timer_now = timer_scan_read32();
     if (TIMER_DIFF_32(timer_now, matrix_timer) > 1000) {
         dprintf("matrix scan frequency: %d\n", matrix_scan_count);
 
@@ -117,48 +123,23 @@ void matrix_scan_perf_task(void) {
 #endif
 
 #ifdef MATRIX_HAS_GHOST
+#    ifdef KEYMAP_COMPRESSION_ENABLE
+#        define is_real_key(row, col) ((uint8_t)keymap_compressed_get_keycode(0, row, col))
+#    else
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
-static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
+#        define is_real_key(row, col) pgm_read_byte(&keymaps[0][row][col])
+#    endif
+static matrix_row_t get_real_keys(uint8_t row) {
     matrix_row_t out = 0;
     for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        // read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1 << col))) {
-            // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1 << col;
+        // check if the keymap defines it as a real key
+        if (is_real_key(row, col)) {
+            out |= MATRIX_ROW_SHIFTER << col;
         }
     }
     return out;
 }
 
-static inline bool popcount_more_than_one(matrix_row_t rowdata) {
-    rowdata &= rowdata - 1;  // if there are less than two bits (keys) set, rowdata will become zero
-    return rowdata;
-}
-
-static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
-    /* No ghost exists when less than 2 keys are down on the row.
-    If there are "active" blanks in the matrix, the key can't be pressed by the user,
-    there is no doubt as to which keys are really being pressed.
-    The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
-    if ((popcount_more_than_one(rowdata)) == 0) {
-        return false;
-    }
-    /* Ghost occurs when the row shares a column line with other row,
-    and two columns are read on each row. Blanks in the matrix don't matter,
-    so they are filtered out.
-    If there are two or more real keys pressed and they match columns with
-    at least two of another row's real keys, the row will be ignored. Keep in mind,
-    we are checking one row at a time, not all of them at once.
-    */
-    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
-            return true;
-        }
-    }
-    return false;
-}
-
 #endif
 
 void disable_jtag(void) {
@@ -236,6 +217,11 @@ __attribute__((weak)) bool should_process_keypress(void) { return is_keyboard_ma
 void keyboard_init(void) {
     timer_init();
     matrix_init();
+#ifdef MATRIX_HAS_GHOST
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_ghost_set_real_keys(r, get_real_keys(r));
+    }
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -309,6 +295,8 @@ void keyboard_task(void) {
     uint8_t keys_processed = 0;
 #endif
 
+    timer_scan_update();
+
 #if defined(OLED_DRIVER_ENABLE) && !defined(OLED_DISABLE_TIMEOUT)
     uint8_t ret = matrix_scan();
 #else
@@ -316,21 +304,43 @@ void keyboard_task(void) {
 #endif
 
     if (should_process_keypress()) {
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSPORT_EVENTS)
+        // keys from the other half carry the time they changed there, so they go first
+        keyevent_t split_event;
+        while (split_events_next(&split_event)) {
+            if (split_event.pressed) {
+                matrix_prev[split_event.key.row] |= MATRIX_ROW_SHIFTER << split_event.key.col;
+            } else {
+                matrix_prev[split_event.key.row] &= ~(MATRIX_ROW_SHIFTER << split_event.key.col);
+            }
+            action_exec(split_event);
+        }
+#endif
+#ifdef MATRIX_HAS_GHOST
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            matrix_ghost_update(r, matrix_get_row(r));
+        }
+#endif
         for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
             matrix_row    = matrix_get_row(r);
             matrix_change = matrix_row ^ matrix_prev[r];
-            if (matrix_change) {
 #ifdef MATRIX_HAS_GHOST
-                if (has_ghost_in_row(r, matrix_row)) {
-                    continue;
-                }
+#    ifdef MATRIX_GHOST_REPORT_LAST_VALID
+            // keys of a ghost rectangle keep their last valid state, the rest of the row goes on
+            matrix_change &= ~matrix_ghost_blocked(r);
+#    else
+            if (matrix_ghost_in_row(r)) {
+                continue;
+            }
+#    endif
 #endif
+            if (matrix_change) {
                 if (debug_matrix) matrix_print();
                 matrix_row_t col_mask = 1;
                 for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                     if (matrix_change & col_mask) {
                         action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
+                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_scan_read32() | 1) /* time should not be 0 */
                         });
                         // record a processed key
                         matrix_prev[r] ^= col_mask;
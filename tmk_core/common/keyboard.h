@@ -35,7 +35,7 @@ typedef struct {
 typedef struct {
     keypos_t key;
     bool     pressed;
-    uint16_t time;
+    uint32_t time;
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -51,7 +51,7 @@ static inline bool IS_RELEASED(keyevent_t event) { return (!IS_NOEVENT(event) &&
 
 /* Tick event */
 #define TICK \
-    (keyevent_t) { .key = (keypos_t){.row = 255, .col = 255}, .pressed = false, .time = (timer_read() | 1) }
+    (keyevent_t) { .key = (keypos_t){.row = 255, .col = 255}, .pressed = false, .time = (timer_scan_read32() | 1) }
 
 /* it runs once at early stage of startup before keyboard_init. */
 void keyboard_setup(void);
@@ -0,0 +1,92 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "matrix_ghost.h"
+
+#ifdef MATRIX_HAS_GHOST
+
+static matrix_row_t real_keys[MATRIX_ROWS];
+static matrix_row_t keys_down[MATRIX_ROWS];
+static matrix_row_t blocked_keys[MATRIX_ROWS];
+static uint32_t     column_rows[MATRIX_COLS];  // rows with the column down
+static uint32_t     ghost_rows;
+
+// Finds the rectangles with a corner on the row, from the rows down in each of its columns
+static void matrix_ghost_check_row(uint8_t row) {
+    matrix_row_t down    = keys_down[row];
+    matrix_row_t blocked = 0;
+    uint32_t     others  = ~((uint32_t)1 << row);
+
+    // No rectangle without two keys down on the row
+    if (down & (down - 1)) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!(down & (MATRIX_ROW_SHIFTER << col))) {
+                continue;
+            }
+            uint32_t rows = column_rows[col] & others;
+            if (!rows) {
+                continue;
+            }
+            for (uint8_t other = col + 1; other < MATRIX_COLS; other++) {
+                if ((down & (MATRIX_ROW_SHIFTER << other)) && (rows & column_rows[other])) {
+                    blocked |= (MATRIX_ROW_SHIFTER << col) | (MATRIX_ROW_SHIFTER << other);
+                }
+            }
+        }
+    }
+
+    blocked_keys[row] = blocked;
+    if (blocked) {
+        ghost_rows |= (uint32_t)1 << row;
+    } else {
+        ghost_rows &= ~((uint32_t)1 << row);
+    }
+}
+
+void matrix_ghost_set_real_keys(uint8_t row, matrix_row_t keys) {
+    real_keys[row] = keys;
+    matrix_ghost_update(row, keys_down[row]);
+}
+
+void matrix_ghost_update(uint8_t row, matrix_row_t rowdata) {
+    rowdata &= real_keys[row];
+    matrix_row_t changed = rowdata ^ keys_down[row];
+    if (!changed) {
+        return;
+    }
+
+    // Only rows down in a changed column can gain or lose a rectangle with this one
+    uint32_t affected = (uint32_t)1 << row;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (changed & (MATRIX_ROW_SHIFTER << col)) {
+            column_rows[col] ^= (uint32_t)1 << row;
+            affected |= column_rows[col];
+        }
+    }
+    keys_down[row] = rowdata;
+
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        if (affected & ((uint32_t)1 << i)) {
+            matrix_ghost_check_row(i);
+        }
+    }
+}
+
+bool matrix_ghost_in_row(uint8_t row) { return ghost_rows & ((uint32_t)1 << row); }
+
+matrix_row_t matrix_ghost_blocked(uint8_t row) { return blocked_keys[row]; }
+
+#endif
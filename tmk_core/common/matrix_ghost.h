@@ -0,0 +1,48 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Ghost detection for matrices without diodes
+ *
+ * Three keys down on the corners of a rectangle make the fourth corner read
+ * as down too, and there is no telling which of the four is the ghost. Only
+ * keys that the keymap defines on layer 0 count, blanks can't be pressed.
+ *
+ * The set of rows down in each column is kept up to date as keys change, so a
+ * change only rechecks the rows that share one of its columns instead of
+ * comparing every pair of rows on every scan.
+ */
+
+#if defined(MATRIX_HAS_GHOST) && MATRIX_ROWS > 32
+#    error "MATRIX_HAS_GHOST supports up to 32 rows"
+#endif
+
+// Keys that can be pressed on a row, everything else is ignored
+void matrix_ghost_set_real_keys(uint8_t row, matrix_row_t keys);
+
+// Feeds the raw state of a row, all rows have to be fed before asking about any of them
+void matrix_ghost_update(uint8_t row, matrix_row_t rowdata);
+
+// Whether the row shares two or more keys down with another row
+bool matrix_ghost_in_row(uint8_t row);
+
+// Keys down on the row that are a corner of a ghost rectangle
+matrix_row_t matrix_ghost_blocked(uint8_t row);
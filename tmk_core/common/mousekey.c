@@ -23,12 +23,16 @@
 #include "debug.h"
 #include "mousekey.h"
 
-inline int8_t times_inv_sqrt2(int8_t x) {
+inline mouse_xy_report_t times_inv_sqrt2(mouse_xy_report_t x) {
     // 181/256 is pretty close to 1/sqrt(2)
     // 0.70703125                 0.707106781
     // 1 too small for x=99 and x=198
     // This ends up being a mult and discard lower 8 bits
+#ifdef MOUSE_EXTENDED_REPORT
+    return ((int32_t)x * 181) >> 8;
+#else
     return (x * 181) >> 8;
+#endif
 }
 
 static report_mouse_t mouse_report = {0};
@@ -37,7 +41,196 @@ static uint8_t        mousekey_accel        = 0;
 static uint8_t        mousekey_repeat       = 0;
 static uint8_t        mousekey_wheel_repeat = 0;
 
-#ifndef MK_3_SPEED
+#if defined(MK_KINEMATIC)
+
+/*
+ * Kinematic mouse keys
+ *
+ * Holding a direction starts moving at the initial speed and accelerates
+ * up to the base speed, or moves at one of three constant speeds while an
+ * acceleration key is held. Speed and position are integrated over the
+ * time that actually passed once per frame, in fixed point with 8
+ * fractional bits, so the motion doesn't depend on the scan rate and
+ * fractions of a unit carry over to the next frame.
+ */
+
+typedef struct {
+    uint16_t initial;
+    uint16_t base;
+    uint16_t acceleration;
+    uint16_t constant[3];  // KC_ACL0 to KC_ACL2
+} mousekey_kinematics_t;
+
+typedef struct {
+    uint32_t speed;  // units per second, 8 fractional bits
+    int32_t  a;      // motion not reported yet, 1/256 units
+    int32_t  b;
+} mousekey_motion_t;
+
+static const mousekey_kinematics_t cursor_kinematics = {MOUSEKEY_INITIAL_SPEED, MOUSEKEY_BASE_SPEED, MOUSEKEY_ACCELERATION, {MOUSEKEY_SPEED_0, MOUSEKEY_SPEED_1, MOUSEKEY_SPEED_2}};
+static const mousekey_kinematics_t wheel_kinematics  = {MOUSEKEY_WHEEL_INITIAL_SPEED, MOUSEKEY_WHEEL_BASE_SPEED, MOUSEKEY_WHEEL_ACCELERATION, {MOUSEKEY_WHEEL_SPEED_0, MOUSEKEY_WHEEL_SPEED_1, MOUSEKEY_WHEEL_SPEED_2}};
+
+enum {
+    MK_UP          = (1 << 0),
+    MK_DOWN        = (1 << 1),
+    MK_LEFT        = (1 << 2),
+    MK_RIGHT       = (1 << 3),
+    MK_WHEEL_UP    = (1 << 4),
+    MK_WHEEL_DOWN  = (1 << 5),
+    MK_WHEEL_LEFT  = (1 << 6),
+    MK_WHEEL_RIGHT = (1 << 7),
+};
+
+static uint8_t           mousekey_held = 0;
+static mousekey_motion_t cursor_motion;
+static mousekey_motion_t wheel_motion;
+static uint32_t          last_frame;
+
+static int8_t held_direction(uint8_t negative, uint8_t positive) { return ((mousekey_held & positive) ? 1 : 0) - ((mousekey_held & negative) ? 1 : 0); }
+
+/* Integrates dt milliseconds of motion along a and b, each -1, 0 or 1. */
+static void integrate(mousekey_motion_t *motion, const mousekey_kinematics_t *kinematics, int8_t a, int8_t b, uint16_t dt) {
+    if (!a) motion->a = 0;
+    if (!b) motion->b = 0;
+    if (!a && !b) {
+        motion->speed = (uint32_t)kinematics->initial << 8;
+        return;
+    }
+
+    uint32_t start = motion->speed;
+    uint32_t end;
+    if (mousekey_accel) {
+        // Constant speed, from the start of the frame
+        uint8_t speed = (mousekey_accel & (1 << 0)) ? 0 : (mousekey_accel & (1 << 1)) ? 1 : 2;
+        start = end = (uint32_t)kinematics->constant[speed] << 8;
+    } else {
+        uint32_t base = (uint32_t)kinematics->base << 8;
+        end           = start + ((uint32_t)kinematics->acceleration << 8) * dt / 1000;
+        if (end > base) end = base;
+    }
+    motion->speed = end;
+
+    // The speed changes linearly within the frame, so the average of both ends is exact
+    int32_t distance = (start + end) / 2 * dt / 1000;
+    if (a && b) {
+        // Diagonal, normalized before rounding so slow diagonals aren't any faster
+        distance = distance * 181 / 256;
+    }
+    motion->a += a * distance;
+    motion->b += b * distance;
+}
+
+/* Takes the whole units out of an accumulator, as many as fit in a report. */
+static int16_t take_units(int32_t *accumulated, int16_t max) {
+    int32_t units = *accumulated / 256;
+    if (units > max) {
+        units = max;
+    } else if (units < -max) {
+        units = -max;
+    }
+    *accumulated -= units * 256;
+    return units;
+}
+
+void mousekey_task(void) {
+    uint32_t now = timer_scan_read32();
+    if (!mousekey_held) {
+        last_frame = now;
+        return;
+    }
+    uint32_t dt = TIMER_DIFF_32(now, last_frame);
+    if (dt < MOUSEKEY_FRAME_INTERVAL) {
+        return;
+    }
+    last_frame = now;
+    if (dt > UINT16_MAX) dt = UINT16_MAX;
+
+    integrate(&cursor_motion, &cursor_kinematics, held_direction(MK_LEFT, MK_RIGHT), held_direction(MK_UP, MK_DOWN), dt);
+    integrate(&wheel_motion, &wheel_kinematics, held_direction(MK_WHEEL_DOWN, MK_WHEEL_UP), held_direction(MK_WHEEL_LEFT, MK_WHEEL_RIGHT), dt);
+
+    mouse_report.x = take_units(&cursor_motion.a, MOUSE_REPORT_XY_MAX);
+    mouse_report.y = take_units(&cursor_motion.b, MOUSE_REPORT_XY_MAX);
+    mouse_report.v = take_units(&wheel_motion.a, MOUSE_REPORT_WHEEL_MAX);
+    mouse_report.h = take_units(&wheel_motion.b, MOUSE_REPORT_WHEEL_MAX);
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+}
+
+static uint8_t held_bit(uint8_t code) {
+    switch (code) {
+        case KC_MS_UP:
+            return MK_UP;
+        case KC_MS_DOWN:
+            return MK_DOWN;
+        case KC_MS_LEFT:
+            return MK_LEFT;
+        case KC_MS_RIGHT:
+            return MK_RIGHT;
+        case KC_MS_WH_UP:
+            return MK_WHEEL_UP;
+        case KC_MS_WH_DOWN:
+            return MK_WHEEL_DOWN;
+        case KC_MS_WH_LEFT:
+            return MK_WHEEL_LEFT;
+        case KC_MS_WH_RIGHT:
+            return MK_WHEEL_RIGHT;
+        default:
+            return 0;
+    }
+}
+
+void mousekey_on(uint8_t code) {
+    if (held_bit(code)) {
+        if (!mousekey_held) {
+            // Start moving from the press, at the initial speed
+            cursor_motion.speed = (uint32_t)MOUSEKEY_INITIAL_SPEED << 8;
+            wheel_motion.speed  = (uint32_t)MOUSEKEY_WHEEL_INITIAL_SPEED << 8;
+            last_frame          = timer_scan_read32();
+        }
+        mousekey_held |= held_bit(code);
+    } else if (code == KC_MS_BTN1)
+        mouse_report.buttons |= MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons |= MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons |= MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons |= MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons |= MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel |= (1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel |= (1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel |= (1 << 2);
+}
+
+void mousekey_off(uint8_t code) {
+    if (held_bit(code))
+        mousekey_held &= ~held_bit(code);
+    else if (code == KC_MS_BTN1)
+        mouse_report.buttons &= ~MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons &= ~MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons &= ~MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons &= ~MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons &= ~MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel &= ~(1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel &= ~(1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel &= ~(1 << 2);
+}
+
+#elif !defined(MK_3_SPEED)
 
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
@@ -68,7 +261,7 @@ uint8_t mk_wheel_time_to_max = MOUSEKEY_WHEEL_TIME_TO_MAX;
 
 #    ifndef MK_COMBINED
 
-static uint8_t move_unit(void) {
+static uint16_t move_unit(void) {
     uint16_t unit;
     if (mousekey_accel & (1 << 0)) {
         unit = (MOUSEKEY_MOVE_DELTA * mk_max_speed) / 4;
@@ -106,7 +299,7 @@ static uint8_t wheel_unit(void) {
 
 #    else /* #ifndef MK_COMBINED */
 
-static uint8_t move_unit(void) {
+static uint16_t move_unit(void) {
     uint16_t unit;
     if (mousekey_accel & (1 << 0)) {
         unit = 1;
@@ -413,9 +606,11 @@ void mousekey_off(uint8_t code) {
 
 void mousekey_send(void) {
     mousekey_debug();
+#ifndef MK_KINEMATIC
     uint16_t time = timer_read();
     if (mouse_report.x || mouse_report.y) last_timer_c = time;
     if (mouse_report.v || mouse_report.h) last_timer_w = time;
+#endif
     host_mouse_send(&mouse_report);
 }
 
@@ -424,6 +619,9 @@ void mousekey_clear(void) {
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
+#ifdef MK_KINEMATIC
+    mousekey_held = 0;
+#endif
 }
 
 static void mousekey_debug(void) {
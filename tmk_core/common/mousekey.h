@@ -22,13 +22,65 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #include "host.h"
 
-#ifndef MK_3_SPEED
+#if defined(MK_KINEMATIC)
+
+/* Speeds are in units per second, pixels for the cursor and scroll steps
+ * for the wheel, accelerations in units per second per second.
+ */
+#    ifndef MOUSEKEY_INITIAL_SPEED
+#        define MOUSEKEY_INITIAL_SPEED 100
+#    endif
+#    ifndef MOUSEKEY_BASE_SPEED
+#        define MOUSEKEY_BASE_SPEED 1000
+#    endif
+#    ifndef MOUSEKEY_ACCELERATION
+#        define MOUSEKEY_ACCELERATION 1500
+#    endif
+#    ifndef MOUSEKEY_SPEED_0
+#        define MOUSEKEY_SPEED_0 100
+#    endif
+#    ifndef MOUSEKEY_SPEED_1
+#        define MOUSEKEY_SPEED_1 500
+#    endif
+#    ifndef MOUSEKEY_SPEED_2
+#        define MOUSEKEY_SPEED_2 3000
+#    endif
+
+#    ifndef MOUSEKEY_WHEEL_INITIAL_SPEED
+#        define MOUSEKEY_WHEEL_INITIAL_SPEED 8
+#    endif
+#    ifndef MOUSEKEY_WHEEL_BASE_SPEED
+#        define MOUSEKEY_WHEEL_BASE_SPEED 40
+#    endif
+#    ifndef MOUSEKEY_WHEEL_ACCELERATION
+#        define MOUSEKEY_WHEEL_ACCELERATION 40
+#    endif
+#    ifndef MOUSEKEY_WHEEL_SPEED_0
+#        define MOUSEKEY_WHEEL_SPEED_0 4
+#    endif
+#    ifndef MOUSEKEY_WHEEL_SPEED_1
+#        define MOUSEKEY_WHEEL_SPEED_1 20
+#    endif
+#    ifndef MOUSEKEY_WHEEL_SPEED_2
+#        define MOUSEKEY_WHEEL_SPEED_2 80
+#    endif
+
+/* time between two reports, the motion is integrated over each of them */
+#    ifndef MOUSEKEY_FRAME_INTERVAL
+#        ifdef USB_POLLING_INTERVAL_MS
+#            define MOUSEKEY_FRAME_INTERVAL USB_POLLING_INTERVAL_MS
+#        else
+#            define MOUSEKEY_FRAME_INTERVAL 8
+#        endif
+#    endif
+
+#elif !defined(MK_3_SPEED)
 
 /* max value on report descriptor */
 #    ifndef MOUSEKEY_MOVE_MAX
 #        define MOUSEKEY_MOVE_MAX 127
-#    elif MOUSEKEY_MOVE_MAX > 127
-#        error MOUSEKEY_MOVE_MAX needs to be smaller than 127
+#    elif MOUSEKEY_MOVE_MAX > MOUSE_REPORT_XY_MAX
+#        error MOUSEKEY_MOVE_MAX needs to be smaller than MOUSE_REPORT_XY_MAX
 #    endif
 
 #    ifndef MOUSEKEY_WHEEL_MAX
@@ -29,7 +29,7 @@
 #include <stdbool.h>
 #include "util.h"
 
-#if defined(PROTOCOL_CHIBIOS) || defined(PROTOCOL_ARM_ATSAM)
+#if !defined(__AVR__)
 #    define PSTR(x) x
 #endif
 
@@ -127,6 +127,29 @@ extern "C"
 
 #    endif /* __AVR__ / PROTOCOL_CHIBIOS / PROTOCOL_ARM_ATSAM */
 
+#    ifdef CONSOLE_BINARY_LOG /* CONSOLE_BINARY_LOG */
+
+// Log the format and arguments, the host formats them
+#        include "debug_log.h"
+
+#        undef uprint
+#        undef uprintln
+#        undef uprintf
+#        define uprint(s) debug_log_literal(PSTR(s))
+#        define uprintln(s) debug_log_literal(PSTR(s "\r\n"))
+#        define uprintf(fmt, ...) debug_log_printf(fmt, ##__VA_ARGS__)
+
+#        ifndef USER_PRINT
+#            undef print
+#            undef println
+#            undef xprintf
+#            define print(s) uprint(s)
+#            define println(s) uprintln(s)
+#            define xprintf(fmt, ...) uprintf(fmt, ##__VA_ARGS__)
+#        endif
+
+#    endif /* CONSOLE_BINARY_LOG */
+
 // User print disables the normal print messages in the body of QMK/TMK code and
 // is meant as a lightweight alternative to NOPRINT. Use it when you only want to do
 // a spot of debugging but lack flash resources for allowing all of the codebase to
@@ -110,6 +110,8 @@ enum desktop_usages {
 #        define KEYBOARD_REPORT_BITS (NKRO_EPSIZE - 1)
 #        undef NKRO_SHARED_EP
 #        undef MOUSE_SHARED_EP
+#    elif defined(PROTOCOL_SIM)
+#        define KEYBOARD_REPORT_BITS 30
 #    else
 #        error "NKRO not supported with this protocol"
 #    endif
@@ -179,15 +181,29 @@ typedef struct {
     uint16_t usage;
 } __attribute__((packed)) report_extra_t;
 
+/* X and Y are 16-bit with MOUSE_EXTENDED_REPORT, so fast motion doesn't
+ * have to be clamped or spread over several reports.
+ */
+#ifdef MOUSE_EXTENDED_REPORT
+typedef int16_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MAX 32767
+#else
+typedef int8_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MAX 127
+#endif
+#define MOUSE_REPORT_XY_MIN (-MOUSE_REPORT_XY_MAX)
+#define MOUSE_REPORT_WHEEL_MAX 127
+#define MOUSE_REPORT_WHEEL_MIN (-MOUSE_REPORT_WHEEL_MAX)
+
 typedef struct {
 #ifdef MOUSE_SHARED_EP
     uint8_t report_id;
 #endif
-    uint8_t buttons;
-    int8_t  x;
-    int8_t  y;
-    int8_t  v;
-    int8_t  h;
+    uint8_t           buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    int8_t            v;
+    int8_t            h;
 } __attribute__((packed)) report_mouse_t;
 
 typedef struct {
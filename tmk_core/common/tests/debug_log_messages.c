@@ -0,0 +1,30 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "debug_log_messages.h"
+#include "print.h"
+
+void log_numbers(uint8_t value, int16_t offset) { xprintf("%u %d\n", value, offset); }
+
+void log_string(const char *name) { xprintf("name %s\n", name); }
+
+void log_local_string(void) {
+    char name[] = "layer";
+    xprintf("%s on\n", name);
+}
+
+void log_literal(void) { print("100%\n"); }
+
+void log_wide(uint64_t value) { xprintf("%llu %llu %llu %llu %llu %llu %llu %llu\n", value, value, value, value, value, value, value, value); }
@@ -0,0 +1,172 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "debug_log.h"
+#include "debug_log_messages.h"
+}
+
+using Bytes = std::vector<uint8_t>;
+
+class DebugLog : public testing::Test {
+   protected:
+    void SetUp() override { debug_log_clear(); }
+
+    // Everything waiting, the way the console endpoint reads it
+    Bytes drain() {
+        Bytes             bytes;
+        const uint8_t *   data;
+        debug_log_index_t length;
+        while ((length = debug_log_peek(&data))) {
+            bytes.insert(bytes.end(), data, data + length);
+            debug_log_consume(length);
+        }
+        return bytes;
+    }
+
+    static const char *format_at(const Bytes &bytes, size_t offset) {
+        const char *format;
+        memcpy(&format, &bytes[offset], sizeof(format));
+        return format;
+    }
+
+    static Bytes value(const void *data, size_t size) { return Bytes((const uint8_t *)data, (const uint8_t *)data + size); }
+};
+
+static const size_t PTR = sizeof(const char *);
+
+TEST_F(DebugLog, ArgumentsAreStoredAsPromoted) {
+    log_numbers(200, -5);
+    Bytes bytes = drain();
+
+    int  value200 = 200, value5 = -5;
+    auto expected = Bytes({uint8_t(DEBUG_LOG_FORMAT | (PTR + 2 * (1 + sizeof(int))))});
+    EXPECT_EQ(Bytes(bytes.begin(), bytes.begin() + 1), expected);
+    EXPECT_STREQ(format_at(bytes, 1), "%u %d\n");
+
+    Bytes args(bytes.begin() + 1 + PTR, bytes.end());
+    Bytes expected_args({sizeof(int)});
+    auto  v = value(&value200, sizeof(int));
+    expected_args.insert(expected_args.end(), v.begin(), v.end());
+    expected_args.push_back(sizeof(int));
+    v = value(&value5, sizeof(int));
+    expected_args.insert(expected_args.end(), v.begin(), v.end());
+    EXPECT_EQ(args, expected_args);
+}
+
+TEST_F(DebugLog, StringsAreCopiedWithTheirAddress) {
+    const char *name = "a very long layer name";
+    log_string(name);
+    Bytes bytes = drain();
+
+    ASSERT_EQ(bytes.size(), 1 + PTR + 1 + PTR + DEBUG_LOG_STRING_MAX);
+    EXPECT_EQ(bytes[1 + PTR], DEBUG_LOG_STRING | DEBUG_LOG_STRING_MAX);
+    EXPECT_EQ(format_at(bytes, 2 + PTR), name);
+    EXPECT_EQ(std::string(bytes.end() - DEBUG_LOG_STRING_MAX, bytes.end()), std::string(name, DEBUG_LOG_STRING_MAX));
+
+    // Arrays decay to strings too, their contents are gone by the time the host looks
+    log_local_string();
+    bytes = drain();
+    EXPECT_EQ(bytes[1 + PTR], DEBUG_LOG_STRING | 5);
+    EXPECT_EQ(std::string(bytes.end() - 5, bytes.end()), "layer");
+}
+
+TEST_F(DebugLog, PrintIsSentAsALiteral) {
+    log_literal();
+    Bytes bytes = drain();
+
+    ASSERT_EQ(bytes.size(), 1 + PTR);
+    EXPECT_EQ(bytes[0], DEBUG_LOG_LITERAL | PTR);
+    EXPECT_STREQ(format_at(bytes, 1), "100%\n");
+}
+
+TEST_F(DebugLog, ArgumentsThatDontFitAreLeftOut) {
+    log_wide(1);
+    Bytes bytes = drain();
+
+    // Six 8 byte arguments fit next to a 4 or 8 byte address, the rest is cut off
+    size_t fitting = (DEBUG_LOG_RECORD_MAX - PTR) / 9;
+    ASSERT_EQ(bytes.size(), 1 + PTR + fitting * 9);
+    EXPECT_EQ(bytes[0] & ~DEBUG_LOG_KIND_MASK, bytes.size() - 1);
+}
+
+TEST_F(DebugLog, TextIsSentALineAtATime) {
+    debug_log_putchar('o');
+    debug_log_putchar('k');
+    EXPECT_TRUE(drain().empty());
+
+    debug_log_putchar('\n');
+    EXPECT_EQ(drain(), Bytes({DEBUG_LOG_TEXT | 3, 'o', 'k', '\n'}));
+
+    // An unfinished line goes out ahead of the next record, so the order is kept
+    debug_log_putchar('[');
+    log_literal();
+    Bytes bytes = drain();
+    EXPECT_EQ(Bytes(bytes.begin(), bytes.begin() + 2), Bytes({DEBUG_LOG_TEXT | 1, '['}));
+    EXPECT_EQ(bytes[2], DEBUG_LOG_LITERAL | PTR);
+}
+
+TEST_F(DebugLog, FullBufferCountsDroppedRecords) {
+    // 64 bytes hold 64 / (1 + PTR) literals
+    size_t fits = DEBUG_LOG_BUFFER_SIZE / (1 + PTR);
+    for (size_t i = 0; i < fits + 3; i++) {
+        log_literal();
+    }
+    EXPECT_EQ(drain().size(), fits * (1 + PTR));
+
+    log_literal();
+    Bytes bytes = drain();
+    ASSERT_EQ(bytes.size(), 1 + PTR + 3 + 1 + PTR);
+    EXPECT_EQ(bytes[0], DEBUG_LOG_FORMAT | (PTR + 3));
+    EXPECT_EQ(format_at(bytes, 1), nullptr);
+    EXPECT_EQ(Bytes(bytes.begin() + 1 + PTR, bytes.begin() + 4 + PTR), Bytes({2, 3, 0}));
+    EXPECT_EQ(bytes[4 + PTR], DEBUG_LOG_LITERAL | PTR);
+}
+
+TEST_F(DebugLog, PeekStopsAtTheWrap) {
+    for (int i = 0; i < 6; i++) {
+        log_literal();
+    }
+    drain();
+    log_literal();
+    log_literal();
+
+    const uint8_t *data;
+    size_t         start = 6 * (1 + PTR) % DEBUG_LOG_BUFFER_SIZE;
+    size_t         first = debug_log_peek(&data);
+    EXPECT_EQ(first, std::min(2 * (1 + PTR), DEBUG_LOG_BUFFER_SIZE - start));
+    debug_log_consume(first);
+    EXPECT_EQ(first + debug_log_peek(&data), 2 * (1 + PTR));
+}
+
+TEST_F(DebugLog, CopyContinuesAcrossTheWrap) {
+    for (int i = 0; i < 6; i++) {
+        log_literal();
+    }
+    drain();
+    log_literal();
+    log_literal();
+
+    uint8_t report[2 * (1 + PTR) + 4];
+    EXPECT_EQ(debug_log_copy(report, 1 + PTR), 1 + PTR);
+    EXPECT_EQ(debug_log_copy(report, sizeof(report)), 2 * (1 + PTR));
+    EXPECT_EQ(report[0], DEBUG_LOG_LITERAL | PTR);
+    EXPECT_EQ(report[1 + PTR], DEBUG_LOG_LITERAL | PTR);
+    // Copying doesn't consume anything
+    EXPECT_EQ(drain(), Bytes(report, report + 2 * (1 + PTR)));
+}
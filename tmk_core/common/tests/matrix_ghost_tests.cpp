@@ -0,0 +1,141 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+extern "C" {
+#include "matrix_ghost.h"
+}
+
+// Every key of a 4x4 matrix, one bit each, row 0 in the low bits
+typedef uint16_t matrix_state_t;
+
+static matrix_row_t row_of(matrix_state_t state, uint8_t row) { return (state >> (row * MATRIX_COLS)) & ((1 << MATRIX_COLS) - 1); }
+
+static int popcount(matrix_row_t bits) { return __builtin_popcount(bits); }
+
+class MatrixGhost : public testing::Test {
+   protected:
+    void SetUp() override { set_real_keys(0xFFFF); }
+
+    void set_real_keys(matrix_state_t keys) {
+        real = keys;
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_ghost_update(row, 0);
+            matrix_ghost_set_real_keys(row, row_of(keys, row));
+        }
+    }
+
+    void feed(matrix_state_t state) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_ghost_update(row, row_of(state, row));
+        }
+    }
+
+    // The row by row check keyboard.c used to do on every change
+    bool expected_ghost(matrix_state_t state, uint8_t row) {
+        matrix_row_t rowdata = row_of(state & real, row);
+        if (popcount(rowdata) < 2) {
+            return false;
+        }
+        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+            if (i != row && popcount(row_of(state & real, i) & rowdata) >= 2) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The keys the row shares with any row it shares two or more with
+    matrix_row_t expected_blocked(matrix_state_t state, uint8_t row) {
+        matrix_row_t blocked = 0;
+        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+            matrix_row_t shared = row_of(state & real, i) & row_of(state & real, row);
+            if (i != row && popcount(shared) >= 2) {
+                blocked |= shared;
+            }
+        }
+        return blocked;
+    }
+
+    void check(matrix_state_t state) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            ASSERT_EQ(matrix_ghost_in_row(row), expected_ghost(state, row)) << "state " << state << " row " << (int)row;
+            ASSERT_EQ(matrix_ghost_blocked(row), expected_blocked(state, row)) << "state " << state << " row " << (int)row;
+        }
+    }
+
+    matrix_state_t real;
+};
+
+TEST_F(MatrixGhost, Rectangle) {
+    // Three corners and the ghost they make
+    feed(0x0003 | 0x0010 | 0x0020);
+    EXPECT_TRUE(matrix_ghost_in_row(0));
+    EXPECT_TRUE(matrix_ghost_in_row(1));
+    EXPECT_FALSE(matrix_ghost_in_row(2));
+    EXPECT_EQ(matrix_ghost_blocked(0), 0x3);
+    EXPECT_EQ(matrix_ghost_blocked(1), 0x3);
+
+    // Another key on the row is not part of it
+    feed(0x0003 | 0x0010 | 0x0020 | 0x0080);
+    EXPECT_EQ(matrix_ghost_blocked(1), 0x3);
+
+    feed(0x0003 | 0x0010);
+    EXPECT_FALSE(matrix_ghost_in_row(0));
+    EXPECT_FALSE(matrix_ghost_in_row(1));
+    EXPECT_EQ(matrix_ghost_blocked(1), 0);
+}
+
+TEST_F(MatrixGhost, EveryStateOneKeyAtATime) {
+    // A Gray code walks through all 2^16 states changing a single key each step
+    for (uint32_t i = 0; i <= 0xFFFF; i++) {
+        matrix_state_t state = i ^ (i >> 1);
+        feed(state);
+        check(state);
+    }
+}
+
+TEST_F(MatrixGhost, EveryTransitionOfA3x3Corner) {
+    // Any number of keys changing within one scan, between every pair of states
+    auto spread = [](uint16_t bits) -> matrix_state_t {
+        matrix_state_t state = 0;
+        for (uint8_t row = 0; row < 3; row++) {
+            state |= ((bits >> (row * 3)) & 0x7) << (row * MATRIX_COLS);
+        }
+        return state;
+    };
+    for (uint16_t from = 0; from < 512; from++) {
+        for (uint16_t to = 0; to < 512; to++) {
+            feed(spread(from));
+            feed(spread(to));
+            check(spread(to));
+        }
+    }
+}
+
+TEST_F(MatrixGhost, BlanksDontMakeGhosts) {
+    // Row 1 column 1 isn't in the keymap, it can only ever be a ghost
+    set_real_keys(0xFFFF & ~0x0020);
+    feed(0x0003 | 0x0010 | 0x0020);
+    EXPECT_FALSE(matrix_ghost_in_row(0));
+    EXPECT_FALSE(matrix_ghost_in_row(1));
+
+    for (uint32_t i = 0; i <= 0xFFFF; i++) {
+        matrix_state_t state = i ^ (i >> 1);
+        feed(state);
+        check(state);
+    }
+}
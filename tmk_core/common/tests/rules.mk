@@ -0,0 +1,26 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+matrix_ghost_DEFS := -DMATRIX_HAS_GHOST -DMATRIX_ROWS=4 -DMATRIX_COLS=4
+matrix_ghost_SRC := \
+	$(TMK_PATH)/common/tests/matrix_ghost_tests.cpp \
+	$(TMK_PATH)/common/matrix_ghost.c
+
+debug_log_DEFS := -DCONSOLE_ENABLE -DCONSOLE_BINARY_LOG -DDEBUG_LOG_BUFFER_SIZE=64
+debug_log_INC := $(TMK_PATH)/common
+debug_log_SRC := \
+	$(TMK_PATH)/common/tests/debug_log_tests.cpp \
+	$(TMK_PATH)/common/tests/debug_log_messages.c \
+	$(TMK_PATH)/common/debug_log.c
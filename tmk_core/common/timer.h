@@ -48,6 +48,21 @@ uint32_t timer_elapsed32(uint32_t last);
 #define timer_expired(current, future) (((uint16_t)current - (uint16_t)future) < 0x8000)
 #define timer_expired32(current, future) (((uint32_t)current - (uint32_t)future) < 0x80000000)
 
+/* Scan time base
+ *
+ * keyboard_task() samples the hardware timer once at the start of every
+ * scan; everything that runs during the scan (key events, tapping, one-shot
+ * and timeout checks) reads that sample instead of the hardware timer. All
+ * events of a scan see the same time, and comparisons stay correct across
+ * the 32-bit wrap after ~49.7 days of uptime as long as TIMER_DIFF_32 is used.
+ */
+extern uint32_t timer_scan_time;
+
+void                   timer_scan_update(void);
+static inline uint32_t timer_scan_read32(void) { return timer_scan_time; }
+static inline uint16_t timer_scan_read(void) { return (uint16_t)timer_scan_time; }
+static inline uint32_t timer_scan_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_scan_time, last); }
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,7 +19,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "tmk_core/common/led.h"
 #include "rgb_matrix.h"
 #include <string.h>
-#include <math.h>
 
 #ifdef USE_MASSDROP_CONFIGURATOR
 __attribute__((weak)) led_instruction_t led_instructions[] = {{.end = 1}};
@@ -59,9 +58,9 @@ uint8_t gcr_desired;
 uint8_t gcr_actual;
 uint8_t gcr_actual_last;
 #ifdef USE_MASSDROP_CONFIGURATOR
-uint8_t gcr_breathe;
-float   breathe_mult;
-float   pomod;
+uint8_t     gcr_breathe;
+uint32_t    breathe_mult;
+led_fixed_t pomod;
 #endif
 
 #define ACT_GCR_NONE 0
@@ -224,6 +223,10 @@ void init(void) {
     gcr_min_counter = 0;
     v_5v_cat_hit    = 0;
 
+#ifdef USE_MASSDROP_CONFIGURATOR
+    led_matrix_compile_patterns();
+#endif
+
     DBGC(DC_LED_MATRIX_INIT_COMPLETE);
 }
 
@@ -250,7 +253,7 @@ void flush(void) {
     }
 
 #ifdef USE_MASSDROP_CONFIGURATOR
-    breathe_mult = 1;
+    breathe_mult = LED_FIXED_ONE;
 
     if (led_animation_breathing) {
         //+60us 119 LED
@@ -262,18 +265,11 @@ void flush(void) {
             breathe_dir = 1;
 
         // Brightness curve created for 256 steps, 0 - ~98%
-        breathe_mult = 0.000015 * led_animation_breathe_cur * led_animation_breathe_cur;
-        if (breathe_mult > 1)
-            breathe_mult = 1;
-        else if (breathe_mult < 0)
-            breathe_mult = 0;
+        breathe_mult = led_pattern_breathe(led_animation_breathe_cur);
     }
 
     // This should only be performed once per frame
-    pomod = (float)((g_rgb_timer / 10) % (uint32_t)(1000.0f / led_animation_speed)) / 10.0f * led_animation_speed;
-    pomod *= 100.0f;
-    pomod = (uint32_t)pomod % 10000;
-    pomod /= 100.0f;
+    pomod = led_pattern_scroll(g_rgb_timer, led_animation_speed);
 
 #endif  // USE_MASSDROP_CONFIGURATOR
 
@@ -339,68 +335,50 @@ uint8_t led_enabled               = 1;
 uint8_t led_animation_breathe_cur = BREATHE_MIN_STEP;
 uint8_t breathe_dir               = 1;
 
-static void led_run_pattern(led_setup_t* f, float* ro, float* go, float* bo, float pos) {
-    float po;
+// Percent positions of the LEDs along x and y, for the fixed point pattern engine
+static led_fixed_t led_position[2][ISSI3733_LED_COUNT];
 
-    while (f->end != 1) {
-        po = pos;  // Reset po for new frame
+static led_band_t  led_bands[LED_PATTERN_BANDS];
+static led_band_t* led_pattern_bands[LED_PATTERN_MAX];
 
-        // Add in any moving effects
-        if ((!led_animation_direction && f->ef & EF_SCR_R) || (led_animation_direction && (f->ef & EF_SCR_L))) {
-            po -= pomod;
+void led_matrix_compile_patterns(void) {
+    uint16_t used = 0;
 
-            if (po > 100)
-                po -= 100;
-            else if (po < 0)
-                po += 100;
-        } else if ((!led_animation_direction && f->ef & EF_SCR_L) || (led_animation_direction && (f->ef & EF_SCR_R))) {
-            po += pomod;
-
-            if (po > 100)
-                po -= 100;
-            else if (po < 0)
-                po += 100;
+    for (uint8_t id = 0; id < LED_PATTERN_MAX; id++) {
+        led_pattern_bands[id] = NULL;
+        if (id < led_setups_count) {
+            uint8_t count = led_pattern_compile(led_setups[id], &led_bands[used], LED_PATTERN_BANDS - used > UINT8_MAX ? UINT8_MAX : LED_PATTERN_BANDS - used);
+            if (count) {
+                led_pattern_bands[id] = &led_bands[used];
+                used += count;
+            }
         }
+    }
 
-        // Check if LED's po is in current frame
-        if (po < f->hs) {
-            f++;
-            continue;
-        }
-        if (po > f->he) {
-            f++;
-            continue;
-        }
-        // note: < 0 or > 100 continue
-
-        // Calculate the po within the start-stop percentage for color blending
-        po = (po - f->hs) / (f->he - f->hs);
-
-        // Add in any color effects
-        if (f->ef & EF_OVER) {
-            *ro = (po * (f->re - f->rs)) + f->rs;  // + 0.5;
-            *go = (po * (f->ge - f->gs)) + f->gs;  // + 0.5;
-            *bo = (po * (f->be - f->bs)) + f->bs;  // + 0.5;
-        } else if (f->ef & EF_SUBTRACT) {
-            *ro -= (po * (f->re - f->rs)) + f->rs;  // + 0.5;
-            *go -= (po * (f->ge - f->gs)) + f->gs;  // + 0.5;
-            *bo -= (po * (f->be - f->bs)) + f->bs;  // + 0.5;
-        } else {
-            *ro += (po * (f->re - f->rs)) + f->rs;  // + 0.5;
-            *go += (po * (f->ge - f->gs)) + f->gs;  // + 0.5;
-            *bo += (po * (f->be - f->bs)) + f->bs;  // + 0.5;
-        }
+    for (uint8_t i = 0; i < ISSI3733_LED_COUNT; i++) {
+        led_position[0][i] = led_pattern_position(g_led_config.point[i].x, 224);
+        led_position[1][i] = led_pattern_position(g_led_config.point[i].y, 64);
+    }
+}
 
-        f++;
+static void led_run_pattern(uint8_t id, int32_t rgb[3], led_fixed_t po) {
+    if (id < LED_PATTERN_MAX && led_pattern_bands[id]) {
+        led_pattern_run(led_pattern_bands[id], po, pomod, led_animation_direction, rgb);
+        return;
+    }
+
+    // Did not fit in led_bands, compile one band at a time
+    for (led_setup_t* f = led_setups[id]; !f->end; f++) {
+        led_band_t band[2] = {[1] = {.end = 1}};
+        led_pattern_compile(f, band, 1);
+        led_pattern_run(band, po, pomod, led_animation_direction, rgb);
     }
 }
 
 static void led_matrix_massdrop_config_override(int i) {
-    float ro = 0;
-    float go = 0;
-    float bo = 0;
+    int32_t rgb[3] = {0, 0, 0};
 
-    float po = (led_animation_orientation) ? (float)g_led_config.point[i].y / 64.f * 100 : (float)g_led_config.point[i].x / 224.f * 100;
+    led_fixed_t po = led_position[led_animation_orientation ? 1 : 0][i];
 
     uint8_t highest_active_layer = biton32(layer_state);
 
@@ -429,42 +407,21 @@ static void led_matrix_massdrop_config_override(int i) {
             }
 
             if (led_cur_instruction->flags & LED_FLAG_USE_RGB) {
-                ro = led_cur_instruction->r;
-                go = led_cur_instruction->g;
-                bo = led_cur_instruction->b;
+                rgb[0] = led_cur_instruction->r * LED_FIXED_ONE;
+                rgb[1] = led_cur_instruction->g * LED_FIXED_ONE;
+                rgb[2] = led_cur_instruction->b * LED_FIXED_ONE;
             } else if (led_cur_instruction->flags & LED_FLAG_USE_PATTERN) {
-                led_run_pattern(led_setups[led_cur_instruction->pattern_id], &ro, &go, &bo, po);
+                led_run_pattern(led_cur_instruction->pattern_id, rgb, po);
             } else if (led_cur_instruction->flags & LED_FLAG_USE_ROTATE_PATTERN) {
-                led_run_pattern(led_setups[led_animation_id], &ro, &go, &bo, po);
+                led_run_pattern(led_animation_id, rgb, po);
             }
 
         next_iter:
             led_cur_instruction++;
         }
-
-        if (ro > 255)
-            ro = 255;
-        else if (ro < 0)
-            ro = 0;
-        if (go > 255)
-            go = 255;
-        else if (go < 0)
-            go = 0;
-        if (bo > 255)
-            bo = 255;
-        else if (bo < 0)
-            bo = 0;
-
-        if (led_animation_breathing) {
-            ro *= breathe_mult;
-            go *= breathe_mult;
-            bo *= breathe_mult;
-        }
     }
 
-    led_buffer[i].r = (uint8_t)ro;
-    led_buffer[i].g = (uint8_t)go;
-    led_buffer[i].b = (uint8_t)bo;
+    led_pattern_output(rgb, led_animation_breathing ? breathe_mult : LED_FIXED_ONE, &led_buffer[i].r, &led_buffer[i].g, &led_buffer[i].b);
 }
 
 #endif  // USE_MASSDROP_CONFIGURATOR
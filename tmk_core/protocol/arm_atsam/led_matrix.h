@@ -92,27 +92,17 @@ void led_matrix_indicators(void);
 
 #ifdef USE_MASSDROP_CONFIGURATOR
 
-#    define EF_NONE 0x00000000      // No effect
-#    define EF_OVER 0x00000001      // Overwrite any previous color information with new
-#    define EF_SCR_L 0x00000002     // Scroll left
-#    define EF_SCR_R 0x00000004     // Scroll right
-#    define EF_SUBTRACT 0x00000008  // Subtract color values
-
-typedef struct led_setup_s {
-    float    hs;   // Band begin at percent
-    float    he;   // Band end at percent
-    uint8_t  rs;   // Red start value
-    uint8_t  re;   // Red end value
-    uint8_t  gs;   // Green start value
-    uint8_t  ge;   // Green end value
-    uint8_t  bs;   // Blue start value
-    uint8_t  be;   // Blue end value
-    uint32_t ef;   // Animation and color effects
-    uint8_t  end;  // Set to signal end of the setup
-} led_setup_t;
-
-extern const uint8_t led_setups_count;
-extern void *        led_setups[];
+#    include "led_pattern.h"
+
+#    ifndef LED_PATTERN_MAX
+#        define LED_PATTERN_MAX 32  // Patterns compiled for the fixed point engine, later ones are compiled on every use
+#    endif
+#    ifndef LED_PATTERN_BANDS
+#        define LED_PATTERN_BANDS 128  // Bands of all compiled patterns, including their end markers
+#    endif
+
+// Compiles led_setups for rendering, must be called again after changing them
+void led_matrix_compile_patterns(void);
 
 // LED Extra Instructions
 #    define LED_FLAG_NULL 0x00                // Matching and coloring not used (default)
@@ -0,0 +1,120 @@
+/*
+Copyright 2018 Massdrop Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_pattern.h"
+
+#define LED_COLOR_MAX (255 * LED_FIXED_ONE)
+
+led_fixed_t led_pattern_scroll(uint32_t time, float speed) {
+    // Same steps as the original float version, which ends up in hundredths of a percent
+    float pomod = (float)((time / 10) % (uint32_t)(1000.0f / speed)) / 10.0f * speed;
+    pomod *= 100.0f;
+
+    uint32_t hundredths = (uint32_t)pomod % 10000;
+    return ((int64_t)hundredths * LED_FIXED_ONE + 50) / 100;
+}
+
+uint32_t led_pattern_breathe(uint8_t step) {
+    // Brightness curve created for 256 steps, 0 - ~98%: 0.000015 * step * step
+    uint32_t breathe = (uint64_t)step * step * 15 * LED_FIXED_ONE / 1000000;
+    return breathe > LED_FIXED_ONE ? LED_FIXED_ONE : breathe;
+}
+
+static led_fixed_t to_fixed(float value) { return (led_fixed_t)(value * LED_FIXED_ONE + (value < 0 ? -0.5f : 0.5f)); }
+
+uint8_t led_pattern_compile(const led_setup_t *setup, led_band_t *bands, uint8_t size) {
+    for (uint8_t count = 0; count < size; count++, setup++) {
+        led_band_t *band = &bands[count];
+
+        band->end = setup->end;
+        if (setup->end) {
+            return count + 1;
+        }
+
+        band->hs = to_fixed(setup->hs);
+        band->he = to_fixed(setup->he);
+        band->ef = setup->ef;
+
+        const uint8_t starts[3] = {setup->rs, setup->gs, setup->bs};
+        const uint8_t ends[3]   = {setup->re, setup->ge, setup->be};
+        for (uint8_t c = 0; c < 3; c++) {
+            int64_t slope = 0;
+            if (band->he > band->hs) {
+                slope = ((int64_t)(ends[c] - starts[c]) << 32) / (band->he - band->hs);
+                // Only reached by bands narrower than 1/128 percent
+                if (slope > INT32_MAX) {
+                    slope = INT32_MAX;
+                } else if (slope < -INT32_MAX) {
+                    slope = -INT32_MAX;
+                }
+            }
+            band->start[c] = starts[c] * LED_FIXED_ONE;
+            band->slope[c] = slope;
+        }
+    }
+    return 0;
+}
+
+void led_pattern_run(const led_band_t *band, led_fixed_t position, led_fixed_t scroll, bool reverse, int32_t rgb[3]) {
+    for (; !band->end; band++) {
+        led_fixed_t po = position;
+
+        // Add in any moving effects
+        if ((!reverse && band->ef & EF_SCR_R) || (reverse && (band->ef & EF_SCR_L))) {
+            po -= scroll;
+        } else if ((!reverse && band->ef & EF_SCR_L) || (reverse && (band->ef & EF_SCR_R))) {
+            po += scroll;
+        }
+        if (po > LED_FIXED_HUNDRED) {
+            po -= LED_FIXED_HUNDRED;
+        } else if (po < 0) {
+            po += LED_FIXED_HUNDRED;
+        }
+
+        // Check if LED's po is in current frame
+        if (po < band->hs || po > band->he) {
+            continue;
+        }
+
+        for (uint8_t c = 0; c < 3; c++) {
+            int32_t color = band->start[c] + (int32_t)(((int64_t)(po - band->hs) * band->slope[c]) >> LED_FIXED_SHIFT);
+
+            // Add in any color effects
+            if (band->ef & EF_OVER) {
+                rgb[c] = color;
+            } else if (band->ef & EF_SUBTRACT) {
+                rgb[c] -= color;
+            } else {
+                rgb[c] += color;
+            }
+        }
+    }
+}
+
+void led_pattern_output(const int32_t rgb[3], uint32_t breathe, uint8_t *r, uint8_t *g, uint8_t *b) {
+    uint8_t *out[3] = {r, g, b};
+
+    for (uint8_t c = 0; c < 3; c++) {
+        int32_t color = rgb[c];
+        if (color > LED_COLOR_MAX) {
+            color = LED_COLOR_MAX;
+        } else if (color < 0) {
+            color = 0;
+        }
+        *out[c] = ((uint64_t)color * breathe) >> (2 * LED_FIXED_SHIFT);
+    }
+}
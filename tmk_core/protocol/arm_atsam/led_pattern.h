@@ -0,0 +1,87 @@
+/*
+Copyright 2018 Massdrop Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef _LED_PATTERN_H_
+#define _LED_PATTERN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*-------------------------  Legacy Lighting Support  ------------------------*/
+
+#define EF_NONE 0x00000000      // No effect
+#define EF_OVER 0x00000001      // Overwrite any previous color information with new
+#define EF_SCR_L 0x00000002     // Scroll left
+#define EF_SCR_R 0x00000004     // Scroll right
+#define EF_SUBTRACT 0x00000008  // Subtract color values
+
+typedef struct led_setup_s {
+    float    hs;   // Band begin at percent
+    float    he;   // Band end at percent
+    uint8_t  rs;   // Red start value
+    uint8_t  re;   // Red end value
+    uint8_t  gs;   // Green start value
+    uint8_t  ge;   // Green end value
+    uint8_t  bs;   // Blue start value
+    uint8_t  be;   // Blue end value
+    uint32_t ef;   // Animation and color effects
+    uint8_t  end;  // Set to signal end of the setup
+} led_setup_t;
+
+extern const uint8_t led_setups_count;
+extern void *        led_setups[];
+
+// Fixed point pattern engine
+//
+// Positions and band limits are percentages in 16.16 fixed point, colors are
+// accumulated as 16.16 fixed point as well. Patterns are compiled once into
+// led_band_t, so rendering a frame needs no float math per LED.
+
+typedef int32_t led_fixed_t;
+
+#define LED_FIXED_SHIFT 16
+#define LED_FIXED_ONE ((led_fixed_t)1 << LED_FIXED_SHIFT)
+#define LED_FIXED_HUNDRED (100 * LED_FIXED_ONE)
+
+typedef struct led_band_s {
+    led_fixed_t hs;        // Band begin at percent
+    led_fixed_t he;        // Band end at percent
+    int32_t     start[3];  // Red, green and blue start values
+    int32_t     slope[3];  // Change of red, green and blue over the band, per fixed point percent, in 16.16 fixed point
+    uint8_t     ef;        // Animation and color effects
+    uint8_t     end;       // Set to signal end of the pattern
+} led_band_t;
+
+// Position of an LED at coordinate in 0..range as a percentage
+static inline led_fixed_t led_pattern_position(uint8_t coordinate, uint8_t range) { return ((led_fixed_t)coordinate * LED_FIXED_HUNDRED) / range; }
+
+// Scroll offset for the frame at the given time and animation speed
+led_fixed_t led_pattern_scroll(uint32_t time, float speed);
+
+// Multiplier for the breathe step in 16.16 fixed point, 0 to LED_FIXED_ONE
+uint32_t led_pattern_breathe(uint8_t step);
+
+// Compiles the bands of setup, up to and including its end marker, into at
+// most size bands. Returns the number of bands written, or 0 if they don't fit.
+uint8_t led_pattern_compile(const led_setup_t *setup, led_band_t *bands, uint8_t size);
+
+// Accumulates the pattern at the LED's position into rgb (16.16 fixed point)
+void led_pattern_run(const led_band_t *bands, led_fixed_t position, led_fixed_t scroll, bool reverse, int32_t rgb[3]);
+
+// Clamps the accumulated color, applies the breathe multiplier and stores the result
+void led_pattern_output(const int32_t rgb[3], uint32_t breathe, uint8_t *r, uint8_t *g, uint8_t *b);
+
+#endif  //_LED_PATTERN_H_
@@ -0,0 +1,208 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+extern "C" {
+#include "led_pattern.h"
+}
+
+// The float pipeline the fixed point engine replaces, as it was in led_matrix.c
+namespace reference {
+
+static float pomod;
+
+static void scroll(uint32_t time, float speed) {
+    pomod = (float)((time / 10) % (uint32_t)(1000.0f / speed)) / 10.0f * speed;
+    pomod *= 100.0f;
+    pomod = (uint32_t)pomod % 10000;
+    pomod /= 100.0f;
+}
+
+static float breathe(uint8_t step) {
+    float breathe_mult = 0.000015 * step * step;
+    if (breathe_mult > 1)
+        breathe_mult = 1;
+    else if (breathe_mult < 0)
+        breathe_mult = 0;
+    return breathe_mult;
+}
+
+static void run_pattern(led_setup_t* f, float* ro, float* go, float* bo, float pos, uint8_t led_animation_direction) {
+    float po;
+
+    while (f->end != 1) {
+        po = pos;  // Reset po for new frame
+
+        // Add in any moving effects
+        if ((!led_animation_direction && f->ef & EF_SCR_R) || (led_animation_direction && (f->ef & EF_SCR_L))) {
+            po -= pomod;
+
+            if (po > 100)
+                po -= 100;
+            else if (po < 0)
+                po += 100;
+        } else if ((!led_animation_direction && f->ef & EF_SCR_L) || (led_animation_direction && (f->ef & EF_SCR_R))) {
+            po += pomod;
+
+            if (po > 100)
+                po -= 100;
+            else if (po < 0)
+                po += 100;
+        }
+
+        // Check if LED's po is in current frame
+        if (po < f->hs) {
+            f++;
+            continue;
+        }
+        if (po > f->he) {
+            f++;
+            continue;
+        }
+
+        // Calculate the po within the start-stop percentage for color blending
+        po = (po - f->hs) / (f->he - f->hs);
+
+        // Add in any color effects
+        if (f->ef & EF_OVER) {
+            *ro = (po * (f->re - f->rs)) + f->rs;
+            *go = (po * (f->ge - f->gs)) + f->gs;
+            *bo = (po * (f->be - f->bs)) + f->bs;
+        } else if (f->ef & EF_SUBTRACT) {
+            *ro -= (po * (f->re - f->rs)) + f->rs;
+            *go -= (po * (f->ge - f->gs)) + f->gs;
+            *bo -= (po * (f->be - f->bs)) + f->bs;
+        } else {
+            *ro += (po * (f->re - f->rs)) + f->rs;
+            *go += (po * (f->ge - f->gs)) + f->gs;
+            *bo += (po * (f->be - f->bs)) + f->bs;
+        }
+
+        f++;
+    }
+}
+
+static uint8_t output(float value, bool breathing, float breathe_mult) {
+    if (value > 255)
+        value = 255;
+    else if (value < 0)
+        value = 0;
+    if (breathing) {
+        value *= breathe_mult;
+    }
+    return (uint8_t)value;
+}
+
+}  // namespace reference
+
+class LedPattern : public testing::Test {
+   public:
+    void SetUp() override {
+        for (uint8_t id = 0; id < led_setups_count; id++) {
+            ASSERT_GT(led_pattern_compile((led_setup_t*)led_setups[id], bands[id], 16), 0);
+        }
+    }
+
+    led_band_t bands[32][16];
+    unsigned   compared = 0;
+    unsigned   exact    = 0;
+
+    // Renders patterns a then b on top of it for one LED with both engines.
+    // The last pattern (off) adds nothing, so it is used when stacking isn't tested.
+    void compare(uint8_t a, uint8_t b, uint8_t coordinate, uint8_t range, uint32_t time, float speed, bool reverse, uint8_t breathe_step, bool breathing) {
+        reference::scroll(time, speed);
+        float pos = (float)coordinate / range * 100;
+        float ro = 0, go = 0, bo = 0;
+        reference::run_pattern((led_setup_t*)led_setups[a], &ro, &go, &bo, pos, reverse);
+        reference::run_pattern((led_setup_t*)led_setups[b], &ro, &go, &bo, pos, reverse);
+        float   mult        = reference::breathe(breathe_step);
+        uint8_t expected[3] = {reference::output(ro, breathing, mult), reference::output(go, breathing, mult), reference::output(bo, breathing, mult)};
+
+        led_fixed_t scroll   = led_pattern_scroll(time, speed);
+        led_fixed_t position = led_pattern_position(coordinate, range);
+        int32_t     rgb[3]   = {0, 0, 0};
+        led_pattern_run(bands[a], position, scroll, reverse, rgb);
+        led_pattern_run(bands[b], position, scroll, reverse, rgb);
+        uint8_t actual[3];
+        led_pattern_output(rgb, breathing ? led_pattern_breathe(breathe_step) : LED_FIXED_ONE, &actual[0], &actual[1], &actual[2]);
+
+        for (int c = 0; c < 3; c++) {
+            int diff = std::abs(actual[c] - expected[c]);
+            compared++;
+            exact += diff == 0;
+            ASSERT_LE(diff, 1) << "pattern " << (int)a << "+" << (int)b << " coordinate " << (int)coordinate << "/" << (int)range << " time " << time << " speed " << speed << " channel " << c;
+        }
+    }
+};
+
+TEST_F(LedPattern, EveryPatternMatchesTheFloatVersion) {
+    for (uint8_t id = 0; id < led_setups_count; id++) {
+        for (uint32_t time = 0; time < 3000; time += 37) {
+            for (uint8_t x = 0; x <= 224; x++) {
+                compare(id, led_setups_count - 1, x, 224, time, 4.0f, false, 0, false);
+                compare(id, led_setups_count - 1, x, 224, time, 4.0f, true, 0, false);
+            }
+            for (uint8_t y = 0; y <= 64; y++) {
+                compare(id, led_setups_count - 1, y, 64, time, 4.0f, false, 0, false);
+            }
+        }
+    }
+    EXPECT_GT(exact, compared * 99 / 100);
+}
+
+TEST_F(LedPattern, StackedPatternsMatchTheFloatVersion) {
+    for (uint8_t a = 0; a < led_setups_count; a++) {
+        for (uint8_t b = 0; b < led_setups_count; b++) {
+            for (uint8_t x = 0; x <= 224; x += 3) {
+                compare(a, b, x, 224, 12345, 2.5f, false, 0, false);
+            }
+        }
+    }
+    EXPECT_GT(exact, compared * 99 / 100);
+}
+
+TEST_F(LedPattern, ScrollSpeedsMatchTheFloatVersion) {
+    const float speeds[] = {0.25f, 1.0f, 3.3f, 4.0f, 7.5f, 10.0f};
+    for (float speed : speeds) {
+        for (uint32_t time = 0; time < 20000; time += 113) {
+            for (uint8_t x = 0; x <= 224; x += 7) {
+                compare(0, led_setups_count - 1, x, 224, time, speed, false, 0, false);
+                compare(8, led_setups_count - 1, x, 224, time, speed, true, 0, false);
+            }
+        }
+    }
+    EXPECT_GT(exact, compared * 99 / 100);
+}
+
+TEST_F(LedPattern, BreathingMatchesTheFloatVersion) {
+    for (int step = 0; step <= 255; step++) {
+        for (uint8_t x = 0; x <= 224; x += 5) {
+            compare(2, led_setups_count - 1, x, 224, 500, 4.0f, false, step, true);
+            compare(7, led_setups_count - 1, x, 224, 500, 4.0f, false, step, true);
+        }
+    }
+    EXPECT_EQ(led_pattern_breathe(0), 0);
+    EXPECT_LE(led_pattern_breathe(255), LED_FIXED_ONE);
+}
+
+TEST_F(LedPattern, CompileRejectsPatternsThatDontFit) {
+    led_band_t small[2];
+    // Rainbow has six bands plus the end marker
+    EXPECT_EQ(led_pattern_compile((led_setup_t*)led_setups[0], small, 2), 0);
+    EXPECT_EQ(led_pattern_compile((led_setup_t*)led_setups[3], small, 2), 2);
+    EXPECT_TRUE(small[1].end);
+}
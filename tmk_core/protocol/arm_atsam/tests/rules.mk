@@ -0,0 +1,21 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+arm_atsam_led_pattern_DEFS := -DUSE_MASSDROP_CONFIGURATOR
+arm_atsam_led_pattern_INC := $(TMK_PATH)/protocol/arm_atsam
+arm_atsam_led_pattern_SRC := \
+	$(TMK_PATH)/protocol/arm_atsam/tests/led_pattern_tests.cpp \
+	$(TMK_PATH)/protocol/arm_atsam/led_pattern.c \
+	$(TMK_PATH)/protocol/arm_atsam/led_matrix_programs.c
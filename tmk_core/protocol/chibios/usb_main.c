@@ -25,6 +25,8 @@
  *   makes the assumption this is safe to avoid littering with preprocessor directives.
  */
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 
@@ -51,6 +53,10 @@ extern keymap_config_t keymap_config;
 #    include "joystick.h"
 #endif
 
+#ifdef MIDI_ENABLE
+#    include "qmk_midi.h"
+#endif
+
 /* ---------------------------------------------------------
  *       Global interface variables and declarations
  * ---------------------------------------------------------
@@ -780,11 +786,31 @@ void send_consumer(uint16_t data) {
 
 #ifdef CONSOLE_ENABLE
 
+#    ifdef CONSOLE_BINARY_LOG
+int8_t sendchar(uint8_t c) {
+    debug_log_putchar(c);
+    return 0;
+}
+
+// Hands the binary log to the console queue a whole report at a time, as many as fit without waiting
+static void console_log_task(void) {
+    uint8_t           report[CONSOLE_EPSIZE];
+    debug_log_index_t length;
+    while ((length = debug_log_copy(report, sizeof(report)))) {
+        // A short report empties the log, so the zeros never split a record
+        memset(report + length, 0, sizeof(report) - length);
+        // A full report takes a whole queue buffer, so it is written completely or not at all
+        if (chnWriteTimeout(&drivers.console_driver.driver, report, sizeof(report), TIME_IMMEDIATE) < sizeof(report)) break;
+        debug_log_consume(length);
+    }
+}
+#    else
 int8_t sendchar(uint8_t c) {
     // The previous implmentation had timeouts, but I think it's better to just slow down
     // and make sure that everything is transferred, rather than dropping stuff
     return chnWrite(&drivers.console_driver.driver, &c, 1);
 }
+#    endif
 
 // Just a dummy function for now, this could be exposed as a weak function
 // Or connected to the actual QMK console
@@ -802,6 +828,10 @@ void console_task(void) {
             console_receive(buffer, size);
         }
     } while (size > 0);
+
+#    ifdef CONSOLE_BINARY_LOG
+    console_log_task();
+#    endif
 }
 
 #else  /* CONSOLE_ENABLE */
@@ -843,7 +873,7 @@ void raw_hid_task(void) {
 
 #ifdef MIDI_ENABLE
 
-void send_midi_packet(MIDI_EventPacket_t *event) { chnWrite(&drivers.midi_driver.driver, (uint8_t *)event, sizeof(MIDI_EventPacket_t)); }
+void send_midi_packets(const uint8_t *data, uint8_t length) { chnWrite(&drivers.midi_driver.driver, data, length); }
 
 bool recv_midi_packet(MIDI_EventPacket_t *const event) {
     size_t size = chnReadTimeout(&drivers.midi_driver.driver, (uint8_t *)event, sizeof(MIDI_EventPacket_t), TIME_IMMEDIATE);
@@ -866,6 +896,8 @@ void midi_ep_task(void) {
 
 void virtser_send(const uint8_t byte) { chnWrite(&drivers.serial_driver.driver, &byte, 1); }
 
+void virtser_send_buffer(const uint8_t *data, uint8_t length) { chnWrite(&drivers.serial_driver.driver, data, length); }
+
 __attribute__((weak)) void virtser_recv(uint8_t c) {
     // Ignore by default
 }
@@ -252,7 +252,36 @@ static void raw_hid_task(void) {
 /*******************************************************************************
  * Console
  ******************************************************************************/
-#ifdef CONSOLE_ENABLE
+#ifdef CONSOLE_BINARY_LOG
+/** \brief Console Log Task
+ *
+ * Sends what's waiting in the binary log, one report per call and only when
+ * the bank is free, so it never holds up the main loop.
+ */
+static void console_log_task(void) {
+    if (USB_DeviceState != DEVICE_STATE_Configured) return;
+
+    const uint8_t *data;
+    if (!debug_log_peek(&data)) return;
+
+    uint8_t ep = Endpoint_GetCurrentEndpoint();
+    Endpoint_SelectEndpoint(CONSOLE_IN_EPNUM);
+    if (Endpoint_IsEnabled() && Endpoint_IsConfigured() && Endpoint_IsINReady()) {
+        uint8_t           sent = 0;
+        debug_log_index_t length;
+        while (sent < CONSOLE_EPSIZE && (length = debug_log_peek(&data))) {
+            if (length > CONSOLE_EPSIZE - sent) length = CONSOLE_EPSIZE - sent;
+            Endpoint_Write_Stream_LE(data, length, NULL);
+            debug_log_consume(length);
+            sent += length;
+        }
+        // Zeros are padding to the decoder
+        while (sent++ < CONSOLE_EPSIZE) Endpoint_Write_8(0);
+        Endpoint_ClearIN();
+    }
+    Endpoint_SelectEndpoint(ep);
+}
+#elif defined(CONSOLE_ENABLE)
 /** \brief Console Task
  *
  * FIXME: Needs doc
@@ -444,7 +473,7 @@ void EVENT_USB_Device_WakeUp() {
 #endif
 }
 
-#ifdef CONSOLE_ENABLE
+#if defined(CONSOLE_ENABLE) && !defined(CONSOLE_BINARY_LOG)
 static bool console_flush = false;
 #    define CONSOLE_FLUSH_SET(b)                                     \
         do {                                                         \
@@ -730,16 +759,24 @@ static void send_mouse(report_mouse_t *report) {
     uint8_t where = where_to_send();
 
     if (where == OUTPUT_BLUETOOTH || where == OUTPUT_USB_AND_BT) {
+#        ifdef MOUSE_EXTENDED_REPORT
+        // The Bluetooth modules only take 8-bit motion
+        int8_t x = report->x < -127 ? -127 : report->x > 127 ? 127 : report->x;
+        int8_t y = report->y < -127 ? -127 : report->y > 127 ? 127 : report->y;
+#        else
+        int8_t x = report->x;
+        int8_t y = report->y;
+#        endif
 #        ifdef MODULE_ADAFRUIT_BLE
         // FIXME: mouse buttons
-        adafruit_ble_send_mouse_move(report->x, report->y, report->v, report->h, report->buttons);
+        adafruit_ble_send_mouse_move(x, y, report->v, report->h, report->buttons);
 #        else
         serial_send(0xFD);
         serial_send(0x00);
         serial_send(0x03);
         serial_send(report->buttons);
-        serial_send(report->x);
-        serial_send(report->y);
+        serial_send(x);
+        serial_send(y);
         serial_send(report->v);  // should try sending the wheel v here
         serial_send(report->h);  // should try sending the wheel h here
         serial_send(0x00);
@@ -835,7 +872,12 @@ static void send_consumer(uint16_t data) {
 /*******************************************************************************
  * sendchar
  ******************************************************************************/
-#ifdef CONSOLE_ENABLE
+#ifdef CONSOLE_BINARY_LOG
+int8_t sendchar(uint8_t c) {
+    debug_log_putchar(c);
+    return 0;
+}
+#elif defined(CONSOLE_ENABLE)
 #    define SEND_TIMEOUT 5
 /** \brief Send Char
  *
@@ -923,7 +965,16 @@ USB_ClassInfo_MIDI_Device_t USB_MIDI_Interface = {
 
 // clang-format on
 
-void send_midi_packet(MIDI_EventPacket_t *event) { MIDI_Device_SendEventPacket(&USB_MIDI_Interface, event); }
+void send_midi_packets(const uint8_t *data, uint8_t length) {
+    if (USB_DeviceState != DEVICE_STATE_Configured) {
+        return;
+    }
+
+    Endpoint_SelectEndpoint(USB_MIDI_Interface.Config.DataINEndpoint.Address);
+    if (Endpoint_Write_Stream_LE(data, length, NULL) == ENDPOINT_RWSTREAM_NoError) {
+        MIDI_Device_Flush(&USB_MIDI_Interface);
+    }
+}
 
 bool recv_midi_packet(MIDI_EventPacket_t *const event) { return MIDI_Device_ReceiveEventPacket(&USB_MIDI_Interface, event); }
 
@@ -993,6 +1044,46 @@ void virtser_send(const uint8_t byte) {
         Endpoint_SelectEndpoint(ep);
     }
 }
+
+/** \brief Virtual Serial Send Buffer
+ *
+ * Writes the whole buffer before flushing, so a packet that fits the endpoint goes out in a single transfer.
+ */
+void virtser_send_buffer(const uint8_t *data, uint8_t length) {
+    uint8_t timeout = 255;
+    uint8_t ep      = Endpoint_GetCurrentEndpoint();
+
+    if (cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR) {
+        /* IN packet */
+        Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+
+        if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
+            Endpoint_SelectEndpoint(ep);
+            return;
+        }
+
+        for (uint8_t i = 0; i < length; i++) {
+            if (!Endpoint_IsReadWriteAllowed()) {
+                /* bank full, send what is there and wait for the next one */
+                if (Endpoint_BytesInEndpoint()) {
+                    Endpoint_ClearIN();
+                }
+                while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
+                if (!Endpoint_IsReadWriteAllowed()) {
+                    break;
+                }
+            }
+            Endpoint_Write_8(data[i]);
+        }
+        CDC_Device_Flush(&cdc_device);
+
+        if (Endpoint_IsINReady()) {
+            Endpoint_ClearIN();
+        }
+
+        Endpoint_SelectEndpoint(ep);
+    }
+}
 #endif
 
 /*******************************************************************************
@@ -1101,6 +1192,10 @@ int main(void) {
         raw_hid_task();
 #endif
 
+#ifdef CONSOLE_BINARY_LOG
+        console_log_task();
+#endif
+
 #if !defined(INTERRUPT_CONTROL_ENDPOINT)
         USB_USBTask();
 #endif
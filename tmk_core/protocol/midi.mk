@@ -2,6 +2,7 @@ MIDI_DIR = protocol/midi
 
 SRC += midi.c \
 	   midi_device.c \
+	   midi_queue.c \
 	   bytequeue/bytequeue.c \
 	   bytequeue/interrupt_setting.c \
 	   sysex_tools.c \
@@ -0,0 +1,84 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "midi_queue.h"
+#include "midi.h"
+
+// USB MIDI code index numbers, the low nibble of the event packet header
+#define CIN_SYS_COMMON_2 0x2
+#define CIN_SYS_COMMON_3 0x3
+#define CIN_SYSEX_START_OR_CONT 0x4
+#define CIN_SYSEX_ENDS_IN_1 0x5
+#define CIN_SYSEX_ENDS_IN_2 0x6
+#define CIN_SYSEX_ENDS_IN_3 0x7
+
+#define MIDI_CABLE 0
+
+static uint8_t queue[MIDI_QUEUE_SIZE * MIDI_EVENT_PACKET_SIZE];
+static uint8_t queue_count = 0;
+
+static uint8_t code_index_number(uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    // if the length is undefined we assume it is a SYSEX message
+    if (midi_packet_length(byte0) == UNDEFINED) {
+        switch (cnt) {
+            case 3:
+                return byte2 == SYSEX_END ? CIN_SYSEX_ENDS_IN_3 : CIN_SYSEX_START_OR_CONT;
+            case 2:
+                return byte1 == SYSEX_END ? CIN_SYSEX_ENDS_IN_2 : CIN_SYSEX_START_OR_CONT;
+            case 1:
+                return byte0 == SYSEX_END ? CIN_SYSEX_ENDS_IN_1 : CIN_SYSEX_START_OR_CONT;
+            default:
+                return 0;  // invalid cnt
+        }
+    }
+
+    switch (byte0) {
+        case MIDI_SONGPOSITION:
+            return CIN_SYS_COMMON_3;
+        case MIDI_SONGSELECT:
+        case MIDI_TC_QUARTERFRAME:
+            return CIN_SYS_COMMON_2;
+        default:
+            // channel messages use their status nibble, the rest are single bytes
+            return byte0 >> 4;
+    }
+}
+
+bool midi_queue_add(uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    uint8_t cin = code_index_number(cnt, byte0, byte1, byte2);
+    if (!cin) {
+        return false;
+    }
+
+    if (queue_count == MIDI_QUEUE_SIZE) {
+        midi_queue_flush();
+    }
+
+    uint8_t *packet = &queue[queue_count * MIDI_EVENT_PACKET_SIZE];
+    packet[0]       = (MIDI_CABLE << 4) | cin;
+    packet[1]       = byte0;
+    packet[2]       = byte1;
+    packet[3]       = byte2;
+    queue_count++;
+    return true;
+}
+
+void midi_queue_flush(void) {
+    if (queue_count) {
+        send_midi_packets(queue, queue_count * MIDI_EVENT_PACKET_SIZE);
+        queue_count = 0;
+    }
+}
@@ -0,0 +1,44 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Outgoing USB MIDI event packets
+ *
+ * Every message generated during a scan is queued as a 4 byte USB MIDI event
+ * packet, and midi_queue_flush() hands them all to send_midi_packets() at the
+ * end of the scan, so the notes of a chord or everything a sustain pedal
+ * release turns off arrive in the same USB transfer. A full queue is flushed
+ * early, so MIDI_QUEUE_SIZE should match the endpoint size.
+ */
+
+#ifndef MIDI_QUEUE_SIZE
+#    define MIDI_QUEUE_SIZE 16  // events, 64 bytes
+#endif
+
+#define MIDI_EVENT_PACKET_SIZE 4
+
+// Queues a message, the same arguments as a midi_var_byte_func_t. Returns false if it can't be encoded.
+bool midi_queue_add(uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2);
+
+// Sends whatever is queued, and empties the queue
+void midi_queue_flush(void);
+
+// Implemented by the protocol, writes length bytes of event packets in one transfer
+void send_midi_packets(const uint8_t *data, uint8_t length);
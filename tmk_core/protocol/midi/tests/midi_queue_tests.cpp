@@ -0,0 +1,132 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "midi_queue.h"
+#include "midi_device.h"
+#include "midi.h"
+}
+
+using Packets = std::vector<uint8_t>;
+
+static std::vector<Packets> transfers;
+
+extern "C" void send_midi_packets(const uint8_t *data, uint8_t length) { transfers.emplace_back(data, data + length); }
+
+static void queue_send(MidiDevice *device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) { midi_queue_add(cnt, byte0, byte1, byte2); }
+
+class MidiQueue : public testing::Test {
+   protected:
+    void SetUp() override {
+        midi_queue_flush();
+        transfers.clear();
+        device.send_func = queue_send;
+    }
+
+    MidiDevice device = {};
+};
+
+TEST_F(MidiQueue, ChannelMessages) {
+    midi_send_noteon(&device, 2, 60, 100);
+    midi_send_noteoff(&device, 2, 60, 0);
+    midi_send_cc(&device, 0, 0x40, 127);
+    midi_send_pitchbend(&device, 15, 0x1fff);
+    midi_send_programchange(&device, 1, 5);
+    midi_queue_flush();
+
+    ASSERT_EQ(transfers.size(), 1);
+    EXPECT_EQ(transfers[0], Packets({
+                                0x09, 0x92, 60,   100,   // note on
+                                0x08, 0x82, 60,   0,     // note off
+                                0x0B, 0xB0, 0x40, 127,   // control change
+                                0x0E, 0xEF, 0x7F, 0x7F,  // pitch bend
+                                0x0C, 0xC1, 5,    0,     // program change
+                            }));
+}
+
+TEST_F(MidiQueue, SystemMessages) {
+    midi_send_songposition(&device, 0x1234);
+    midi_send_songselect(&device, 3);
+    midi_send_tcquarterframe(&device, 0x21);
+    midi_send_clock(&device);
+    midi_send_start(&device);
+    midi_queue_flush();
+
+    ASSERT_EQ(transfers.size(), 1);
+    EXPECT_EQ(transfers[0], Packets({
+                                0x03, 0xF2, 0x34, 0x24,
+                                0x02, 0xF3, 3, 0,
+                                0x02, 0xF1, 0x21, 0,
+                                0x0F, 0xF8, 0, 0,
+                                0x0F, 0xFA, 0, 0,
+                            }));
+}
+
+TEST_F(MidiQueue, SysexEndings) {
+    uint8_t ends_in_1[] = {0xF0, 0x7D, 0x01, 0xF7};
+    uint8_t ends_in_2[] = {0xF0, 0x7D, 0x01, 0x02, 0xF7};
+    uint8_t ends_in_3[] = {0xF0, 0x7D, 0xF7};
+    midi_send_array(&device, sizeof(ends_in_1), ends_in_1);
+    midi_send_array(&device, sizeof(ends_in_2), ends_in_2);
+    midi_send_array(&device, sizeof(ends_in_3), ends_in_3);
+    midi_queue_flush();
+
+    ASSERT_EQ(transfers.size(), 1);
+    EXPECT_EQ(transfers[0], Packets({
+                                0x04, 0xF0, 0x7D, 0x01,
+                                0x05, 0xF7, 0, 0,
+                                0x04, 0xF0, 0x7D, 0x01,
+                                0x06, 0x02, 0xF7, 0,
+                                0x07, 0xF0, 0x7D, 0xF7,
+                            }));
+}
+
+TEST_F(MidiQueue, ChordGoesOutInOneTransfer) {
+    midi_send_noteon(&device, 0, 60, 127);
+    midi_send_noteon(&device, 0, 64, 127);
+    midi_send_noteon(&device, 0, 67, 127);
+    EXPECT_TRUE(transfers.empty());
+
+    midi_queue_flush();
+    ASSERT_EQ(transfers.size(), 1);
+    EXPECT_EQ(transfers[0].size(), 3 * MIDI_EVENT_PACKET_SIZE);
+}
+
+TEST_F(MidiQueue, FullQueueFlushesEarly) {
+    for (uint8_t note = 0; note < MIDI_QUEUE_SIZE + 4; note++) {
+        midi_send_noteon(&device, 0, note, 127);
+    }
+    ASSERT_EQ(transfers.size(), 1);
+    EXPECT_EQ(transfers[0].size(), MIDI_QUEUE_SIZE * MIDI_EVENT_PACKET_SIZE);
+
+    midi_queue_flush();
+    ASSERT_EQ(transfers.size(), 2);
+    EXPECT_EQ(transfers[1].size(), 4 * MIDI_EVENT_PACKET_SIZE);
+    // Nothing lost or reordered
+    EXPECT_EQ(transfers[1][2], MIDI_QUEUE_SIZE);
+}
+
+TEST_F(MidiQueue, NothingQueuedSendsNothing) {
+    midi_queue_flush();
+    EXPECT_TRUE(transfers.empty());
+}
+
+TEST_F(MidiQueue, InvalidSysexCountIsDropped) {
+    EXPECT_FALSE(midi_queue_add(4, 0xF0, 0x7D, 0x01));
+    midi_queue_flush();
+    EXPECT_TRUE(transfers.empty());
+}
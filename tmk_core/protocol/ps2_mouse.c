@@ -148,9 +148,15 @@ static inline void ps2_mouse_convert_report_to_hid(report_mouse_t *mouse_report)
     //
     // Meanwhile USB HID mouse indicates 8bit data(-127 to 127), note that -128 is not used.
     //
+#ifdef MOUSE_EXTENDED_REPORT
+    // With 16-bit reports the whole PS/2 range fits, the 8-bit value only needs its sign back.
+    if (X_IS_NEG) mouse_report->x -= 256 * PS2_MOUSE_X_MULTIPLIER;
+    if (Y_IS_NEG) mouse_report->y -= 256 * PS2_MOUSE_Y_MULTIPLIER;
+#else
     // This converts PS/2 data into HID value. Use only -127-127 out of PS/2 9-bit.
     mouse_report->x = X_IS_NEG ? ((!X_IS_OVF && -127 <= mouse_report->x && mouse_report->x <= -1) ? mouse_report->x : -127) : ((!X_IS_OVF && 0 <= mouse_report->x && mouse_report->x <= 127) ? mouse_report->x : 127);
     mouse_report->y = Y_IS_NEG ? ((!Y_IS_OVF && -127 <= mouse_report->y && mouse_report->y <= -1) ? mouse_report->y : -127) : ((!Y_IS_OVF && 0 <= mouse_report->y && mouse_report->y <= 127) ? mouse_report->y : 127);
+#endif
 
     // remove sign and overflow flags
     mouse_report->buttons &= PS2_MOUSE_BTN_MASK;
@@ -164,8 +170,8 @@ static inline void ps2_mouse_convert_report_to_hid(report_mouse_t *mouse_report)
 #endif
 
 #ifdef PS2_MOUSE_ROTATE
-    int8_t x = mouse_report->x;
-    int8_t y = mouse_report->y;
+    mouse_xy_report_t x = mouse_report->x;
+    mouse_xy_report_t y = mouse_report->y;
 #    if PS2_MOUSE_ROTATE == 90
     mouse_report->x = y;
     mouse_report->y = -x;
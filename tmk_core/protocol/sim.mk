@@ -0,0 +1,9 @@
+SIM_DIR = protocol/sim
+
+SRC += $(SIM_DIR)/main.c \
+	$(SIM_DIR)/matrix.c
+
+# Search Path
+VPATH += $(TMK_PATH)/$(SIM_DIR)
+
+OPT_DEFS += -DPROTOCOL_SIM
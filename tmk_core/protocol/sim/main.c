@@ -0,0 +1,251 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "keyboard.h"
+#include "host.h"
+#include "host_driver.h"
+#include "keycode_config.h"
+#include "matrix.h"
+#include "sim.h"
+
+/* Runs a keymap on the host.
+ *
+ * Reads timestamped matrix events from a file or stdin, one per line. Blank
+ * lines and lines starting with # are skipped.
+ *
+ *     <ms> <row> <col> d     press a key
+ *     <ms> <row> <col> u     release it
+ *     <ms> scan              only run a scan, to let timeouts expire
+ *
+ * Writes every report the keymap sends, one per line, numbers in hex:
+ *
+ *     <ms> keyboard <mods> <keys...>
+ *     <ms> mouse <buttons> <x> <y> <v> <h>
+ *     <ms> system <usage>
+ *     <ms> consumer <usage>
+ *
+ * A scan runs at the time of every event before the event itself, so tapping
+ * and combo timeouts are decided in the right order, but their reports carry
+ * the time of the next event. Pass -s to also scan every few milliseconds in
+ * between, for exact report times at the cost of speed.
+ */
+
+// Scan this long after the last event, so held and tapped keys settle
+#define SIM_DRAIN_MS 1000
+
+static uint32_t now     = 0;
+static FILE*    output  = NULL;
+static bool     quiet   = false;
+static uint32_t reports = 0;
+static uint32_t hash    = 2166136261u;
+
+static void emit(const char* line, int length) {
+    // FNV-1a of the whole report stream, to compare runs without keeping them
+    for (int i = 0; i < length; i++) {
+        hash ^= (uint8_t)line[i];
+        hash *= 16777619u;
+    }
+    reports++;
+    if (!quiet) {
+        fwrite(line, 1, length, output);
+    }
+}
+
+uint8_t keyboard_protocol = 1;
+
+static uint8_t sim_keyboard_leds(void) { return 0; }
+
+static void sim_send_keyboard(report_keyboard_t* report) {
+    // long enough for every key code an NKRO report can hold
+    char line[24 + 3 * 256];
+    int  length;
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        length = snprintf(line, sizeof(line), "%u keyboard %02x", now, report->nkro.mods);
+        for (uint16_t code = 0; code < KEYBOARD_REPORT_BITS * 8; code++) {
+            if (report->nkro.bits[code / 8] & (1 << (code % 8))) {
+                length += snprintf(line + length, sizeof(line) - length, " %02x", code);
+            }
+        }
+    } else
+#endif
+    {
+        length = snprintf(line, sizeof(line), "%u keyboard %02x", now, report->mods);
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (report->keys[i]) {
+                length += snprintf(line + length, sizeof(line) - length, " %02x", report->keys[i]);
+            }
+        }
+    }
+    line[length++] = '\n';
+    emit(line, length);
+}
+
+static void sim_send_mouse(report_mouse_t* report) {
+    char line[64];
+    int  length = snprintf(line, sizeof(line), "%u mouse %02x %d %d %d %d\n", now, report->buttons, report->x, report->y, report->v, report->h);
+    emit(line, length);
+}
+
+static void sim_send_system(uint16_t data) {
+    char line[32];
+    int  length = snprintf(line, sizeof(line), "%u system %04x\n", now, data);
+    emit(line, length);
+}
+
+static void sim_send_consumer(uint16_t data) {
+    char line[32];
+    int  length = snprintf(line, sizeof(line), "%u consumer %04x\n", now, data);
+    emit(line, length);
+}
+
+static host_driver_t sim_driver = {sim_keyboard_leds, sim_send_keyboard, sim_send_mouse, sim_send_system, sim_send_consumer};
+
+static void scan_until(uint32_t time, uint32_t step) {
+    if (step) {
+        while (time - now > step) {
+            now += step;
+            set_time(now);
+            keyboard_task();
+        }
+    }
+    now = time;
+    set_time(now);
+    keyboard_task();
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-q] [-s ms] [-o output] [input]\n", name);
+    fprintf(stderr, "  -q       do not write reports, only the summary\n");
+    fprintf(stderr, "  -s ms    also scan every ms milliseconds between events\n");
+    fprintf(stderr, "  -o file  write reports to file instead of stdout\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    uint32_t step = 0;
+    int      option;
+
+    output = stdout;
+    while ((option = getopt(argc, argv, "qs:o:")) != -1) {
+        switch (option) {
+            case 'q':
+                quiet = true;
+                break;
+            case 's':
+                step = strtoul(optarg, NULL, 10);
+                break;
+            case 'o':
+                output = fopen(optarg, "w");
+                if (!output) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    FILE* input = stdin;
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        input = fopen(argv[optind], "r");
+        if (!input) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    host_set_driver(&sim_driver);
+    keyboard_setup();
+    keyboard_init();
+
+    char*    line     = NULL;
+    size_t   capacity = 0;
+    uint32_t lineno   = 0;
+    uint32_t events   = 0;
+    clock_t  start    = clock();
+
+    while (getline(&line, &capacity, input) != -1) {
+        lineno++;
+        char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0') {
+            continue;
+        }
+
+        char*         end;
+        uint32_t      time = strtoul(cursor, &end, 10);
+        if (end == cursor || time < now) {
+            fprintf(stderr, "line %u: bad or decreasing time\n", lineno);
+            return 1;
+        }
+        cursor = end;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+
+        if (strncmp(cursor, "scan", 4) == 0) {
+            scan_until(time, step);
+            continue;
+        }
+
+        unsigned long row = strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            fprintf(stderr, "line %u: expected a row\n", lineno);
+            return 1;
+        }
+        cursor            = end;
+        unsigned long col = strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            fprintf(stderr, "line %u: expected a column\n", lineno);
+            return 1;
+        }
+        cursor = end;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (row >= MATRIX_ROWS || col >= MATRIX_COLS || (*cursor != 'd' && *cursor != 'u')) {
+            fprintf(stderr, "line %u: expected <row> <col> d|u inside a %dx%d matrix\n", lineno, MATRIX_ROWS, MATRIX_COLS);
+            return 1;
+        }
+
+        // let anything that times out before this event happen first
+        scan_until(time, step);
+        sim_matrix_set(row, col, *cursor == 'd');
+        keyboard_task();
+        events++;
+    }
+    scan_until(now + SIM_DRAIN_MS, step);
+
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    fprintf(stderr, "%u events, %u reports, hash %08x, %.3f s", events, reports, hash, seconds);
+    if (seconds > 0) {
+        fprintf(stderr, ", %.0f events/s", events / seconds);
+    }
+    fprintf(stderr, "\n");
+
+    free(line);
+    fflush(output);
+    return 0;
+}
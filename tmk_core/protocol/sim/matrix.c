@@ -0,0 +1,52 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "matrix.h"
+#include "sim.h"
+
+static matrix_row_t matrix[MATRIX_ROWS];
+
+// The keyboard level sources are not built, so these go straight to the keymap
+__attribute__((weak)) void matrix_init_kb(void) { matrix_init_user(); }
+
+__attribute__((weak)) void matrix_scan_kb(void) { matrix_scan_user(); }
+
+__attribute__((weak)) void matrix_init_user(void) {}
+
+__attribute__((weak)) void matrix_scan_user(void) {}
+
+void matrix_init(void) {
+    memset(matrix, 0, sizeof(matrix));
+    matrix_init_quantum();
+}
+
+uint8_t matrix_scan(void) {
+    matrix_scan_quantum();
+    return 1;
+}
+
+matrix_row_t matrix_get_row(uint8_t row) { return matrix[row]; }
+
+void matrix_print(void) {}
+
+void sim_matrix_set(uint8_t row, uint8_t col, bool pressed) {
+    if (pressed) {
+        matrix[row] |= (matrix_row_t)1 << col;
+    } else {
+        matrix[row] &= ~((matrix_row_t)1 << col);
+    }
+}